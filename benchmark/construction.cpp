@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "melon/container/static_digraph.hpp"
+#include "melon/graph.hpp"
+#include "melon/utility/make_static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+
+#include "instances.hpp"
+
+using namespace melon;
+
+namespace {
+using vertex = vertex_t<static_digraph>;
+
+// The arcs of the instance as three lists, in arc order or shuffled.
+struct arc_lists {
+    std::vector<vertex> sources;
+    std::vector<vertex> targets;
+    std::vector<int> lengths;
+};
+
+arc_lists instance_arcs(const benchmark_instance & instance,
+                        const bool shuffled) {
+    std::vector<arc_t<static_digraph>> order(instance.graph.num_arcs());
+    std::ranges::copy(instance.graph.arcs(), order.begin());
+    if(shuffled) std::ranges::shuffle(order, std::mt19937(0));
+    arc_lists lists;
+    for(auto && a : order) {
+        lists.sources.push_back(instance.graph.arc_source(a));
+        lists.targets.push_back(instance.graph.arc_target(a));
+        lists.lengths.push_back(instance.length[a]);
+    }
+    return lists;
+}
+
+// The arcs added one by one in random order, then sorted by build().
+void static_digraph_builder_build(benchmark::State & state,
+                                  const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    const auto lists = instance_arcs(instance, true);
+    for(auto _ : state) {
+        static_digraph_builder<static_digraph, int> builder(
+            instance.graph.num_vertices());
+        for(std::size_t i = 0; i < lists.sources.size(); ++i)
+            builder.add_arc(lists.sources[i], lists.targets[i],
+                            lists.lengths[i]);
+        auto built = std::move(builder).build();
+        benchmark::DoNotOptimize(built);
+    }
+    count_arcs(state, instance);
+}
+
+// The constructor alone, from arcs already sorted by source: two counting
+// passes, the in-arcs included.
+void static_digraph_from_sorted_arcs(benchmark::State & state,
+                                     const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    const auto lists = instance_arcs(instance, false);
+    for(auto _ : state) {
+        static_digraph graph(instance.graph.num_vertices(), lists.sources,
+                             lists.targets);
+        benchmark::DoNotOptimize(graph);
+    }
+    count_arcs(state, instance);
+}
+
+// The instance renumbered in reverse, with its length map translated.
+void make_static_digraph_reversed(benchmark::State & state,
+                                  const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state) {
+        auto rebuilt =
+            make_static_digraph(instance.graph, std::greater<vertex>{},
+                                std::tuple<>{}, std::tie(instance.length));
+        benchmark::DoNotOptimize(rebuilt);
+    }
+    count_arcs(state, instance);
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(static_digraph_builder_build, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(static_digraph_builder_build, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(static_digraph_from_sorted_arcs, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(static_digraph_from_sorted_arcs, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(make_static_digraph_reversed, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(make_static_digraph_reversed, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include "melon/algorithm/dinitz.hpp"
+#include "melon/algorithm/edmonds_karp.hpp"
+#include "melon/container/static_digraph.hpp"
+
+#include "instances.hpp"
+
+using namespace melon;
+
+namespace {
+// Smaller than graph_sizes: Edmonds-Karp's one BFS per augmenting path takes
+// seconds a run past these.
+void flow_sizes(benchmark::internal::Benchmark * b) {
+    b->ArgName("log_n")->Arg(10)->Arg(12)->Arg(14)->Unit(
+        benchmark::kMillisecond);
+}
+
+// A maximum flow per iteration, the lengths as capacities, between the first
+// query pair.
+template <typename Algorithm>
+void run_maximum_flow(benchmark::State & state,
+                      const benchmark_instance & instance, Algorithm & alg) {
+    for(auto _ : state) {
+        auto flow_value = alg.reset().run().flow_value();
+        benchmark::DoNotOptimize(flow_value);
+    }
+    count_arcs(state, instance);
+}
+
+void dinitz_flow(benchmark::State & state, const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    dinitz alg(instance.graph, instance.length, instance.sources[0],
+               instance.targets[0]);
+    run_maximum_flow(state, instance, alg);
+}
+
+void edmonds_karp_flow(benchmark::State & state,
+                       const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    edmonds_karp alg(instance.graph, instance.length, instance.sources[0],
+                     instance.targets[0]);
+    run_maximum_flow(state, instance, alg);
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(dinitz_flow, grid, instance_family::grid)->Apply(flow_sizes);
+BENCHMARK_CAPTURE(dinitz_flow, rmat, instance_family::rmat)->Apply(flow_sizes);
+BENCHMARK_CAPTURE(edmonds_karp_flow, grid, instance_family::grid)
+    ->Apply(flow_sizes);
+BENCHMARK_CAPTURE(edmonds_karp_flow, rmat, instance_family::rmat)
+    ->Apply(flow_sizes);
@@ -0,0 +1,89 @@
+#ifndef BENCHMARK_INSTANCES_HPP
+#define BENCHMARK_INSTANCES_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "melon/container/static_digraph.hpp"
+#include "melon/container/static_map.hpp"
+#include "melon/graph.hpp"
+#include "melon/utility/generators.hpp"
+
+// The two shapes every benchmark runs on: a road-like square grid, low degree
+// and a large diameter, and a Graph500 R-MAT digraph, power law and a small
+// diameter. Both with int weights in [1, 1000], 2^log_num_vertices vertices,
+// and about 4 resp. 16 arcs per vertex.
+enum class instance_family { grid, rmat };
+
+struct benchmark_instance {
+    melon::static_digraph graph;
+    melon::static_map<melon::arc_t<melon::static_digraph>, int> length;
+    // query vertices with at least one out-arc, drawn once: the iterations of
+    // a benchmark cycle through them
+    std::vector<melon::vertex_t<melon::static_digraph>> sources;
+    std::vector<melon::vertex_t<melon::static_digraph>> targets;
+};
+
+// Generated on first use from a fixed seed, so two runs, or two builds
+// compared against each other, time the same graphs; then kept for the whole
+// process, as the larger ones take seconds to generate.
+inline const benchmark_instance & get_instance(
+    const instance_family family, const std::size_t log_num_vertices) {
+    static std::map<std::pair<instance_family, std::size_t>,
+                    benchmark_instance>
+        cache;
+    auto it = cache.find({family, log_num_vertices});
+    if(it != cache.end()) return it->second;
+
+    std::mt19937 gen(20261019u + static_cast<unsigned>(log_num_vertices));
+    const std::uniform_int_distribution<int> weight{1, 1000};
+    benchmark_instance result;
+    if(family == instance_family::grid) {
+        const std::size_t side_bits = log_num_vertices / 2;
+        auto [graph, length] = melon::random_grid_digraph(
+            {std::size_t{1} << side_bits,
+             std::size_t{1} << (log_num_vertices - side_bits)},
+            gen, weight);
+        result.graph = std::move(graph);
+        result.length = std::move(length);
+    } else {
+        auto [graph, length] = melon::rmat_digraph(
+            {.scale = log_num_vertices, .edge_factor = 16}, gen, weight);
+        result.graph = std::move(graph);
+        result.length = std::move(length);
+    }
+    std::uniform_int_distribution<std::size_t> vertex(
+        0, result.graph.num_vertices() - 1);
+    while(result.sources.size() < 64) {
+        const auto u = static_cast<melon::vertex_t<melon::static_digraph>>(
+            vertex(gen));
+        if(result.graph.out_arcs(u).empty()) continue;
+        result.sources.push_back(u);
+    }
+    result.targets = result.sources;
+    std::ranges::shuffle(result.targets, gen);
+    return cache.emplace(std::pair{family, log_num_vertices}, std::move(result))
+        .first->second;
+}
+
+// The sizes of the traversals and shortest paths: 4K, 65K and 1M vertices.
+inline void graph_sizes(benchmark::internal::Benchmark * b) {
+    b->ArgName("log_n")->Arg(12)->Arg(16)->Arg(20)->Unit(
+        benchmark::kMillisecond);
+}
+
+// The arcs processed per second, comparable across sizes.
+inline void count_arcs(benchmark::State & state,
+                       const benchmark_instance & instance) {
+    state.SetItemsProcessed(
+        state.iterations() *
+        static_cast<benchmark::IterationCount>(instance.graph.num_arcs()));
+}
+
+#endif  // BENCHMARK_INSTANCES_HPP
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <utility>
+
+#include "melon/algorithm/bidirectional_dijkstra.hpp"
+#include "melon/algorithm/dijkstra.hpp"
+#include "melon/container/d_ary_heap.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/mapping.hpp"
+
+#include "instances.hpp"
+
+using namespace melon;
+
+namespace {
+// The default traits with a D-ary heap: D = 2 is the default itself.
+template <std::size_t D>
+struct d_ary_dijkstra_traits : dijkstra_default_traits<static_digraph, int> {
+    using heap =
+        updatable_d_ary_heap<D, std::pair<vertex_t<static_digraph>, int>,
+                             typename semiring::less_t,
+                             vertex_map_t<static_digraph, std::size_t>,
+                             maps::element_map<1>, maps::element_map<0>>;
+};
+
+// A full single-source run per iteration, from a different source each time.
+template <std::size_t D>
+void run_dijkstra(benchmark::State & state, const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    dijkstra alg(d_ary_dijkstra_traits<D>{}, instance.graph, instance.length);
+    std::size_t query = 0;
+    for(auto _ : state) {
+        alg.reset()
+            .add_source(instance.sources[query++ % instance.sources.size()])
+            .run();
+        benchmark::ClobberMemory();
+    }
+    count_arcs(state, instance);
+}
+
+void dijkstra_binary_heap(benchmark::State & state,
+                          const instance_family family) {
+    run_dijkstra<2>(state, family);
+}
+void dijkstra_4_ary_heap(benchmark::State & state,
+                         const instance_family family) {
+    run_dijkstra<4>(state, family);
+}
+
+// One s-t query per iteration; the R-MAT pairs may be unreachable, which the
+// search then proves by exhausting one side.
+void bidirectional_dijkstra_query(benchmark::State & state,
+                                  const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    bidirectional_dijkstra alg(instance.graph, instance.length);
+    std::size_t query = 0;
+    for(auto _ : state) {
+        const std::size_t i = query++ % instance.sources.size();
+        alg.reset()
+            .add_source(instance.sources[i])
+            .add_target(instance.targets[i])
+            .run();
+        bool found = alg.path_found();
+        benchmark::DoNotOptimize(found);
+    }
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(dijkstra_binary_heap, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(dijkstra_binary_heap, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(dijkstra_4_ary_heap, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(dijkstra_4_ary_heap, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(bidirectional_dijkstra_query, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(bidirectional_dijkstra_query, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
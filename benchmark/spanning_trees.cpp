@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include "melon/algorithm/kruskal.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/views/undirect.hpp"
+
+#include "instances.hpp"
+
+using namespace melon;
+
+namespace {
+// A minimum spanning forest per iteration, the arcs taken as edges: reset()
+// sorts the edges again, so that is timed too.
+void kruskal_forest(benchmark::State & state, const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    const auto ugraph = views::undirect(instance.graph);
+    kruskal alg(ugraph, instance.length);
+    for(auto _ : state) {
+        std::size_t num_edges = 0;
+        for(auto && e : alg.reset()) {
+            benchmark::DoNotOptimize(e);
+            ++num_edges;
+        }
+        benchmark::DoNotOptimize(num_edges);
+    }
+    count_arcs(state, instance);
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(kruskal_forest, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(kruskal_forest, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
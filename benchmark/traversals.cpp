@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+#include "melon/algorithm/breadth_first_search.hpp"
+#include "melon/algorithm/depth_first_search.hpp"
+#include "melon/algorithm/strongly_connected_components.hpp"
+#include "melon/container/static_digraph.hpp"
+
+#include "instances.hpp"
+
+using namespace melon;
+
+namespace {
+// Storing the distances selects the generic implementation; the default
+// traits store nothing and get the branchless one.
+struct generic_bfs_traits : breadth_first_search_default_traits {
+    static constexpr bool store_distances = true;
+};
+
+// A full traversal per iteration, from a different source each time.
+template <typename Algorithm>
+void run_traversal(benchmark::State & state,
+                   const benchmark_instance & instance, Algorithm & alg) {
+    std::size_t query = 0;
+    for(auto _ : state) {
+        alg.reset()
+            .add_source(instance.sources[query++ % instance.sources.size()])
+            .run();
+        benchmark::ClobberMemory();
+    }
+    count_arcs(state, instance);
+}
+
+void bfs_branchless(benchmark::State & state, const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    breadth_first_search alg(instance.graph);
+    run_traversal(state, instance, alg);
+}
+
+void bfs_generic(benchmark::State & state, const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    breadth_first_search alg(generic_bfs_traits{}, instance.graph);
+    run_traversal(state, instance, alg);
+}
+
+void dfs(benchmark::State & state, const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    depth_first_search alg(instance.graph);
+    run_traversal(state, instance, alg);
+}
+
+void scc(benchmark::State & state, const instance_family family) {
+    const auto & instance =
+        get_instance(family, static_cast<std::size_t>(state.range(0)));
+    strongly_connected_components alg(instance.graph);
+    for(auto _ : state) {
+        std::size_t num_components = 0;
+        for(auto && component : alg.reset()) {
+            benchmark::DoNotOptimize(component);
+            ++num_components;
+        }
+        benchmark::DoNotOptimize(num_components);
+    }
+    count_arcs(state, instance);
+}
+}  // namespace
+
+BENCHMARK_CAPTURE(bfs_branchless, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(bfs_branchless, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(bfs_generic, grid, instance_family::grid)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(bfs_generic, rmat, instance_family::rmat)
+    ->Apply(graph_sizes);
+BENCHMARK_CAPTURE(dfs, grid, instance_family::grid)->Apply(graph_sizes);
+BENCHMARK_CAPTURE(dfs, rmat, instance_family::rmat)->Apply(graph_sizes);
+BENCHMARK_CAPTURE(scc, grid, instance_family::grid)->Apply(graph_sizes);
+BENCHMARK_CAPTURE(scc, rmat, instance_family::rmat)->Apply(graph_sizes);
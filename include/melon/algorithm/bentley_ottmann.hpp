@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <compare>
 #include <concepts>
 #include <functional>
 #include <map>
@@ -15,12 +16,33 @@
 #include "melon/detail/not_self.hpp"
 
 #include "melon/container/d_ary_heap.hpp"
+#include "melon/detail/node_pool_allocator.hpp"
 #include "melon/mapping.hpp"
 #include "melon/utility/algorithmic_generator.hpp"
 #include "melon/utility/geometry.hpp"
 
 namespace melon {
 
+namespace detail {
+// The double approximation of a line a filtered coordinate system compares
+// on, or nothing for an exact one.
+struct no_approximation {};
+template <typename CoordinateSystem, typename Line>
+struct approximate_line {
+    using type = no_approximation;
+};
+template <typename CoordinateSystem, typename Line>
+    requires requires(const Line & l, const double x) {
+        CoordinateSystem::approximate_compare_y_at(
+            CoordinateSystem::to_approximate_line(l),
+            CoordinateSystem::to_approximate_line(l), x);
+    }
+struct approximate_line<CoordinateSystem, Line> {
+    using type = decltype(CoordinateSystem::to_approximate_line(
+        std::declval<const Line &>()));
+};
+}  // namespace detail
+
 template <typename Traits>
 concept bentley_ottmann_traits = requires {
     { Traits::report_endpoints } -> std::convertible_to<bool>;
@@ -47,6 +69,27 @@ struct bentley_ottmann_default_traits {
     static constexpr bool report_endpoints = true;
 };
 
+// The same trees, their nodes drawn from a pool the algorithm owns instead of
+// one global-heap allocation each: the sweep inserts and erases a status node
+// per segment and event, and an event node per endpoint and crossing. Any
+// tree whose allocator is constructible from a detail::node_pool & gets it.
+template <typename Segment>
+struct bentley_ottmann_pooled_traits
+    : bentley_ottmann_default_traits<Segment> {
+    using intersection_type =
+        typename bentley_ottmann_default_traits<Segment>::intersection_type;
+    using coordinate_system =
+        typename bentley_ottmann_default_traits<Segment>::coordinate_system;
+
+    template <typename T, typename CMP>
+    using segments_tree = std::set<T, CMP, detail::node_pool_allocator<T>>;
+
+    template <typename T>
+    using events_tree = std::map<
+        intersection_type, T, typename coordinate_system::point_xy_comparator,
+        detail::node_pool_allocator<std::pair<const intersection_type, T>>>;
+};
+
 // Precondition no concept can check: the coordinate arithmetic must be exact.
 // The sweep orders segments by where they cross the sweep line and reuses that
 // order across events, so a rounded comparison makes segment_cmp inconsistent
@@ -80,6 +123,8 @@ private:
         std::common_type_t<decltype(std::get<0>(std::declval<segment_type>())),
                            decltype(std::get<1>(std::declval<segment_type>()))>;
     using line_type = typename Traits::line_type;
+    using slope_type = decltype(coordinate_system::line_slope(
+        std::declval<line_type>()));
     using intersection_type = typename Traits::intersection_type;
     static constexpr auto compute_sweepline_intersection(
         const intersection_type & event_point, const line_type & line) {
@@ -96,6 +141,30 @@ private:
 
     using event_cmp = coordinate_system::point_xy_comparator;
 
+    // A filtered coordinate system, filtered_cartesian say, orders two
+    // segments on the sweep line in double first; the exact comparison below
+    // only runs on the signs it cannot vouch for.
+    using approximate_line_type =
+        typename detail::approximate_line<coordinate_system, line_type>::type;
+    static constexpr bool filtered =
+        !std::is_same_v<approximate_line_type, detail::no_approximation>;
+    using approximate_abscissa_type =
+        std::conditional_t<filtered, double, detail::no_approximation>;
+
+    // A point the sweep line passes through, with its abscissa as the filter
+    // compares on it.
+    struct sweep_point {
+        intersection_type point;
+        [[no_unique_address]] approximate_abscissa_type x{};
+
+        sweep_point & operator=(const intersection_type & p) {
+            point = p;
+            if constexpr(filtered)
+                x = coordinate_system::approximate(std::get<0>(p));
+            return *this;
+        }
+    };
+
     struct segment_entry {
         // None of these is `const`: const members make the two defaulted
         // assignments below *deleted*, and `= default` on an operation the
@@ -106,6 +175,10 @@ private:
         // both to segment_cmp and as tree keys.
         mutable sweepline_intersection_type sweepline_intersection;
         line_type line;
+        // segment_cmp breaks every tie on the sweep line by slope, a division
+        // it would otherwise redo at each comparison
+        slope_type slope;
+        [[no_unique_address]] approximate_line_type approximate_line;
         segment_type segment;
         segment_id_type segment_id;
 
@@ -113,6 +186,8 @@ private:
                       const intersection_type & p)
             : sweepline_intersection(p)
             , line(coordinate_system::segment_to_line(s))
+            , slope(coordinate_system::line_slope(line))
+            , approximate_line(make_approximate_line(line))
             , segment(s)
             , segment_id(si) {}
 
@@ -122,6 +197,14 @@ private:
         segment_entry & operator=(const segment_entry &) = default;
         segment_entry & operator=(segment_entry &&) = default;
 
+        [[nodiscard]] static constexpr approximate_line_type
+        make_approximate_line(const line_type & l) {
+            if constexpr(filtered)
+                return coordinate_system::to_approximate_line(l);
+            else
+                return {};
+        }
+
         [[nodiscard]] constexpr const sweepline_intersection_y_type
         sweepline_y_intersection(const intersection_type & event_point) const {
             if(std::get<1>(line) == 0) return std::get<1>(event_point);
@@ -135,17 +218,25 @@ private:
     };
     struct segment_cmp {
         using is_transparent = void;
-        std::reference_wrapper<const intersection_type> event_point;
+        std::reference_wrapper<const sweep_point> sweep;
 
         [[nodiscard]] constexpr bool operator()(
             const segment_entry & e1, const segment_entry & e2) const {
+            if constexpr(filtered) {
+                const std::partial_ordering order =
+                    coordinate_system::approximate_compare_y_at(
+                        e1.approximate_line, e2.approximate_line,
+                        sweep.get().x);
+                if(order != std::partial_ordering::unordered)
+                    return order < 0;
+            }
+            const intersection_type & event_point = sweep.get().point;
             const auto & y1 = e1.sweepline_y_intersection(event_point);
             const auto & y2 = e2.sweepline_y_intersection(event_point);
             if(y1 == y2) {
-                const auto m1 = coordinate_system::line_slope(e1.line);
-                const auto m2 = coordinate_system::line_slope(e2.line);
-                if(m1 == m2) return e1.segment_id < e2.segment_id;
-                return (y1 > std::get<1>(event_point.get())) != (m1 < m2);
+                if(e1.slope == e2.slope) return e1.segment_id < e2.segment_id;
+                return (y1 > std::get<1>(event_point)) !=
+                       (e1.slope < e2.slope);
             }
             return y1 < y2;
         }
@@ -173,15 +264,27 @@ private:
     // the defaulted moves below sound. Declared before the trees: their
     // mem-initializers dereference it.
     struct event_points {
-        intersection_type current;
-        intersection_type tmp;
+        sweep_point current;
+        sweep_point tmp;
     };
 
+    template <typename Tree>
+    static constexpr bool pooled_tree = requires {
+        requires std::constructible_from<typename Tree::allocator_type,
+                                         detail::node_pool &>;
+    };
+    static constexpr bool pooled_trees =
+        pooled_tree<segments_tree> && pooled_tree<events_tree>;
+    struct no_node_pool {};
+
 private:
     SegmentIdRange _segment_ids_range;
     [[no_unique_address]] SegmentMap _segment_map;
     [[no_unique_address]] event_cmp _event_cmp;
     std::unique_ptr<event_points> _event_points;
+    // Declared before the trees, which free their nodes into it.
+    [[no_unique_address]] std::conditional_t<pooled_trees, detail::node_pool_box,
+                                             no_node_pool> _node_pool;
     segments_tree _segments_tree;
     segments_tree _tmp_tree;
     events_tree _events_tree;
@@ -199,8 +302,11 @@ public:
               std::views::all(std::forward<SIR>(segments_ids_range)))
         , _segment_map(maps::mapping_all(std::forward<SM>(segment_map)))
         , _event_points(std::make_unique<event_points>())
-        , _segments_tree(segment_cmp(std::cref(_event_points->current)))
-        , _tmp_tree(segment_cmp(std::cref(_event_points->tmp))) {
+        , _segments_tree(make_tree<segments_tree>(
+              segment_cmp(std::cref(_event_points->current))))
+        , _tmp_tree(make_tree<segments_tree>(
+              segment_cmp(std::cref(_event_points->tmp))))
+        , _events_tree(make_tree<events_tree>(_event_cmp)) {
         seed();
     }
 
@@ -226,6 +332,17 @@ public:
     }
 
 private:
+    // On pool allocators, the trees share _node_pool. Nodes move between the
+    // two status trees, which node handles only allow between equal
+    // allocators.
+    template <typename Tree, typename Cmp>
+    [[nodiscard]] Tree make_tree(const Cmp & cmp) {
+        if constexpr(pooled_trees)
+            return Tree(cmp, typename Tree::allocator_type(*_node_pool));
+        else
+            return Tree(cmp);
+    }
+
     void seed() {
         for(auto && s : _segment_ids_range) {
             // Read through the wrapped member, not the constructor parameter:
@@ -253,27 +370,22 @@ private:
     void push_intersection(const intersection_type & i) {
         _events_tree.try_emplace(i);
     }
+    // A coordinate system of your own need not provide orientation.
+    [[nodiscard]] static constexpr std::weak_ordering orientation(
+        const cartesian_point auto & p, const cartesian_point auto & q,
+        const cartesian_point auto & r) {
+        if constexpr(requires { coordinate_system::orientation(p, q, r); })
+            return coordinate_system::orientation(p, q, r);
+        else
+            return cartesian::orientation(p, q, r);
+    }
     void detect_intersection(const segment_entry & e1,
                              const segment_entry & e2) {
         const auto & [a, b] = e1.segment;
         const auto & [c, d] = e2.segment;
 
-        const auto dx_ab = std::get<0>(b) - std::get<0>(a);
-        const auto dy_ab = std::get<1>(b) - std::get<1>(a);
-        const auto dx_ac = std::get<0>(c) - std::get<0>(a);
-        const auto dy_ac = std::get<1>(c) - std::get<1>(a);
-        const auto dx_ad = std::get<0>(d) - std::get<0>(a);
-        const auto dy_ad = std::get<1>(d) - std::get<1>(a);
-
-        const auto dx_bc = std::get<0>(c) - std::get<0>(b);
-        const auto dy_bc = std::get<1>(c) - std::get<1>(b);
-        const auto dx_dc = std::get<0>(c) - std::get<0>(d);
-        const auto dy_dc = std::get<1>(c) - std::get<1>(d);
-
-        if((dx_ab * dy_ac - dx_ac * dy_ab < 0) !=
-               (dx_ab * dy_ad - dx_ad * dy_ab > 0) ||
-           (dx_dc * dy_ac - dx_ac * dy_dc < 0) !=
-               (dx_dc * dy_bc - dx_bc * dy_dc > 0))
+        if((orientation(a, b, c) < 0) != (orientation(a, b, d) > 0) ||
+           (orientation(c, d, a) < 0) != (orientation(c, d, b) > 0))
             return;
 
         const auto & i_opt =
@@ -282,7 +394,7 @@ private:
             return;
         const auto & i = i_opt.value();
 
-        if(_event_cmp(i, _event_points->current)) return;
+        if(_event_cmp(i, _event_points->current.point)) return;
 
         push_intersection(i);
     }
@@ -328,8 +440,8 @@ private:
                 _intersections.emplace_back(s);
             }
             if(et != event_type::starting) continue;
-            _tmp_tree.emplace(
-                segment_entry(s, _segment_map[s], _event_points->current));
+            _tmp_tree.emplace(segment_entry(s, _segment_map[s],
+                                            _event_points->current.point));
         }
 
         if(_tmp_tree.empty()) {
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "melon/algorithm/dijkstra.hpp"
+#include "melon/container/d_ary_heap.hpp"
+#include "melon/detail/prefetch.hpp"
+#include "melon/graph.hpp"
+#include "melon/mapping.hpp"
+#include "melon/utility/semiring.hpp"
+#include "melon/views/reverse.hpp"
+
+namespace melon {
+
+// clang-format off
+template <typename Traits>
+concept bidirectional_biobjective_dijkstra_traits =
+    semiring<typename Traits::blue_semiring> &&
+    semiring<typename Traits::red_semiring> &&
+    requires(typename Traits::label & e) {
+        { e.first };
+        { e.second };
+    };
+// clang-format on
+
+template <typename Graph, typename BlueValueType, typename RedValueType>
+struct bidirectional_biobjective_dijkstra_default_traits {
+    using blue_semiring = shortest_path_semiring<BlueValueType>;
+    using red_semiring = shortest_path_semiring<RedValueType>;
+    using label = std::pair<BlueValueType, RedValueType>;
+};
+
+// The Pareto front of the (blue, red) costs of the paths from one source to
+// one target, by Ahmadi, Tack, Harabor and Kilby's BOBA*: two bi-objective A*
+// searches, one forward from the source ordered by blue cost first and one
+// backward from the target ordered by red cost first, taking turns.
+//  - The heuristics are the exact single-objective distances -- to the target
+//    for the forward search, from the source for the backward one -- computed
+//    up front by four melon::dijkstra over the same semirings. A vertex that
+//    cannot reach the target, or be reached from the source, is never entered.
+//  - Labels are pruned by dimensionality reduction: a search settles the
+//    labels of a vertex in increasing order of its first cost, so a label is
+//    dominated exactly when its second cost is no smaller than that of the
+//    last label settled there; one value per vertex and direction, instead of
+//    a front.
+//  - Each search finds the front from its own end, in order: the forward one
+//    the solutions of smallest blue cost, the backward one those of smallest
+//    red cost. A label whose estimated costs are dominated by the last
+//    solution either search found cannot lead to a new one, so the two meet
+//    in the middle of the front and each explores about half of it.
+//
+// Both plus operations must preserve dominance under extension, as for
+// biobjective_dijkstra, and arc lengths must never improve a cost, as for
+// melon::dijkstra; the heuristics are then consistent, which the pruning
+// relies on. Cost is output-sensitive, the front being exponentially large in
+// the worst case, but only the labels that can still reach the target's front
+// are ever created.
+template <graph_view Graph, mapping_view<arc_t<Graph>> BlueLengthMap,
+          mapping_view<arc_t<Graph>> RedLengthMap,
+          bidirectional_biobjective_dijkstra_traits Traits =
+              bidirectional_biobjective_dijkstra_default_traits<
+                  Graph, mapped_value_t<BlueLengthMap, arc_t<Graph>>,
+                  mapped_value_t<RedLengthMap, arc_t<Graph>>>>
+    requires outward_incidence_graph<Graph> && inward_incidence_graph<Graph> &&
+             has_vertex_map<Graph>
+class bidirectional_biobjective_dijkstra {
+private:
+    using vertex = vertex_t<Graph>;
+    using arc = arc_t<Graph>;
+    using blue_semiring = Traits::blue_semiring;
+    using red_semiring = Traits::red_semiring;
+    using blue_value = blue_semiring::value_type;
+    using red_value = red_semiring::value_type;
+    using label = Traits::label;
+
+    // lexicographic, on the estimated costs
+    struct blue_first_less {
+        [[nodiscard]] constexpr bool operator()(const label & l1,
+                                                const label & l2) const {
+            if(blue_semiring::less(l1.first, l2.first)) return true;
+            if(blue_semiring::less(l2.first, l1.first)) return false;
+            return red_semiring::less(l1.second, l2.second);
+        }
+    };
+    struct red_first_less {
+        [[nodiscard]] constexpr bool operator()(const label & l1,
+                                                const label & l2) const {
+            if(red_semiring::less(l1.second, l2.second)) return true;
+            if(red_semiring::less(l2.second, l1.second)) return false;
+            return blue_semiring::less(l1.first, l2.first);
+        }
+    };
+    // the estimated costs, the vertex, the costs so far
+    using entry = std::tuple<label, vertex, label>;
+    using forward_heap =
+        d_ary_heap<2, entry, blue_first_less, maps::element_map<0>>;
+    using backward_heap =
+        d_ary_heap<2, entry, red_first_less, maps::element_map<0>>;
+
+    template <typename G, typename Semiring>
+    struct lower_bound_traits {
+        using semiring = Semiring;
+        using heap = updatable_d_ary_heap<
+            2, std::pair<vertex_t<G>, typename Semiring::value_type>,
+            typename Semiring::less_t, vertex_map_t<G, std::size_t>,
+            maps::element_map<1>, maps::element_map<0>>;
+        static constexpr bool store_distances = false;
+        static constexpr bool store_paths = false;
+    };
+
+private:
+    Graph _graph;
+    BlueLengthMap _blue_length_map;
+    RedLengthMap _red_length_map;
+    vertex _source;
+    vertex _target;
+    bool _converged;
+
+    // the heuristics, infty where there is no path
+    vertex_map_t<Graph, blue_value> _blue_to_target;
+    vertex_map_t<Graph, red_value> _red_to_target;
+    vertex_map_t<Graph, blue_value> _blue_from_source;
+    vertex_map_t<Graph, red_value> _red_from_source;
+    // the second cost of the last label settled at each vertex, by direction;
+    // at the target and at the source, that of the last solution found
+    vertex_map_t<Graph, red_value> _forward_red_min;
+    vertex_map_t<Graph, blue_value> _backward_blue_min;
+
+    forward_heap _forward_heap;
+    backward_heap _backward_heap;
+    std::vector<label> _pareto_front;
+    std::vector<label> _backward_solutions;
+
+public:
+    template <graph_for<Graph> G, mapping_for<BlueLengthMap> BLM,
+              mapping_for<RedLengthMap> RLM>
+    bidirectional_biobjective_dijkstra(G && g, BLM && blm, RLM && rlm,
+                                       const vertex & s, const vertex & t)
+        : _graph(views::graph_all(std::forward<G>(g)))
+        , _blue_length_map(maps::mapping_all(std::forward<BLM>(blm)))
+        , _red_length_map(maps::mapping_all(std::forward<RLM>(rlm)))
+        , _source(s)
+        , _target(t)
+        , _converged(false)
+        , _blue_to_target(create_vertex_map<blue_value>(_graph))
+        , _red_to_target(create_vertex_map<red_value>(_graph))
+        , _blue_from_source(create_vertex_map<blue_value>(_graph))
+        , _red_from_source(create_vertex_map<red_value>(_graph))
+        , _forward_red_min(create_vertex_map<red_value>(_graph))
+        , _backward_blue_min(create_vertex_map<blue_value>(_graph))
+        , _forward_heap()
+        , _backward_heap() {}
+
+    template <typename... Args>
+        requires std::constructible_from<bidirectional_biobjective_dijkstra,
+                                         Args...>
+    bidirectional_biobjective_dijkstra(Traits, Args &&... args)
+        : bidirectional_biobjective_dijkstra(std::forward<Args>(args)...) {}
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    bidirectional_biobjective_dijkstra(
+        const bidirectional_biobjective_dijkstra &) = delete;
+    bidirectional_biobjective_dijkstra(bidirectional_biobjective_dijkstra &&) =
+        default;
+
+    bidirectional_biobjective_dijkstra & operator=(
+        const bidirectional_biobjective_dijkstra &) = delete;
+    bidirectional_biobjective_dijkstra & operator=(
+        bidirectional_biobjective_dijkstra &&) = default;
+
+    [[nodiscard]] constexpr Graph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const Graph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr Graph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const Graph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    // The next run() answers for the pair (s, t).
+    bidirectional_biobjective_dijkstra & reset(const vertex & s,
+                                               const vertex & t) noexcept {
+        _source = s;
+        _target = t;
+        _converged = false;
+        return *this;
+    }
+
+private:
+    template <typename Semiring, typename G, typename LengthMap,
+              typename DistMap>
+    static void fill_distances(G && g, LengthMap && length_map,
+                               const vertex & s, DistMap & dist_map) {
+        dist_map.fill(Semiring::infty);
+        dijkstra alg(lower_bound_traits<views::graph_all_t<G>, Semiring>{},
+                     std::forward<G>(g), std::forward<LengthMap>(length_map),
+                     s);
+        for(auto && [v, d] : alg) dist_map[v] = d;
+    }
+
+    [[nodiscard]] bool reaches_target(const vertex & v) const {
+        return blue_semiring::less(_blue_to_target[v], blue_semiring::infty);
+    }
+    [[nodiscard]] bool reached_from_source(const vertex & v) const {
+        return blue_semiring::less(_blue_from_source[v], blue_semiring::infty);
+    }
+
+    // Whether a label of estimated costs f is dominated by a solution found,
+    // in either direction.
+    [[nodiscard]] bool beyond_solutions(const label & f) const {
+        return !red_semiring::less(f.second, _forward_red_min[_target]) ||
+               !blue_semiring::less(f.first, _backward_blue_min[_source]);
+    }
+
+    [[nodiscard]] label extend(const label & g, const arc & a) const {
+        return label(blue_semiring::plus(g.first, _blue_length_map[a]),
+                     red_semiring::plus(g.second, _red_length_map[a]));
+    }
+    [[nodiscard]] label forward_estimate(const vertex & v,
+                                         const label & g) const {
+        return label(blue_semiring::plus(g.first, _blue_to_target[v]),
+                     red_semiring::plus(g.second, _red_to_target[v]));
+    }
+    [[nodiscard]] label backward_estimate(const vertex & v,
+                                          const label & g) const {
+        return label(blue_semiring::plus(g.first, _blue_from_source[v]),
+                     red_semiring::plus(g.second, _red_from_source[v]));
+    }
+
+    void forward_step() {
+        // Copies: the pop() below reorders the heap array.
+        const auto [f, u, g] = _forward_heap.top();
+        _forward_heap.pop();
+        if(!red_semiring::less(g.second, _forward_red_min[u]) ||
+           beyond_solutions(f))
+            return;
+        _forward_red_min[u] = g.second;
+        if(u == _target) {
+            _pareto_front.push_back(g);
+            return;
+        }
+        auto && out_arcs_range = out_arcs(_graph, u);
+        prefetch_keys_and_values(out_arcs_range, arc_targets_map(_graph),
+                                 _blue_length_map, _red_length_map);
+        for(const arc & a : out_arcs_range) {
+            const vertex & w = arc_target(_graph, a);
+            if(!reaches_target(w)) continue;
+            const label g_w = extend(g, a);
+            if(!red_semiring::less(g_w.second, _forward_red_min[w])) continue;
+            const label f_w = forward_estimate(w, g_w);
+            if(beyond_solutions(f_w)) continue;
+            _forward_heap.push(entry(f_w, w, g_w));
+        }
+    }
+
+    void backward_step() {
+        const auto [f, u, g] = _backward_heap.top();
+        _backward_heap.pop();
+        if(!blue_semiring::less(g.first, _backward_blue_min[u]) ||
+           beyond_solutions(f))
+            return;
+        _backward_blue_min[u] = g.first;
+        if(u == _source) {
+            _backward_solutions.push_back(g);
+            return;
+        }
+        auto && in_arcs_range = in_arcs(_graph, u);
+        prefetch_keys_and_values(in_arcs_range, arc_sources_map(_graph),
+                                 _blue_length_map, _red_length_map);
+        for(const arc & a : in_arcs_range) {
+            const vertex & w = arc_source(_graph, a);
+            if(!reached_from_source(w)) continue;
+            const label g_w = extend(g, a);
+            if(!blue_semiring::less(g_w.first, _backward_blue_min[w])) continue;
+            const label f_w = backward_estimate(w, g_w);
+            if(beyond_solutions(f_w)) continue;
+            _backward_heap.push(entry(f_w, w, g_w));
+        }
+    }
+
+public:
+    // Not noexcept: it allocates and runs the user's length maps. Idempotent
+    // until reset().
+    bidirectional_biobjective_dijkstra & run() {
+        if(_converged) return *this;
+        fill_distances<blue_semiring>(views::reverse(_graph), _blue_length_map,
+                                      _target, _blue_to_target);
+        fill_distances<red_semiring>(views::reverse(_graph), _red_length_map,
+                                     _target, _red_to_target);
+        fill_distances<blue_semiring>(_graph, _blue_length_map, _source,
+                                      _blue_from_source);
+        fill_distances<red_semiring>(_graph, _red_length_map, _source,
+                                     _red_from_source);
+        _forward_red_min.fill(red_semiring::infty);
+        _backward_blue_min.fill(blue_semiring::infty);
+        _forward_heap.clear();
+        _backward_heap.clear();
+        _pareto_front.resize(0);
+        _backward_solutions.resize(0);
+
+        if(reaches_target(_source)) {
+            const label zero(blue_semiring::zero, red_semiring::zero);
+            _forward_heap.push(
+                entry(forward_estimate(_source, zero), _source, zero));
+            _backward_heap.push(
+                entry(backward_estimate(_target, zero), _target, zero));
+        }
+        while(!_forward_heap.empty() || !_backward_heap.empty()) {
+            if(!_forward_heap.empty()) forward_step();
+            if(!_backward_heap.empty()) backward_step();
+        }
+        // the backward solutions came by increasing red cost, so decreasing
+        // blue cost, and all after the forward ones
+        _pareto_front.insert(_pareto_front.end(),
+                             _backward_solutions.rbegin(),
+                             _backward_solutions.rend());
+        _converged = true;
+        return *this;
+    }
+
+    // The (blue, red) costs of the Pareto-optimal source-target paths, by
+    // increasing blue cost; empty if the target is unreachable. Precondition:
+    // run() has converged.
+    [[nodiscard]] std::span<const label> pareto_front() const noexcept {
+        assert(_converged);
+        return _pareto_front;
+    }
+};
+
+template <typename Graph, typename BlueLengthMap, typename RedLengthMap>
+bidirectional_biobjective_dijkstra(Graph &&, BlueLengthMap &&, RedLengthMap &&,
+                                   const vertex_t<Graph> &,
+                                   const vertex_t<Graph> &)
+    -> bidirectional_biobjective_dijkstra<views::graph_all_t<Graph>,
+                                          maps::mapping_all_t<BlueLengthMap>,
+                                          maps::mapping_all_t<RedLengthMap>>;
+
+template <typename Graph, typename BlueLengthMap, typename RedLengthMap,
+          typename Traits>
+bidirectional_biobjective_dijkstra(Traits, Graph &&, BlueLengthMap &&,
+                                   RedLengthMap &&, const vertex_t<Graph> &,
+                                   const vertex_t<Graph> &)
+    -> bidirectional_biobjective_dijkstra<views::graph_all_t<Graph>,
+                                          maps::mapping_all_t<BlueLengthMap>,
+                                          maps::mapping_all_t<RedLengthMap>,
+                                          Traits>;
+
+}  // namespace melon
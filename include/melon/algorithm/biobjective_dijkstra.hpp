@@ -1,9 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <ranges>
 #include <set>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "melon/container/d_ary_heap.hpp"
 #include "melon/detail/prefetch.hpp"
@@ -24,6 +28,7 @@ concept biobjective_dijkstra_traits =
     requires(typename Traits::label & e) {
         { e.first };
         { e.second };
+        { Traits::flat_pareto_fronts } -> std::convertible_to<bool>;
     };
 // clang-format on
 
@@ -36,6 +41,7 @@ struct biobjective_dijkstra_default_traits {
     using heap =
         d_ary_heap<2, std::pair<vertex_t<Graph>, label>,
                    typename blue_semiring::less_t, maps::element_map<1, 0>>;
+    static constexpr bool flat_pareto_fronts = false;
 };
 
 // Label-setting Pareto search over two independent costs: instead of one
@@ -53,6 +59,13 @@ struct biobjective_dijkstra_default_traits {
 // output is silently incomplete.
 // Cost is output-sensitive: the number of Pareto-optimal labels can grow
 // exponentially with the size of the graph, so there is no polynomial bound.
+//
+// A front is a std::set by default, a node allocation per label. With
+// Traits::flat_pareto_fronts it is a std::vector instead, sorted the same way:
+// increasing blue costs, hence strictly decreasing red ones, so both the
+// dominance test and the range of labels a new one dominates are binary
+// searches, and the update is one shift of the labels after it. The vectors
+// keep their capacity across reset(), so a search run again allocates nothing.
 template <graph_view Graph, mapping_view<arc_t<Graph>> BlueLengthMap,
           mapping_view<arc_t<Graph>> RedLengthMap,
           biobjective_dijkstra_traits Traits =
@@ -82,7 +95,10 @@ private:
             return Traits::blue_semiring::less(l1.first, l2.first);
         }
     };
-    vertex_map_t<Graph, std::set<label, labels_cmp>> _pareto_front_map;
+    using pareto_front_type =
+        std::conditional_t<Traits::flat_pareto_fronts, std::vector<label>,
+                           std::set<label, labels_cmp>>;
+    vertex_map_t<Graph, pareto_front_type> _pareto_front_map;
     heap _heap;
 
 public:
@@ -93,7 +109,7 @@ public:
         , _blue_length_map(maps::mapping_all(std::forward<BLM>(blm)))
         , _red_length_map(maps::mapping_all(std::forward<RLM>(rlm)))
         , _pareto_front_map(
-              create_vertex_map<std::set<label, labels_cmp>>(_graph))
+              create_vertex_map<pareto_front_type>(_graph))
         , _heap() {}
 
     template <typename... Args>
@@ -142,9 +158,20 @@ public:
         return *this;
     }
 
+private:
+    // The first label of a front with a larger blue cost than l.
+    template <typename Labels>
+    [[nodiscard]] static auto upper_bound(Labels & labels, const label & l) {
+        if constexpr(Traits::flat_pareto_fronts)
+            return std::ranges::upper_bound(labels, l, labels_cmp{});
+        else
+            return labels.upper_bound(l);
+    }
+
+public:
     [[nodiscard]] bool is_dominated(const vertex & v, const label & l) const {
         auto & labels = _pareto_front_map[v];
-        auto it = labels.upper_bound(l);
+        auto it = upper_bound(labels, l);
         if(it == labels.begin()) return false;
         const auto pred_it = std::prev(it);
         if(Traits::blue_semiring::less(pred_it->first, l.first))
@@ -158,8 +185,7 @@ private:
     // non-dominated when inserted. Sources enter through add_source().
     void relax(const vertex & v, const label & l) {
         auto & labels = _pareto_front_map[v];
-        auto it = labels.upper_bound(l);
-        auto last_sub_it = it;
+        auto it = upper_bound(labels, l);
 
         if(it != labels.begin()) {
             const auto pred_it = std::prev(it);
@@ -168,11 +194,25 @@ private:
                 it = pred_it;
         }
 
-        while(last_sub_it != labels.end() &&
-              !Traits::red_semiring::less(last_sub_it->second, l.second))
-            ++last_sub_it;
-
-        labels.insert(labels.erase(it, last_sub_it), l);
+        // the labels l dominates: from it on, those with no smaller red cost
+        const auto dominated_by_l = [&l](const label & other) {
+            return !Traits::red_semiring::less(other.second, l.second);
+        };
+        if constexpr(Traits::flat_pareto_fronts) {
+            const auto last_sub_it =
+                std::partition_point(it, labels.end(), dominated_by_l);
+            if(it == last_sub_it) {
+                labels.insert(it, l);
+            } else {
+                *it = l;
+                labels.erase(std::next(it), last_sub_it);
+            }
+        } else {
+            auto last_sub_it = it;
+            while(last_sub_it != labels.end() && dominated_by_l(*last_sub_it))
+                ++last_sub_it;
+            labels.insert(labels.erase(it, last_sub_it), l);
+        }
         _heap.push(std::make_pair(v, l));
     }
 
@@ -0,0 +1,559 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <vector>
+
+#include "melon/graph.hpp"
+#include "melon/mapping.hpp"
+
+namespace melon {
+
+// Boykov and Kolmogorov's maximum flow, in the terminal-capacity form of
+// vision problems: every vertex has a capacity from the source and one to the
+// sink, and the graph's arcs carry the pairwise terms. Two search trees grow
+// from the terminals and are repaired, not regrown, after each augmentation
+// -- the orphans an augmentation cuts off are adopted by a neighbour still
+// rooted in the same tree when one exists.
+//
+// Terminal capacities may change between calls to run(); the next run()
+// resumes from the current flow and trees, in the manner of Kohli and Torr's
+// dynamic graph cuts, instead of starting over. A capacity lowered below the
+// flow it already carries is handled by reparameterization: the excess is
+// added to both terminal capacities of the vertex, which shifts every cut by
+// the same constant, and flow_value() subtracts it back.
+//
+// Capacities must be non-negative. O(n^2 m |C|) in the worst case, C a
+// minimum cut, and close to linear on the grids it is designed for.
+template <graph_view Graph, mapping_view<arc_t<Graph>> CapacityMap>
+    requires outward_incidence_graph<Graph> && inward_incidence_graph<Graph> &&
+             has_vertex_map<Graph> && has_arc_map<Graph>
+class boykov_kolmogorov {
+private:
+    using vertex = vertex_t<Graph>;
+    using arc = arc_t<Graph>;
+    using value_t = mapped_value_t<CapacityMap, arc_t<Graph>>;
+
+    enum class tree : char { none, source, sink };
+    // How a tree vertex hangs from its parent. `forward` and `backward` say
+    // whether sending flow along the tree, toward the sink, raises or lowers
+    // the flow of the parent arc.
+    enum class link : char { none, terminal, orphan, forward, backward };
+
+private:
+    Graph _graph;
+    CapacityMap _capacity_map;
+    bool _initialized;
+    bool _converged;
+    value_t _flow_value;
+    value_t _reparameterization;
+    std::size_t _time;
+    arc_map_t<Graph, value_t> _carried_flow_map;
+    vertex_map_t<Graph, value_t> _source_capacity_map;
+    vertex_map_t<Graph, value_t> _sink_capacity_map;
+    vertex_map_t<Graph, value_t> _source_residual_map;
+    vertex_map_t<Graph, value_t> _sink_residual_map;
+    vertex_map_t<Graph, tree> _tree_map;
+    vertex_map_t<Graph, link> _link_map;
+    vertex_map_t<Graph, arc> _parent_arc_map;
+    // The time a vertex's distance to its root was last known exact, and
+    // that distance: adoption prefers the closest valid parent, and stops
+    // walking up a candidate's path at the first vertex stamped this round.
+    vertex_map_t<Graph, std::size_t> _timestamp_map;
+    vertex_map_t<Graph, std::size_t> _distance_map;
+    vertex_map_t<Graph, char> _active_map;
+    vertex_map_t<Graph, char> _changed_map;
+    std::vector<vertex> _active_queue;
+    std::size_t _active_head;
+    std::vector<vertex> _orphans;
+    std::vector<vertex> _changed;
+
+public:
+    // Every terminal capacity starts at zero; set them with
+    // set_source_capacity() and set_sink_capacity().
+    template <graph_for<Graph> G, mapping_for<CapacityMap> CM>
+    boykov_kolmogorov(G && g, CM && cm)
+        : _graph(views::graph_all(std::forward<G>(g)))
+        , _capacity_map(maps::mapping_all(std::forward<CM>(cm)))
+        , _initialized(false)
+        , _converged(false)
+        , _flow_value(0)
+        , _reparameterization(0)
+        , _time(0)
+        , _carried_flow_map(create_arc_map<value_t>(_graph))
+        , _source_capacity_map(create_vertex_map<value_t>(_graph, value_t{0}))
+        , _sink_capacity_map(create_vertex_map<value_t>(_graph, value_t{0}))
+        , _source_residual_map(create_vertex_map<value_t>(_graph))
+        , _sink_residual_map(create_vertex_map<value_t>(_graph))
+        , _tree_map(create_vertex_map<tree>(_graph))
+        , _link_map(create_vertex_map<link>(_graph))
+        , _parent_arc_map(create_vertex_map<arc>(_graph))
+        , _timestamp_map(create_vertex_map<std::size_t>(_graph))
+        , _distance_map(create_vertex_map<std::size_t>(_graph))
+        , _active_map(create_vertex_map<char>(_graph))
+        , _changed_map(create_vertex_map<char>(_graph, char{0}))
+        , _active_head(0) {
+        reset();
+    }
+
+    template <graph_for<Graph> G, mapping_for<CapacityMap> CM,
+              mapping<vertex_t<Graph>> SM, mapping<vertex_t<Graph>> TM>
+    boykov_kolmogorov(G && g, CM && cm, const SM & source_capacities,
+                      const TM & sink_capacities)
+        : boykov_kolmogorov(std::forward<G>(g), std::forward<CM>(cm)) {
+        for(auto && v : vertices(_graph)) {
+            _source_capacity_map[v] = source_capacities[v];
+            _sink_capacity_map[v] = sink_capacities[v];
+        }
+        reset();
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    boykov_kolmogorov(const boykov_kolmogorov &) = delete;
+    boykov_kolmogorov(boykov_kolmogorov &&) = default;
+
+    boykov_kolmogorov & operator=(const boykov_kolmogorov &) = delete;
+    boykov_kolmogorov & operator=(boykov_kolmogorov &&) = default;
+
+    [[nodiscard]] constexpr Graph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const Graph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr Graph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const Graph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    // Zeroes the flow and drops the search trees; the terminal capacities
+    // set so far are kept.
+    boykov_kolmogorov & reset() {
+        _initialized = false;
+        _converged = false;
+        _flow_value = value_t{0};
+        _reparameterization = value_t{0};
+        for(auto && a : arcs(_graph)) _carried_flow_map[a] = value_t{0};
+        for(auto && v : vertices(_graph)) {
+            _source_residual_map[v] = _source_capacity_map[v];
+            _sink_residual_map[v] = _sink_capacity_map[v];
+            push_through(v);
+            _changed_map[v] = 0;
+        }
+        _changed.clear();
+        return *this;
+    }
+
+private:
+    // Sends what it can straight from the source to the sink through v,
+    // so that at most one of the two terminal residuals stays positive.
+    void push_through(const vertex & v) {
+        const value_t delta =
+            std::min(_source_residual_map[v], _sink_residual_map[v]);
+        _source_residual_map[v] -= delta;
+        _sink_residual_map[v] -= delta;
+        _flow_value += delta;
+    }
+
+    // `residual` is the terminal residual facing the changed capacity,
+    // `opposite` the other one.
+    void change_terminal_capacity(const vertex & v, value_t & capacity,
+                                  value_t & residual, value_t & opposite,
+                                  const value_t new_capacity) {
+        if(new_capacity >= capacity) {
+            residual += new_capacity - capacity;
+        } else if(capacity - new_capacity <= residual) {
+            residual -= capacity - new_capacity;
+        } else {
+            const value_t excess = capacity - new_capacity - residual;
+            residual = value_t{0};
+            opposite += excess;
+            _reparameterization += excess;
+        }
+        capacity = new_capacity;
+        push_through(v);
+        _converged = false;
+        if(_initialized && !_changed_map[v]) {
+            _changed_map[v] = 1;
+            _changed.push_back(v);
+        }
+    }
+
+public:
+    boykov_kolmogorov & set_source_capacity(const vertex & v,
+                                            const value_t & c) {
+        change_terminal_capacity(v, _source_capacity_map[v],
+                                 _source_residual_map[v],
+                                 _sink_residual_map[v], c);
+        return *this;
+    }
+    boykov_kolmogorov & set_sink_capacity(const vertex & v, const value_t & c) {
+        change_terminal_capacity(v, _sink_capacity_map[v],
+                                 _sink_residual_map[v],
+                                 _source_residual_map[v], c);
+        return *this;
+    }
+    [[nodiscard]] constexpr value_t source_capacity(const vertex & v) const {
+        return _source_capacity_map[v];
+    }
+    [[nodiscard]] constexpr value_t sink_capacity(const vertex & v) const {
+        return _sink_capacity_map[v];
+    }
+
+private:
+    [[nodiscard]] constexpr value_t residual(const arc & a,
+                                             const bool forward) const {
+        return forward ? _capacity_map[a] - _carried_flow_map[a]
+                       : _carried_flow_map[a];
+    }
+    constexpr void push(const arc & a, const bool forward,
+                        const value_t & delta) {
+        if(forward)
+            _carried_flow_map[a] += delta;
+        else
+            _carried_flow_map[a] -= delta;
+    }
+
+    [[nodiscard]] constexpr vertex parent(const vertex & v) const {
+        const arc & a = _parent_arc_map[v];
+        const vertex u = arc_source(_graph, a);
+        return u == v ? arc_target(_graph, a) : u;
+    }
+    [[nodiscard]] constexpr bool is_child_through(const vertex & w,
+                                                  const arc & a) const {
+        return (_link_map[w] == link::forward ||
+                _link_map[w] == link::backward) &&
+               _parent_arc_map[w] == a;
+    }
+
+    // Calls f(a, w, is_out_arc) on every arc between v and another vertex w,
+    // until f returns true.
+    template <typename F>
+    bool for_each_neighbor(const vertex & v, F && f) {
+        for(auto && a : out_arcs(_graph, v)) {
+            const vertex w = arc_target(_graph, a);
+            if(w != v && f(a, w, true)) return true;
+        }
+        for(auto && a : in_arcs(_graph, v)) {
+            const vertex w = arc_source(_graph, a);
+            if(w != v && f(a, w, false)) return true;
+        }
+        return false;
+    }
+
+    void activate(const vertex & v) {
+        if(_active_map[v]) return;
+        _active_map[v] = 1;
+        _active_queue.push_back(v);
+    }
+    void make_orphan(const vertex & v) {
+        _link_map[v] = link::orphan;
+        _orphans.push_back(v);
+    }
+    void make_root(const vertex & v, const tree t) {
+        _tree_map[v] = t;
+        _link_map[v] = link::terminal;
+        _timestamp_map[v] = _time;
+        _distance_map[v] = 1;
+        activate(v);
+    }
+
+    void initialize_trees() {
+        _time = 0;
+        _active_queue.clear();
+        _active_head = 0;
+        for(auto && v : vertices(_graph)) {
+            _tree_map[v] = tree::none;
+            _link_map[v] = link::none;
+            _active_map[v] = 0;
+            if(_source_residual_map[v] > value_t{0})
+                make_root(v, tree::source);
+            else if(_sink_residual_map[v] > value_t{0})
+                make_root(v, tree::sink);
+        }
+        _initialized = true;
+    }
+
+    // Terminal capacities changed since the last run(): a vertex that lost
+    // its terminal residual is orphaned, and one that gained some becomes a
+    // root of the matching tree, orphaning its children if it switched trees.
+    void repair_changed_vertices() {
+        for(const vertex & v : _changed) {
+            _changed_map[v] = 0;
+            tree t = tree::none;
+            if(_source_residual_map[v] > value_t{0})
+                t = tree::source;
+            else if(_sink_residual_map[v] > value_t{0})
+                t = tree::sink;
+            if(t == tree::none) {
+                if(_link_map[v] == link::terminal) make_orphan(v);
+                continue;
+            }
+            // Switching trees also reactivates the old tree's neighbours that
+            // have residual capacity toward v: every vertex with a residual
+            // arc leaving its own tree must be active, and these were not.
+            if(_tree_map[v] != tree::none && _tree_map[v] != t) {
+                const tree old_tree = _tree_map[v];
+                for_each_neighbor(v, [&](const arc & a, const vertex & w,
+                                         const bool is_out) {
+                    if(_tree_map[w] != old_tree) return false;
+                    if(residual(a, is_out == (old_tree == tree::sink)) >
+                       value_t{0})
+                        activate(w);
+                    if(is_child_through(w, a)) make_orphan(w);
+                    return false;
+                });
+            }
+            make_root(v, t);
+        }
+        _changed.clear();
+    }
+
+    // The bottleneck of the path from the source to the sink through the
+    // residual arc (a, forward) joining the two trees, then the augmentation,
+    // which orphans every vertex whose parent arc it saturates.
+    void augment(const vertex & s_end, const arc & a, const bool forward,
+                 const vertex & t_end) {
+        value_t delta = residual(a, forward);
+        vertex u = s_end;
+        for(; _link_map[u] != link::terminal; u = parent(u))
+            delta = std::min(delta, residual(_parent_arc_map[u],
+                                             _link_map[u] == link::forward));
+        delta = std::min(delta, _source_residual_map[u]);
+        for(u = t_end; _link_map[u] != link::terminal; u = parent(u))
+            delta = std::min(delta, residual(_parent_arc_map[u],
+                                             _link_map[u] == link::forward));
+        delta = std::min(delta, _sink_residual_map[u]);
+
+        push(a, forward, delta);
+        for(u = s_end; _link_map[u] != link::terminal;) {
+            const vertex p = parent(u);
+            const bool f = _link_map[u] == link::forward;
+            push(_parent_arc_map[u], f, delta);
+            if(residual(_parent_arc_map[u], f) == value_t{0}) make_orphan(u);
+            u = p;
+        }
+        _source_residual_map[u] -= delta;
+        if(_source_residual_map[u] == value_t{0}) make_orphan(u);
+        for(u = t_end; _link_map[u] != link::terminal;) {
+            const vertex p = parent(u);
+            const bool f = _link_map[u] == link::forward;
+            push(_parent_arc_map[u], f, delta);
+            if(residual(_parent_arc_map[u], f) == value_t{0}) make_orphan(u);
+            u = p;
+        }
+        _sink_residual_map[u] -= delta;
+        if(_sink_residual_map[u] == value_t{0}) make_orphan(u);
+        _flow_value += delta;
+    }
+
+    // Hangs the orphan o from the neighbour of its tree whose path to the
+    // root is shortest, or frees it if none has a path left. Walking up a
+    // candidate's path stamps every vertex on it, so the total work per
+    // adoption round stays close to linear.
+    void adopt(const vertex & o) {
+        const tree t = _tree_map[o];
+        constexpr std::size_t unreachable =
+            std::numeric_limits<std::size_t>::max();
+        std::size_t best_distance = unreachable;
+        arc best_arc{};
+        bool best_forward = false;
+        for_each_neighbor(o, [&](const arc & a, const vertex & p,
+                                 const bool is_out) {
+            if(_tree_map[p] != t) return false;
+            // the flow goes p -> o in the source tree, o -> p in the sink one
+            const bool forward = is_out == (t == tree::sink);
+            if(residual(a, forward) == value_t{0}) return false;
+            std::size_t d = 0;
+            for(vertex u = p;; u = parent(u)) {
+                if(_timestamp_map[u] == _time) {
+                    d += _distance_map[u];
+                    break;
+                }
+                ++d;
+                if(_link_map[u] == link::terminal) {
+                    _timestamp_map[u] = _time;
+                    _distance_map[u] = 1;
+                    break;
+                }
+                if(_link_map[u] == link::orphan) {
+                    d = unreachable;
+                    break;
+                }
+            }
+            if(d == unreachable) return false;
+            if(d < best_distance) {
+                best_distance = d;
+                best_arc = a;
+                best_forward = forward;
+            }
+            for(vertex u = p; _timestamp_map[u] != _time; u = parent(u)) {
+                _timestamp_map[u] = _time;
+                _distance_map[u] = d--;
+            }
+            return false;
+        });
+
+        if(best_distance != unreachable) {
+            _link_map[o] = best_forward ? link::forward : link::backward;
+            _parent_arc_map[o] = best_arc;
+            _timestamp_map[o] = _time;
+            _distance_map[o] = best_distance + 1;
+            return;
+        }
+        for_each_neighbor(o, [&](const arc & a, const vertex & p,
+                                 const bool is_out) {
+            if(_tree_map[p] != t) return false;
+            if(residual(a, is_out == (t == tree::sink)) > value_t{0})
+                activate(p);
+            if(is_child_through(p, a)) make_orphan(p);
+            return false;
+        });
+        _tree_map[o] = tree::none;
+        _link_map[o] = link::none;
+    }
+
+    void adopt_orphans() {
+        for(std::size_t i = 0; i < _orphans.size(); ++i) {
+            const vertex o = _orphans[i];
+            // a changed vertex may have been made a root since
+            if(_link_map[o] == link::orphan) adopt(o);
+        }
+        _orphans.clear();
+    }
+
+    // Scans the active vertex v for a free neighbour to claim or one of the
+    // other tree to meet; returns whether it found the latter.
+    bool grow(const vertex & v, vertex & s_end, arc & meeting_arc,
+              bool & meeting_forward, vertex & t_end) {
+        const tree t = _tree_map[v];
+        return for_each_neighbor(v, [&](const arc & a, const vertex & w,
+                                        const bool is_out) {
+            // the flow goes v -> w in the source tree, w -> v in the sink one
+            const bool forward = is_out == (t == tree::source);
+            if(residual(a, forward) == value_t{0}) return false;
+            if(_tree_map[w] == tree::none) {
+                _tree_map[w] = t;
+                _link_map[w] = forward ? link::forward : link::backward;
+                _parent_arc_map[w] = a;
+                _timestamp_map[w] = _timestamp_map[v];
+                _distance_map[w] = _distance_map[v] + 1;
+                activate(w);
+                return false;
+            }
+            if(_tree_map[w] != t) {
+                s_end = t == tree::source ? v : w;
+                t_end = t == tree::source ? w : v;
+                meeting_arc = a;
+                meeting_forward = forward;
+                return true;
+            }
+            // a shorter path for w through v, by the labels both carry
+            if(_timestamp_map[w] <= _timestamp_map[v] &&
+               _distance_map[w] > _distance_map[v] + 1) {
+                _link_map[w] = forward ? link::forward : link::backward;
+                _parent_arc_map[w] = a;
+                _timestamp_map[w] = _timestamp_map[v];
+                _distance_map[w] = _distance_map[v] + 1;
+            }
+            return false;
+        });
+    }
+
+public:
+    boykov_kolmogorov & run() {
+        if(_converged) return *this;
+        if(!_initialized) {
+            initialize_trees();
+        } else {
+            ++_time;
+            repair_changed_vertices();
+            adopt_orphans();
+        }
+        while(_active_head < _active_queue.size()) {
+            const vertex v = _active_queue[_active_head++];
+            _active_map[v] = 0;
+            if(_tree_map[v] == tree::none) continue;
+            vertex s_end{}, t_end{};
+            arc meeting_arc{};
+            bool meeting_forward = false;
+            if(!grow(v, s_end, meeting_arc, meeting_forward, t_end)) continue;
+            ++_time;
+            augment(s_end, meeting_arc, meeting_forward, t_end);
+            adopt_orphans();
+            // v may have more to offer once the path through it is gone
+            if(_tree_map[v] != tree::none) activate(v);
+            if(_active_head > _active_queue.size() / 2) {
+                _active_queue.erase(
+                    _active_queue.begin(),
+                    _active_queue.begin() +
+                        static_cast<std::ptrdiff_t>(_active_head));
+                _active_head = 0;
+            }
+        }
+        _active_queue.clear();
+        _active_head = 0;
+        _converged = true;
+        return *this;
+    }
+
+    // The flow from the source, counting what push_through() sent straight
+    // across vertices: zero after reset(), the maximum once run() has
+    // converged. Under reparameterization it is the flow of the problem as
+    // last set, not of the reparameterized one the flows describe.
+    [[nodiscard]] constexpr value_t flow_value() const noexcept {
+        return _flow_value - _reparameterization;
+    }
+
+    [[nodiscard]] constexpr value_t flow(const arc & a) const
+        noexcept(noexcept(_carried_flow_map[a])) {
+        return _carried_flow_map[a];
+    }
+    // Refers into the algorithm, like every melon map view: valid while this
+    // object lives and stays put.
+    [[nodiscard]] constexpr auto flows_map() const & noexcept(
+        noexcept(maps::mapping_all(_carried_flow_map))) {
+        return maps::mapping_all(_carried_flow_map);
+    }
+    // Terminal, like std::move(alg).base(): the member left behind is valid but
+    // empty, so no other member may be called afterwards.
+    [[nodiscard]] constexpr auto flows_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_carried_flow_map)))) {
+        return maps::mapping_all(std::move(_carried_flow_map));
+    }
+
+    // Precondition: run() has converged. The source side is the final
+    // source tree -- every vertex with a residual path from the source --
+    // and a vertex neither tree reached is on the sink side.
+    [[nodiscard]] constexpr bool on_source_side(const vertex & v) const {
+        assert(_converged);
+        return _tree_map[v] == tree::source;
+    }
+    // The arcs of the graph crossing the cut; the terminal capacities of the
+    // source side's sink arcs and of the sink side's source arcs complete it.
+    [[nodiscard]] constexpr auto minimum_cut() const {
+        assert(_converged);
+        return std::views::filter(
+            arcs(_graph), [this](const arc_t<Graph> & a) {
+                return _tree_map[arc_source(_graph, a)] == tree::source &&
+                       _tree_map[arc_target(_graph, a)] != tree::source;
+            });
+    }
+};
+
+template <typename Graph, typename CapacityMap>
+boykov_kolmogorov(Graph &&, CapacityMap &&)
+    -> boykov_kolmogorov<views::graph_all_t<Graph>,
+                         maps::mapping_all_t<CapacityMap>>;
+
+template <typename Graph, typename CapacityMap, typename SourceCapacityMap,
+          typename SinkCapacityMap>
+boykov_kolmogorov(Graph &&, CapacityMap &&, const SourceCapacityMap &,
+                  const SinkCapacityMap &)
+    -> boykov_kolmogorov<views::graph_all_t<Graph>,
+                         maps::mapping_all_t<CapacityMap>>;
+
+}  // namespace melon
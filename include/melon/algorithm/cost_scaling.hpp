@@ -0,0 +1,478 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include "melon/graph.hpp"
+#include "melon/mapping.hpp"
+
+namespace melon {
+
+// Goldberg and Tarjan's cost-scaling push-relabel for the minimum-cost flow
+// problem stated in network_simplex.hpp: flows within [0, capacity(a)], every
+// vertex v emitting supply(v) more than it receives, at least cost.
+//
+// Costs are multiplied by n + 2 -- one more than the vertex count, root
+// included -- and the flow is refined to be eps-optimal, with no residual arc
+// of reduced cost below -eps, for an eps divided by `alpha` each round down
+// to 1: eps-optimality for the scaled costs is then optimality for the
+// original ones. Each refinement saturates the arcs
+// of negative reduced cost, then discharges the resulting excesses in FIFO
+// order, lowering the potential of a vertex when it has no admissible arc
+// left. The potentials are then turned into exact dual values for the
+// original costs by a label-correcting pass seeded with them.
+//
+// An artificial root, joined both ways to every vertex at a cost dearer than
+// any path of real arcs, makes every refinement terminate; an artificial arc
+// carrying flow at the end means that no feasible flow exists.
+//
+// Capacities and costs must be integers, capacities non-negative. O(n^2 m
+// log(n C)), C the largest absolute cost; costs are scaled in long long.
+template <graph_view Graph, mapping_view<arc_t<Graph>> CapacityMap,
+          mapping_view<arc_t<Graph>> CostMap,
+          mapping_view<vertex_t<Graph>> SupplyMap>
+    requires has_vertex_map<Graph> && has_arc_map<Graph> &&
+             std::signed_integral<mapped_value_t<CapacityMap, arc_t<Graph>>> &&
+             std::signed_integral<mapped_value_t<CostMap, arc_t<Graph>>> &&
+             std::convertible_to<mapped_value_t<SupplyMap, vertex_t<Graph>>,
+                                 mapped_value_t<CapacityMap, arc_t<Graph>>>
+class cost_scaling {
+private:
+    using vertex = vertex_t<Graph>;
+    using arc = arc_t<Graph>;
+    using flow_t = mapped_value_t<CapacityMap, arc_t<Graph>>;
+    using cost_t = mapped_value_t<CostMap, arc_t<Graph>>;
+    using large_cost_t = long long;
+
+    static constexpr large_cost_t alpha = 16;
+
+private:
+    Graph _graph;
+    CapacityMap _capacity_map;
+    CostMap _cost_map;
+    SupplyMap _supply_map;
+    bool _converged;
+    bool _feasible;
+    arc_map_t<Graph, flow_t> _carried_flow_map;
+    vertex_map_t<Graph, cost_t> _potential_map;
+
+    // The residual network, indexed densely: vertex i < n, the root n, arc
+    // e < m, and the artificial arcs i -> root at m + 2i and root -> i at
+    // m + 2i + 1. Half-arc 2e is arc e forward, 2e + 1 backward, and the
+    // half-arcs leaving vertex i are _out[_first_out[i] .. _first_out[i+1]).
+    vertex_map_t<Graph, std::size_t> _index_map;
+    std::vector<vertex> _vertices;
+    std::vector<arc> _arcs;
+    std::vector<std::size_t> _source;
+    std::vector<std::size_t> _target;
+    std::vector<std::size_t> _first_out;
+    std::vector<std::size_t> _out;
+    std::vector<flow_t> _capacity;
+    std::vector<flow_t> _flow;
+    std::vector<large_cost_t> _cost;
+    std::vector<flow_t> _supply;
+    std::vector<flow_t> _excess;
+    std::vector<large_cost_t> _pi;
+    std::vector<std::size_t> _current_out;
+    std::vector<std::size_t> _active_queue;
+    // The global price update: bucketed distances to the deficits, and the
+    // relabels since the last one.
+    std::vector<std::size_t> _rank;
+    std::vector<char> _scanned;
+    std::vector<std::vector<std::size_t>> _buckets;
+    std::size_t _relabels;
+
+public:
+    template <graph_for<Graph> G, mapping_for<CapacityMap> CM,
+              mapping_for<CostMap> CoM, mapping_for<SupplyMap> SM>
+    cost_scaling(G && g, CM && capacities, CoM && costs, SM && supplies)
+        : _graph(views::graph_all(std::forward<G>(g)))
+        , _capacity_map(maps::mapping_all(std::forward<CM>(capacities)))
+        , _cost_map(maps::mapping_all(std::forward<CoM>(costs)))
+        , _supply_map(maps::mapping_all(std::forward<SM>(supplies)))
+        , _converged(false)
+        , _feasible(false)
+        , _carried_flow_map(create_arc_map<flow_t>(_graph))
+        , _potential_map(create_vertex_map<cost_t>(_graph))
+        , _index_map(create_vertex_map<std::size_t>(_graph))
+        , _relabels(0) {
+        for(auto && v : vertices(_graph)) {
+            _index_map[v] = _vertices.size();
+            _vertices.push_back(v);
+        }
+        for(auto && [a, endpoints] : arcs_entries(_graph)) {
+            _arcs.push_back(a);
+            _source.push_back(_index_map[endpoints.first]);
+            _target.push_back(_index_map[endpoints.second]);
+        }
+        const std::size_t n = _vertices.size();
+        for(std::size_t i = 0; i < n; ++i) {
+            _source.push_back(i);
+            _target.push_back(n);
+            _source.push_back(n);
+            _target.push_back(i);
+        }
+        build_residual_network();
+        reset();
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    cost_scaling(const cost_scaling &) = delete;
+    cost_scaling(cost_scaling &&) = default;
+
+    cost_scaling & operator=(const cost_scaling &) = delete;
+    cost_scaling & operator=(cost_scaling &&) = default;
+
+    [[nodiscard]] constexpr Graph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const Graph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr Graph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const Graph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    // Zeroes the flows and potentials. The capacity, cost and supply maps
+    // are read again by the next run(), so they may change in between.
+    cost_scaling & reset() {
+        _converged = false;
+        _feasible = false;
+        for(auto && a : arcs(_graph)) _carried_flow_map[a] = flow_t{0};
+        for(auto && v : vertices(_graph)) _potential_map[v] = cost_t{0};
+        return *this;
+    }
+
+private:
+    // Counting sort of the half-arcs by tail.
+    void build_residual_network() {
+        const std::size_t num_nodes = _vertices.size() + 1;
+        const std::size_t num_half_arcs = 2 * _source.size();
+        _first_out.assign(num_nodes + 1, 0);
+        for(std::size_t h = 0; h < num_half_arcs; ++h) ++_first_out[tail(h) + 1];
+        for(std::size_t i = 0; i < num_nodes; ++i)
+            _first_out[i + 1] += _first_out[i];
+        _out.resize(num_half_arcs);
+        std::vector<std::size_t> cursor(_first_out.begin(),
+                                        _first_out.end() - 1);
+        for(std::size_t h = 0; h < num_half_arcs; ++h)
+            _out[cursor[tail(h)]++] = h;
+    }
+
+    [[nodiscard]] std::size_t tail(const std::size_t h) const noexcept {
+        return (h & 1) ? _target[h >> 1] : _source[h >> 1];
+    }
+    [[nodiscard]] std::size_t head(const std::size_t h) const noexcept {
+        return (h & 1) ? _source[h >> 1] : _target[h >> 1];
+    }
+    [[nodiscard]] flow_t residual(const std::size_t h) const noexcept {
+        return (h & 1) ? _flow[h >> 1] : _capacity[h >> 1] - _flow[h >> 1];
+    }
+    [[nodiscard]] large_cost_t cost(const std::size_t h) const noexcept {
+        return (h & 1) ? -_cost[h >> 1] : _cost[h >> 1];
+    }
+    [[nodiscard]] large_cost_t reduced_cost(const std::size_t h) const noexcept {
+        return cost(h) + _pi[tail(h)] - _pi[head(h)];
+    }
+
+    // Reads the maps; false if the supplies do not sum to zero, since no
+    // flow can then exist and the root would absorb the imbalance forever.
+    [[nodiscard]] bool initialize() {
+        const std::size_t n = _vertices.size();
+        const std::size_t m = _arcs.size();
+        _capacity.assign(m + 2 * n, flow_t{0});
+        _flow.assign(m + 2 * n, flow_t{0});
+        _cost.assign(m + 2 * n, 0);
+        _supply.assign(n + 1, flow_t{0});
+        _pi.assign(n + 1, 0);
+
+        flow_t balance{0}, total_supply{0};
+        for(std::size_t i = 0; i < n; ++i) {
+            _supply[i] = static_cast<flow_t>(_supply_map[_vertices[i]]);
+            balance += _supply[i];
+            total_supply += _supply[i] < flow_t{0} ? -_supply[i] : _supply[i];
+        }
+        if(balance != flow_t{0}) return false;
+
+        large_cost_t max_cost = 0;
+        for(std::size_t e = 0; e < m; ++e) {
+            _capacity[e] = _capacity_map[_arcs[e]];
+            _cost[e] = static_cast<large_cost_t>(_cost_map[_arcs[e]]);
+            assert(!(_capacity[e] < flow_t{0}));
+            max_cost = std::max(max_cost, _cost[e] < 0 ? -_cost[e] : _cost[e]);
+        }
+        const large_cost_t artificial_cost =
+            (max_cost + 1) *
+            static_cast<large_cost_t>(std::max(n, std::size_t{1}));
+        for(std::size_t e = m; e < m + 2 * n; ++e) {
+            _capacity[e] = total_supply;
+            _cost[e] = artificial_cost;
+        }
+        return true;
+    }
+
+    void push(const std::size_t h, const flow_t delta) noexcept {
+        if(h & 1)
+            _flow[h >> 1] -= delta;
+        else
+            _flow[h >> 1] += delta;
+        _excess[tail(h)] -= delta;
+        _excess[head(h)] += delta;
+    }
+
+    // The highest potential that gives some residual arc leaving u a reduced
+    // cost of -eps, the lowest it may take.
+    void relabel(const std::size_t u, const large_cost_t eps) noexcept {
+        large_cost_t max_pi = std::numeric_limits<large_cost_t>::min();
+        for(std::size_t k = _first_out[u]; k < _first_out[u + 1]; ++k) {
+            const std::size_t h = _out[k];
+            if(residual(h) > flow_t{0})
+                max_pi = std::max(max_pi, _pi[head(h)] - cost(h));
+        }
+        assert(max_pi != std::numeric_limits<large_cost_t>::min());
+        _pi[u] = max_pi - eps;
+        ++_relabels;
+    }
+
+    // Goldberg's global update: lowers every potential at once by eps times
+    // the vertex's distance to a deficit, an arc of reduced cost c counting
+    // floor(c / eps) + 1, which keeps the flow eps-optimal and makes a path
+    // admissible from every excess. Dial's buckets, up to n of them; the
+    // vertices left unscanned take the last bucket's distance.
+    void global_update(const large_cost_t eps) {
+        const std::size_t num_nodes = _vertices.size() + 1;
+        constexpr std::size_t unreached = std::numeric_limits<std::size_t>::max();
+        _rank.assign(num_nodes, unreached);
+        _scanned.assign(num_nodes, 0);
+        _buckets.resize(num_nodes + 1);
+        std::size_t num_excesses = 0;
+        for(std::size_t i = 0; i < num_nodes; ++i) {
+            if(_excess[i] > flow_t{0}) ++num_excesses;
+            if(_excess[i] < flow_t{0}) {
+                _rank[i] = 0;
+                _buckets[0].push_back(i);
+            }
+        }
+        std::size_t k = 0;
+        for(; k < num_nodes && num_excesses > 0; ++k) {
+            while(!_buckets[k].empty() && num_excesses > 0) {
+                const std::size_t u = _buckets[k].back();
+                _buckets[k].pop_back();
+                if(_scanned[u]) continue;
+                _scanned[u] = 1;
+                if(_excess[u] > flow_t{0}) --num_excesses;
+                // the residual arcs into u are the reverses of those out of it
+                for(std::size_t j = _first_out[u]; j < _first_out[u + 1]; ++j) {
+                    const std::size_t h = _out[j] ^ 1;
+                    const std::size_t w = tail(h);
+                    if(_scanned[w] || !(residual(h) > flow_t{0})) continue;
+                    const large_cost_t c = reduced_cost(h);
+                    const std::size_t rank =
+                        k + (c < 0 ? 0 : static_cast<std::size_t>(c / eps) + 1);
+                    if(rank < num_nodes && rank < _rank[w]) {
+                        _rank[w] = rank;
+                        _buckets[rank].push_back(w);
+                    }
+                }
+            }
+            if(num_excesses == 0) break;
+        }
+        for(std::size_t i = 0; i < num_nodes; ++i) {
+            const std::size_t d = _scanned[i] ? _rank[i] : k;
+            _pi[i] -= eps * static_cast<large_cost_t>(d);
+            _current_out[i] = _first_out[i];
+        }
+        for(auto & bucket : _buckets) bucket.clear();
+        _relabels = 0;
+    }
+
+    void discharge(const std::size_t u, const large_cost_t eps) {
+        while(_excess[u] > flow_t{0}) {
+            if(_current_out[u] == _first_out[u + 1]) {
+                relabel(u, eps);
+                _current_out[u] = _first_out[u];
+                continue;
+            }
+            const std::size_t h = _out[_current_out[u]];
+            const flow_t r = residual(h);
+            if(r > flow_t{0} && reduced_cost(h) < 0) {
+                const std::size_t w = head(h);
+                const flow_t delta = std::min(_excess[u], r);
+                const bool was_active = _excess[w] > flow_t{0};
+                push(h, delta);
+                if(!was_active && _excess[w] > flow_t{0})
+                    _active_queue.push_back(w);
+                if(delta < r) break;
+            }
+            ++_current_out[u];
+        }
+    }
+
+    void refine(const large_cost_t eps) {
+        const std::size_t num_nodes = _vertices.size() + 1;
+        for(std::size_t e = 0; e < _capacity.size(); ++e) {
+            const large_cost_t c = reduced_cost(2 * e);
+            if(c < 0)
+                _flow[e] = _capacity[e];
+            else if(c > 0)
+                _flow[e] = flow_t{0};
+        }
+        _excess.assign(_supply.begin(), _supply.end());
+        for(std::size_t e = 0; e < _capacity.size(); ++e) {
+            _excess[_source[e]] -= _flow[e];
+            _excess[_target[e]] += _flow[e];
+        }
+        _active_queue.clear();
+        for(std::size_t i = 0; i < num_nodes; ++i) {
+            _current_out[i] = _first_out[i];
+            if(_excess[i] > flow_t{0}) _active_queue.push_back(i);
+        }
+        // FIFO, compacted once the consumed prefix outgrows the rest
+        std::size_t front = 0;
+        global_update(eps);
+        while(front < _active_queue.size()) {
+            if(_relabels > num_nodes) global_update(eps);
+            discharge(_active_queue[front++], eps);
+            if(2 * front > _active_queue.size()) {
+                _active_queue.erase(
+                    _active_queue.begin(),
+                    _active_queue.begin() + static_cast<std::ptrdiff_t>(front));
+                front = 0;
+            }
+        }
+    }
+
+    // Exact potentials for the original costs: the scaled ones, divided
+    // back, are nearly there, and label correcting over the residual arcs --
+    // which has no negative cycle, the flow being optimal -- finishes.
+    void compute_potentials(const large_cost_t scale) {
+        const std::size_t num_nodes = _vertices.size() + 1;
+        for(auto & c : _cost) c /= scale;
+        for(auto & p : _pi) p /= scale;
+        std::vector<char> queued(num_nodes, 1);
+        _active_queue.resize(num_nodes);
+        for(std::size_t i = 0; i < num_nodes; ++i) _active_queue[i] = i;
+        std::size_t front = 0;
+        while(front < _active_queue.size()) {
+            const std::size_t u = _active_queue[front++];
+            queued[u] = 0;
+            if(2 * front > _active_queue.size()) {
+                _active_queue.erase(
+                    _active_queue.begin(),
+                    _active_queue.begin() + static_cast<std::ptrdiff_t>(front));
+                front = 0;
+            }
+            for(std::size_t j = _first_out[u]; j < _first_out[u + 1]; ++j) {
+                const std::size_t h = _out[j];
+                const std::size_t w = head(h);
+                if(residual(h) > flow_t{0} && reduced_cost(h) < 0) {
+                    _pi[w] = _pi[u] + cost(h);
+                    if(!queued[w]) {
+                        queued[w] = 1;
+                        _active_queue.push_back(w);
+                    }
+                }
+            }
+        }
+    }
+
+public:
+    cost_scaling & run() {
+        if(_converged) return *this;
+        const std::size_t n = _vertices.size();
+        const std::size_t m = _arcs.size();
+        _converged = true;
+        _feasible = initialize();
+        if(!_feasible) return *this;
+
+        const large_cost_t scale = static_cast<large_cost_t>(n + 2);
+        large_cost_t eps = 1;
+        for(auto & c : _cost) {
+            c *= scale;
+            eps = std::max(eps, c < 0 ? -c : c);
+        }
+        _current_out.resize(n + 1);
+        for(;;) {
+            eps = std::max(large_cost_t{1}, eps / alpha);
+            refine(eps);
+            if(eps == 1) break;
+        }
+        compute_potentials(scale);
+
+        for(std::size_t i = 0; i < n; ++i) {
+            if(_flow[m + 2 * i] != flow_t{0} || _flow[m + 2 * i + 1] != flow_t{0})
+                _feasible = false;
+            _potential_map[_vertices[i]] =
+                static_cast<cost_t>(_pi[i] - _pi[n]);
+        }
+        for(std::size_t e = 0; e < m; ++e) _carried_flow_map[_arcs[e]] = _flow[e];
+        return *this;
+    }
+
+    // Precondition: run() has converged. False when no flow meets the
+    // supplies within the capacities -- flows and potentials then mean
+    // nothing.
+    [[nodiscard]] bool feasible() const noexcept {
+        assert(_converged);
+        return _feasible;
+    }
+
+    [[nodiscard]] large_cost_t total_cost() const {
+        assert(_converged);
+        large_cost_t sum = 0;
+        for(auto && a : _arcs)
+            sum += static_cast<large_cost_t>(_carried_flow_map[a]) *
+                   static_cast<large_cost_t>(_cost_map[a]);
+        return sum;
+    }
+
+    [[nodiscard]] constexpr flow_t flow(const arc & a) const
+        noexcept(noexcept(_carried_flow_map[a])) {
+        return _carried_flow_map[a];
+    }
+    // Refers into the algorithm, like every melon map view: valid while this
+    // object lives and stays put.
+    [[nodiscard]] constexpr auto flows_map() const & noexcept(
+        noexcept(maps::mapping_all(_carried_flow_map))) {
+        return maps::mapping_all(_carried_flow_map);
+    }
+    // Terminal, like std::move(alg).base(): the member left behind is valid but
+    // empty, so no other member may be called afterwards.
+    [[nodiscard]] constexpr auto flows_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_carried_flow_map)))) {
+        return maps::mapping_all(std::move(_carried_flow_map));
+    }
+
+    // Optimal dual values, as for network_simplex: the reduced cost
+    // cost(a) + potential(source) - potential(target) is non-negative on
+    // every arc below its capacity and non-positive on every arc with flow.
+    [[nodiscard]] constexpr cost_t potential(const vertex & v) const
+        noexcept(noexcept(_potential_map[v])) {
+        return _potential_map[v];
+    }
+    [[nodiscard]] constexpr auto potentials_map() const & noexcept(
+        noexcept(maps::mapping_all(_potential_map))) {
+        return maps::mapping_all(_potential_map);
+    }
+    [[nodiscard]] constexpr auto potentials_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_potential_map)))) {
+        return maps::mapping_all(std::move(_potential_map));
+    }
+};
+
+template <typename Graph, typename CapacityMap, typename CostMap,
+          typename SupplyMap>
+cost_scaling(Graph &&, CapacityMap &&, CostMap &&, SupplyMap &&)
+    -> cost_scaling<views::graph_all_t<Graph>,
+                    maps::mapping_all_t<CapacityMap>,
+                    maps::mapping_all_t<CostMap>,
+                    maps::mapping_all_t<SupplyMap>>;
+
+}  // namespace melon
@@ -3,12 +3,17 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <atomic>
 #include <limits>
+#include <optional>
 #include <ranges>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "melon/detail/borrowed_graph.hpp"
 #include "melon/detail/consumable_view.hpp"
+#include "melon/detail/thread_team.hpp"
 #include "melon/graph.hpp"
 #include "melon/mapping.hpp"
 
@@ -19,7 +24,8 @@ namespace melon {
 // blocking-flow search spin forever. Capacities must also be non-negative,
 // which no concept can check: a negative one lets an augmentation exceed the
 // capacity it is bounded by, so run() converges on a non-flow.
-// O(n^2 m), independent of the capacity values.
+// O(n^2 m), independent of the capacity values; with capacity scaling,
+// O(n m log U) for integral capacities bounded by U.
 template <graph_view Graph, mapping_view<arc_t<Graph>> CapacityMap>
     requires outward_incidence_graph<Graph> && inward_incidence_graph<Graph> &&
              has_vertex_map<Graph> && has_arc_map<Graph> &&
@@ -31,6 +37,14 @@ private:
     using arc = arc_t<Graph>;
     using value_t = mapped_value_t<CapacityMap, arc_t<Graph>>;
 
+    // The parallel BFS claims ranks with a compare-exchange through
+    // std::atomic_ref, and appends to a queue sized up front.
+    static constexpr bool can_rank_in_parallel =
+        has_num_vertices<Graph> &&
+        std::is_lvalue_reference_v<
+            mapped_reference_t<vertex_map_t<Graph, std::size_t>, vertex>>;
+    static constexpr std::size_t bfs_grain = 256;
+
 private:
     Graph _graph;
     CapacityMap _capacity_map;
@@ -42,6 +56,11 @@ private:
     bool _source_set;
     bool _target_set;
     bool _converged;
+    bool _capacity_scaling;
+    // Arcs with less residual capacity than this are ignored by the BFS and
+    // the blocking flow: the scaling phase's delta, zero outside of scaling.
+    value_t _scaling_threshold;
+    std::size_t _num_threads;
     arc_map_t<Graph, value_t> _carried_flow_map;
     std::vector<vertex> _bfs_queue;
     vertex_map_t<Graph, std::size_t> _vertex_rank_map;
@@ -49,6 +68,10 @@ private:
         _remaining_out_arcs;
     vertex_map_t<Graph, consumable_input_view_t<in_arcs_range_t<Graph>>>
         _remaining_in_arcs;
+    // The current source-rooted path of the blocking-flow search: the arcs
+    // taken, whether each is used forward, and the vertices they reach.
+    std::vector<std::pair<arc, bool>> _path;
+    std::vector<vertex> _path_vertices;
 
 public:
     // Leaves the terminals unset -- run(), flow_value() and minimum_cut() all
@@ -60,6 +83,9 @@ public:
         , _source_set(false)
         , _target_set(false)
         , _converged(false)
+        , _capacity_scaling(false)
+        , _scaling_threshold(0)
+        , _num_threads(1)
         , _carried_flow_map(create_arc_map<value_t>(_graph))
         , _vertex_rank_map(create_vertex_map<std::size_t>(_graph))
         , _remaining_out_arcs(
@@ -93,11 +119,16 @@ public:
         , _source_set(o._source_set)
         , _target_set(o._target_set)
         , _converged(o._converged)
+        , _capacity_scaling(o._capacity_scaling)
+        , _scaling_threshold(o._scaling_threshold)
+        , _num_threads(o._num_threads)
         , _carried_flow_map(std::move(o._carried_flow_map))
         , _bfs_queue(std::move(o._bfs_queue))
         , _vertex_rank_map(std::move(o._vertex_rank_map))
         , _remaining_out_arcs(std::move(o._remaining_out_arcs))
-        , _remaining_in_arcs(std::move(o._remaining_in_arcs)) {
+        , _remaining_in_arcs(std::move(o._remaining_in_arcs))
+        , _path(std::move(o._path))
+        , _path_vertices(std::move(o._path_vertices)) {
         _rebase_cursors();
     }
 
@@ -111,11 +142,16 @@ public:
         _source_set = o._source_set;
         _target_set = o._target_set;
         _converged = o._converged;
+        _capacity_scaling = o._capacity_scaling;
+        _scaling_threshold = o._scaling_threshold;
+        _num_threads = o._num_threads;
         _carried_flow_map = std::move(o._carried_flow_map);
         _bfs_queue = std::move(o._bfs_queue);
         _vertex_rank_map = std::move(o._vertex_rank_map);
         _remaining_out_arcs = std::move(o._remaining_out_arcs);
         _remaining_in_arcs = std::move(o._remaining_in_arcs);
+        _path = std::move(o._path);
+        _path_vertices = std::move(o._path_vertices);
         _rebase_cursors();
         return *this;
     }
@@ -158,6 +194,32 @@ public:
         return *this;
     }
 
+    // Off by default. Scaling runs the phases on the arcs with at least delta
+    // residual capacity, for delta halving from the largest power of two not
+    // above the largest capacity: far fewer phases when capacities span many
+    // orders of magnitude, a few more wasted BFS when they do not.
+    constexpr dinitz & set_capacity_scaling(const bool enabled)
+        requires std::integral<value_t>
+    {
+        _capacity_scaling = enabled;
+        return *this;
+    }
+
+    // Threads for the BFS that ranks the vertices at each phase; 1 by
+    // default. Only graphs with num_vertices and a vertex map of lvalues can
+    // be ranked in parallel -- for any other, the setting is ignored. The
+    // blocking flow itself stays sequential.
+    constexpr dinitz & set_num_threads(const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] constexpr std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
+    // Zeroes the flow. Not needed between runs on changed capacities: see
+    // update_capacity().
     constexpr dinitz & reset() {
         _converged = false;
         _carried_flow_map.fill(0);
@@ -169,6 +231,11 @@ public:
     }
 
 private:
+    [[nodiscard]] constexpr bool is_admissible(
+        const value_t & residual) const {
+        return residual > value_t{0} && !(residual < _scaling_threshold);
+    }
+
     bool bfs_rank_vertices() {
         _vertex_rank_map.fill(std::numeric_limits<std::size_t>::max());
         _vertex_rank_map[_t] = 0;
@@ -183,7 +250,7 @@ private:
                 const vertex v = arc_source(_graph, a);
                 if(_vertex_rank_map[v] !=
                        std::numeric_limits<std::size_t>::max() ||
-                   _capacity_map[a] == _carried_flow_map[a])
+                   !is_admissible(_capacity_map[a] - _carried_flow_map[a]))
                     continue;
                 _vertex_rank_map[v] = _vertex_rank_map[u] + 1;
                 _bfs_queue.push_back(v);
@@ -192,7 +259,7 @@ private:
                 const vertex v = arc_target(_graph, a);
                 if(_vertex_rank_map[v] !=
                        std::numeric_limits<std::size_t>::max() ||
-                   _carried_flow_map[a] == 0)
+                   !is_admissible(_carried_flow_map[a]))
                     continue;
                 _vertex_rank_map[v] = _vertex_rank_map[u] + 1;
                 _bfs_queue.push_back(v);
@@ -216,50 +283,299 @@ private:
         return _vertex_rank_map[_s] != std::numeric_limits<std::size_t>::max();
     }
 
-    // Recursive, one frame per level of the level graph, so the stack depth is
-    // bounded by the number of vertices: a graph carrying a very long
-    // augmenting path can overflow it. Every other traversal in melon is
-    // iterative and has no such bound.
-    value_t dfs_push_flow(const vertex u, const value_t max_incomming_flow) {
-        if(max_incomming_flow == 0 || u == _t) return max_incomming_flow;
+    // The same BFS, level-synchronous over the team: each level's frontier
+    // is split across the threads, and a vertex joins the next level through
+    // the thread whose compare-exchange claims its rank first. The queue ends
+    // up holding every ranked vertex, level by level, as the sequential BFS
+    // leaves it.
+    bool parallel_bfs_rank_vertices(detail::thread_team & team)
+        requires can_rank_in_parallel
+    {
+        constexpr std::size_t unranked = std::numeric_limits<std::size_t>::max();
+        _vertex_rank_map.fill(unranked);
+        _vertex_rank_map[_t] = 0;
+        _bfs_queue.resize(num_vertices(_graph));
+        _bfs_queue[0] = _t;
+        std::size_t level_begin = 0;
+        std::size_t level_end = 1;
+        while(level_begin < level_end) {
+            std::atomic<std::size_t> next_end{level_end};
+            const auto claim = [&](const vertex & v, const std::size_t rank) {
+                std::size_t expected = unranked;
+                if(!std::atomic_ref<std::size_t>(_vertex_rank_map[v])
+                        .compare_exchange_strong(expected, rank))
+                    return;
+                _bfs_queue[next_end.fetch_add(1)] = v;
+            };
+            detail::parallel_for(
+                team, level_end - level_begin, bfs_grain,
+                [&](std::size_t first, const std::size_t last, std::size_t) {
+                    for(; first < last; ++first) {
+                        const vertex u = _bfs_queue[level_begin + first];
+                        const std::size_t rank = _vertex_rank_map[u] + 1;
+                        for(auto && a : in_arcs(_graph, u)) {
+                            if(!is_admissible(_capacity_map[a] -
+                                              _carried_flow_map[a]))
+                                continue;
+                            claim(arc_source(_graph, a), rank);
+                        }
+                        for(auto && a : out_arcs(_graph, u)) {
+                            if(!is_admissible(_carried_flow_map[a])) continue;
+                            claim(arc_target(_graph, a), rank);
+                        }
+                    }
+                });
+            level_begin = level_end;
+            level_end = next_end.load();
+        }
+        _bfs_queue.resize(level_end);
+        return _vertex_rank_map[_s] != unranked;
+    }
+
+    // Finds the next admissible arc out of u in the level graph, skipping
+    // past the ones that are not: on return, the current arc of u's cursor
+    // is the one taken -- out-arcs first, then in-arcs.
+    bool advance_to_admissible_arc(const vertex & u, arc & a, bool & forward,
+                                   vertex & v) {
         for(; !_remaining_out_arcs[u].empty();
             _remaining_out_arcs[u].advance()) {
-            const arc & a = _remaining_out_arcs[u].current();
-            const vertex v = arc_target(_graph, a);
+            a = _remaining_out_arcs[u].current();
+            v = arc_target(_graph, a);
             if(_vertex_rank_map[v] + 1 != _vertex_rank_map[u]) continue;
-            if(_capacity_map[a] == _carried_flow_map[a]) continue;
-            const value_t pushed_flow = dfs_push_flow(
-                v, std::min(max_incomming_flow,
-                            _capacity_map[a] - _carried_flow_map[a]));
-            if(pushed_flow == 0) continue;
-            _carried_flow_map[a] += pushed_flow;
-            return pushed_flow;
+            if(!is_admissible(_capacity_map[a] - _carried_flow_map[a]))
+                continue;
+            forward = true;
+            return true;
         }
         for(; !_remaining_in_arcs[u].empty(); _remaining_in_arcs[u].advance()) {
-            const arc & a = _remaining_in_arcs[u].current();
-            const vertex v = arc_source(_graph, a);
+            a = _remaining_in_arcs[u].current();
+            v = arc_source(_graph, a);
             if(_vertex_rank_map[v] + 1 != _vertex_rank_map[u]) continue;
-            if(_carried_flow_map[a] == 0) continue;
-            const value_t pushed_flow = dfs_push_flow(
-                v, std::min(max_incomming_flow, _carried_flow_map[a]));
-            if(pushed_flow == 0) continue;
-            _carried_flow_map[a] -= pushed_flow;
-            return pushed_flow;
+            if(!is_admissible(_carried_flow_map[a])) continue;
+            forward = false;
+            return true;
         }
-        return value_t{0};
+        return false;
     }
 
-public:
-    constexpr dinitz & run() {
-        assert(_source_set && _target_set);
-        while(bfs_rank_vertices()) {
+    [[nodiscard]] constexpr value_t residual(const arc & a,
+                                             const bool forward) const {
+        return forward ? _capacity_map[a] - _carried_flow_map[a]
+                       : _carried_flow_map[a];
+    }
+
+    // A blocking flow of the level graph, by an iterative search with an
+    // explicit path. After an augmentation the search retreats only to the
+    // tail of the first arc it saturated and carries on from there, so the
+    // prefix from the source is walked once per branch rather than once per
+    // path; a dead end retreats by one arc and retires it from the cursor of
+    // its tail.
+    void push_blocking_flow() {
+        _path.clear();
+        _path_vertices.assign(1, _s);
+        for(;;) {
+            const vertex u = _path_vertices.back();
+            if(u == _t) {
+                if(_path.empty()) return;  // _s == _t
+                value_t delta = residual(_path[0].first, _path[0].second);
+                for(auto && [a, forward] : _path)
+                    delta = std::min(delta, residual(a, forward));
+                std::size_t retreat_to = _path.size();
+                for(std::size_t i = 0; i < _path.size(); ++i) {
+                    auto && [a, forward] = _path[i];
+                    if(forward)
+                        _carried_flow_map[a] += delta;
+                    else
+                        _carried_flow_map[a] -= delta;
+                    if(retreat_to == _path.size() &&
+                       !is_admissible(residual(a, forward)))
+                        retreat_to = i;
+                }
+                _path.resize(retreat_to);
+                _path_vertices.resize(retreat_to + 1);
+                continue;
+            }
+            arc a{};
+            bool forward = true;
+            vertex v{};
+            if(advance_to_admissible_arc(u, a, forward, v)) {
+                _path.emplace_back(a, forward);
+                _path_vertices.push_back(v);
+                continue;
+            }
+            if(_path.empty()) return;
+            _path.pop_back();
+            _path_vertices.pop_back();
+            const vertex & tail = _path_vertices.back();
+            if(!_remaining_out_arcs[tail].empty())
+                _remaining_out_arcs[tail].advance();
+            else
+                _remaining_in_arcs[tail].advance();
+        }
+    }
+
+    // Whether the repair may add flow to `a`. It never sends flow into the
+    // source or out of the target, which would otherwise still conserve but
+    // escape flow_value()'s sum over the source's out-arcs.
+    [[nodiscard]] constexpr bool can_repair_forward(const arc & a) const {
+        return arc_target(_graph, a) != _s && arc_source(_graph, a) != _t;
+    }
+
+    // Moves up to `amount` units from `from` to `to` along residual paths,
+    // each found by a BFS backward from `to` and followed greedily down the
+    // ranks until an arc it needs has been saturated. Returns the amount
+    // moved; `from` is left with that much less excess and `to` with that
+    // much more.
+    value_t reroute(const vertex & from, const vertex & to, value_t amount) {
+        constexpr std::size_t unranked = std::numeric_limits<std::size_t>::max();
+        value_t moved{0};
+        while(moved < amount) {
+            _vertex_rank_map.fill(unranked);
+            _vertex_rank_map[to] = 0;
+            _bfs_queue.resize(0);
+            _bfs_queue.push_back(to);
+            for(std::size_t i = 0; i < _bfs_queue.size() &&
+                                   _vertex_rank_map[from] == unranked;
+                ++i) {
+                const vertex u = _bfs_queue[i];
+                for(auto && a : in_arcs(_graph, u)) {
+                    const vertex v = arc_source(_graph, a);
+                    if(_vertex_rank_map[v] != unranked ||
+                       !can_repair_forward(a) ||
+                       !(residual(a, true) > value_t{0}))
+                        continue;
+                    _vertex_rank_map[v] = _vertex_rank_map[u] + 1;
+                    _bfs_queue.push_back(v);
+                }
+                for(auto && a : out_arcs(_graph, u)) {
+                    const vertex v = arc_target(_graph, a);
+                    if(_vertex_rank_map[v] != unranked ||
+                       !(residual(a, false) > value_t{0}))
+                        continue;
+                    _vertex_rank_map[v] = _vertex_rank_map[u] + 1;
+                    _bfs_queue.push_back(v);
+                }
+            }
+            if(_vertex_rank_map[from] == unranked) break;
+
+            for(;;) {  // walk down the ranks while the paths last
+                _path.clear();
+                vertex u = from;
+                while(u != to) {
+                    bool found = false;
+                    for(auto && a : out_arcs(_graph, u)) {
+                        const vertex v = arc_target(_graph, a);
+                        if(_vertex_rank_map[v] + 1 != _vertex_rank_map[u] ||
+                           !can_repair_forward(a) ||
+                       !(residual(a, true) > value_t{0}))
+                            continue;
+                        _path.emplace_back(a, true);
+                        u = v;
+                        found = true;
+                        break;
+                    }
+                    if(found) continue;
+                    for(auto && a : in_arcs(_graph, u)) {
+                        const vertex v = arc_source(_graph, a);
+                        if(_vertex_rank_map[v] + 1 != _vertex_rank_map[u] ||
+                           !(residual(a, false) > value_t{0}))
+                            continue;
+                        _path.emplace_back(a, false);
+                        u = v;
+                        found = true;
+                        break;
+                    }
+                    if(!found) break;
+                }
+                if(u != to) break;
+                value_t delta = amount - moved;
+                for(auto && [a, forward] : _path)
+                    delta = std::min(delta, residual(a, forward));
+                for(auto && [a, forward] : _path) {
+                    if(forward)
+                        _carried_flow_map[a] += delta;
+                    else
+                        _carried_flow_map[a] -= delta;
+                }
+                moved += delta;
+                if(!(moved < amount)) break;
+            }
+        }
+        return moved;
+    }
+
+    bool rank_vertices(detail::thread_team * team) {
+        if constexpr(can_rank_in_parallel) {
+            if(team != nullptr) return parallel_bfs_rank_vertices(*team);
+        }
+        return bfs_rank_vertices();
+    }
+
+    void run_phases(detail::thread_team * team) {
+        while(rank_vertices(team)) {
             for(auto && u : vertices(_graph)) {
                 _remaining_out_arcs[u] = out_arcs(_graph, u);
                 _remaining_in_arcs[u] = in_arcs(_graph, u);
             }
-            while(dfs_push_flow(_s, std::numeric_limits<value_t>::max()) >
-                  value_t{0});
+            push_blocking_flow();
+        }
+    }
+
+public:
+    // Warm start: call this after changing capacity(a) in the capacity map
+    // the algorithm reads, and the next run() resumes from the current flow
+    // instead of recomputing it after a reset(). A raised capacity needs
+    // nothing more than the augmentations run() will find. A capacity
+    // lowered below the flow is repaired on the spot: the arc is cut back,
+    // the surplus is rerouted around it from its tail to its head where the
+    // residual network allows, and what remains is sent back from the tail
+    // to the source and from the target to the head -- touching only the
+    // paths through the arc. flow() and flows_map() then read a valid flow
+    // again, of a value no higher than the new maximum.
+    //
+    // Precondition: both terminals are set.
+    dinitz & update_capacity(const arc & a) {
+        assert(_source_set && _target_set);
+        _converged = false;
+        const value_t capacity = _capacity_map[a];
+        if(!(capacity < _carried_flow_map[a])) return *this;
+        const value_t surplus = _carried_flow_map[a] - capacity;
+        _carried_flow_map[a] = capacity;
+        const vertex u = arc_source(_graph, a);
+        const vertex v = arc_target(_graph, a);
+        if(u == v) return *this;
+        const value_t left = surplus - reroute(u, v, surplus);
+        if(!(left > value_t{0})) return *this;
+        // Both always move all of it: the surplus reached u along flow paths
+        // from the source, and left v along flow paths to the target.
+        if(u != _s && u != _t) reroute(u, _s, left);
+        if(v != _s && v != _t) reroute(_t, v, left);
+        return *this;
+    }
+
+    constexpr dinitz & run() {
+        assert(_source_set && _target_set);
+        std::optional<detail::thread_team> team;
+        if constexpr(can_rank_in_parallel) {
+            if(_num_threads > 1) team.emplace(_num_threads);
+        }
+        detail::thread_team * const team_ptr = team ? &*team : nullptr;
+        if constexpr(std::integral<value_t>) {
+            if(_capacity_scaling) {
+                value_t max_capacity{0};
+                for(auto && a : arcs(_graph))
+                    max_capacity = std::max(max_capacity, _capacity_map[a]);
+                for(_scaling_threshold = value_t{1};
+                    _scaling_threshold <= max_capacity / 2;)
+                    _scaling_threshold *= 2;
+                for(; _scaling_threshold > value_t{1}; _scaling_threshold /= 2)
+                    run_phases(team_ptr);
+            }
         }
+        // The last phase, delta = 1, is the unscaled algorithm; it also
+        // leaves the final, failed BFS that minimum_cut() reads.
+        _scaling_threshold = value_t{0};
+        run_phases(team_ptr);
         _converged = true;
         return *this;
     }
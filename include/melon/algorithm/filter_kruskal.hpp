@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "melon/container/concurrent_disjoint_sets.hpp"
+#include "melon/detail/parallel_partition.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/undirected_graph.hpp"
+#include "melon/utility/algorithmic_generator.hpp"
+
+namespace melon {
+
+// Osipov, Sanders and Singler's Filter-Kruskal: the edges of kruskal, in the
+// same increasing cost order, without sorting them all up front. The edge list
+// is split around a random pivot cost, quicksort style, and only the lightest
+// part is split further; the heavier parts wait on a stack. Whenever one is
+// taken back, the edges whose endpoints the lighter ones already connected are
+// filtered out first, in the same pass as the split. On graphs where the
+// spanning forest is found among the light edges -- dense ones, geometric ones
+// -- most of the heavy edges are thrown away unsorted. Parts of at most
+// `base_case_size` edges are sorted outright.
+//
+// The split and the filter are stable partitions, run in chunks across
+// threads on parts of at least `parallel_cutoff` edges; the filter's finds go
+// to a concurrent_disjoint_sets, which is what lets them run concurrently. The
+// order of the edges yielded is the same for any number of threads.
+template <undirected_graph_view UGraph, mapping_view<edge_t<UGraph>> CostMap>
+    requires has_vertex_map<UGraph> &&
+             std::totally_ordered<mapped_value_t<CostMap, edge_t<UGraph>>>
+class filter_kruskal
+    : public algorithm_view_interface<filter_kruskal<UGraph, CostMap>> {
+private:
+    using vertex = vertex_t<UGraph>;
+    using edge = edge_t<UGraph>;
+    using cost_type = mapped_value_t<CostMap, edge>;
+
+    static constexpr std::size_t base_case_size = 1024;
+    static constexpr std::size_t parallel_cutoff = std::size_t{1} << 16;
+
+    // The cost and the endpoint positions are read once, in reset(), not at
+    // every pass over the edge.
+    struct edge_entry {
+        edge e;
+        cost_type cost;
+        std::size_t source;
+        std::size_t target;
+    };
+    struct segment {
+        std::size_t first;
+        std::size_t last;
+        bool sorted;
+    };
+
+private:
+    UGraph _ugraph;
+    CostMap _cost_map;
+    std::size_t _num_threads;
+    std::vector<edge_entry> _entries;
+    std::vector<edge_entry> _scratch;
+    std::vector<unsigned char> _classes;
+    // the parts not taken yet, the lightest on top
+    std::vector<segment> _segments;
+    // the sorted run being scanned, _cursor at the current edge
+    std::size_t _cursor;
+    std::size_t _run_end;
+    concurrent_disjoint_sets<std::size_t> _components_sets;
+    std::size_t _num_tree_edges;
+    std::minstd_rand _engine;
+
+public:
+    template <undirected_graph_for<UGraph> UG, mapping_for<CostMap> CM>
+    filter_kruskal(UG && ug, CM && cm)
+        : _ugraph(views::undirected_graph_all(std::forward<UG>(ug)))
+        , _cost_map(maps::mapping_all(std::forward<CM>(cm)))
+        , _num_threads(detail::default_num_threads()) {
+        reset();
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    // The cursors are indices, so the moves stay defaulted.
+    filter_kruskal(const filter_kruskal &) = delete;
+    filter_kruskal(filter_kruskal &&) = default;
+
+    filter_kruskal & operator=(const filter_kruskal &) = delete;
+    filter_kruskal & operator=(filter_kruskal &&) = default;
+
+    [[nodiscard]] constexpr UGraph & base() & noexcept { return _ugraph; }
+    [[nodiscard]] constexpr const UGraph & base() const & noexcept {
+        return _ugraph;
+    }
+    [[nodiscard]] constexpr UGraph && base() && noexcept {
+        return std::move(_ugraph);
+    }
+    [[nodiscard]] constexpr const UGraph && base() const && noexcept {
+        return std::move(_ugraph);
+    }
+
+    // std::thread::hardware_concurrency() by default. The constructor has
+    // already taken the first edge with it; the count applies from there on.
+    filter_kruskal & set_num_threads(const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
+private:
+    // A stable partition of [first, last), see detail::stable_partition;
+    // chunked across threads from parallel_cutoff edges.
+    template <std::size_t K, typename Classify>
+    std::array<std::size_t, K + 1> partition(const std::size_t first,
+                                             const std::size_t last,
+                                             Classify && classify) {
+        const std::size_t size = last - first;
+        std::optional<detail::thread_team> team;
+        if(size >= parallel_cutoff && _num_threads > 1)
+            team.emplace(_num_threads);
+        auto bounds = detail::stable_partition<K>(
+            team ? &*team : nullptr,
+            std::span(_entries).subspan(first, size),
+            std::span(_scratch).subspan(first, size),
+            std::span(_classes).subspan(first, size),
+            std::forward<Classify>(classify));
+        for(auto && b : bounds) b += first;
+        return bounds;
+    }
+
+    [[nodiscard]] bool connected(const edge_entry & entry) {
+        return _components_sets.find(entry.source) ==
+               _components_sets.find(entry.target);
+    }
+
+    // Takes the lightest part off the stack: filtered and sorted, it becomes
+    // the run; filtered and split, it goes back as three parts.
+    void take_segment() {
+        const segment s = _segments.back();
+        _segments.pop_back();
+        if(s.sorted || s.last - s.first <= base_case_size) {
+            const auto bounds = partition<1>(
+                s.first, s.last, [this](const edge_entry & entry) {
+                    return connected(entry) ? std::size_t{1} : std::size_t{0};
+                });
+            _cursor = s.first;
+            _run_end = bounds[1];
+            if(!s.sorted)
+                std::sort(
+                    _entries.begin() + static_cast<std::ptrdiff_t>(_cursor),
+                    _entries.begin() + static_cast<std::ptrdiff_t>(_run_end),
+                    [](const edge_entry & a, const edge_entry & b) {
+                        return a.cost < b.cost;
+                    });
+            return;
+        }
+
+        // the median of three random costs
+        std::uniform_int_distribution<std::size_t> pick(s.first, s.last - 1);
+        std::array<cost_type, 3> samples = {_entries[pick(_engine)].cost,
+                                            _entries[pick(_engine)].cost,
+                                            _entries[pick(_engine)].cost};
+        std::ranges::sort(samples);
+        const cost_type pivot = samples[1];
+        const auto bounds = partition<3>(
+            s.first, s.last, [this, &pivot](const edge_entry & entry) {
+                if(connected(entry)) return std::size_t{3};
+                if(entry.cost < pivot) return std::size_t{0};
+                return pivot < entry.cost ? std::size_t{2} : std::size_t{1};
+            });
+        if(bounds[2] < bounds[3])
+            _segments.push_back({bounds[2], bounds[3], false});
+        if(bounds[1] < bounds[2])
+            _segments.push_back({bounds[1], bounds[2], true});
+        if(bounds[0] < bounds[1])
+            _segments.push_back({bounds[0], bounds[1], false});
+        _cursor = _run_end = s.first;
+    }
+
+    // Moves _cursor to the next edge joining two trees, or finishes.
+    void seek() {
+        for(;;) {
+            if(_num_tree_edges + 1 >= _components_sets.size()) break;
+            for(; _cursor < _run_end; ++_cursor) {
+                const edge_entry & entry = _entries[_cursor];
+                if(_components_sets.unite(entry.source, entry.target)) {
+                    ++_num_tree_edges;
+                    return;
+                }
+            }
+            if(_segments.empty()) break;
+            take_segment();
+        }
+        // once the tree spans every vertex, whatever is left is filtered
+        _segments.clear();
+        _cursor = _run_end;
+    }
+
+public:
+    // Not noexcept: it refills and re-seeds, which allocate, and runs the
+    // user's cost map.
+    filter_kruskal & reset() {
+        auto position_map = create_vertex_map<std::size_t>(_ugraph);
+        std::size_t num_vertices = 0;
+        for(auto && v : vertices(_ugraph)) position_map[v] = num_vertices++;
+        _components_sets.resize(num_vertices);
+        _num_tree_edges = 0;
+
+        _entries.resize(0);
+        if constexpr(has_num_edges<UGraph>) {
+            _entries.reserve(num_edges(_ugraph));
+        }
+        for(auto && e : edges(_ugraph)) {
+            auto && [u, v] = edge_endpoints(_ugraph, e);
+            _entries.push_back(
+                {e, _cost_map[e], position_map[u], position_map[v]});
+        }
+        _scratch.resize(_entries.size());
+        _classes.resize(_entries.size());
+        _engine.seed(std::minstd_rand::default_seed);
+
+        _segments.assign(1, {0, _entries.size(), false});
+        _cursor = _run_end = 0;
+        seek();
+        return *this;
+    }
+
+    [[nodiscard]] bool finished() const noexcept { return _cursor == _run_end; }
+
+    [[nodiscard]] edge current() const noexcept {
+        assert(!finished());
+        return _entries[_cursor].e;
+    }
+
+    void advance() {
+        assert(!finished());
+        ++_cursor;
+        seek();
+    }
+};
+
+template <typename UGraph, typename CostMap>
+filter_kruskal(UGraph &&, CostMap &&)
+    -> filter_kruskal<views::undirected_graph_all_t<UGraph>,
+                      maps::mapping_all_t<CostMap>>;
+
+}  // namespace melon
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <chrono>
 #include <cstddef>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <ranges>
 #include <thread>
@@ -13,6 +16,8 @@
 #include <vector>
 
 #include "melon/detail/stdlib_check.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/detail/work_stealing_deques.hpp"
 #include "melon/mapping.hpp"
 
 namespace melon {
@@ -48,6 +53,16 @@ private:
     std::vector<std::ranges::iterator_t<const ItemRange>> _permuted_items;
     std::vector<std::pair<Value, Cost>> _value_cost_pairs;
     std::vector<typename decltype(_value_cost_pairs)::const_iterator> _best_sol;
+    std::size_t _num_threads;
+
+    using pair_iterator = typename decltype(_value_cost_pairs)::const_iterator;
+    // The nodes of the search tree where the first items, up to a common
+    // depth, are decided: `taken` are those in.
+    struct subtree {
+        std::vector<pair_iterator> taken;
+        Value value;
+        Cost budget_left;
+    };
 
 private:
     double value_cost_ratio(const std::pair<Value, Cost> & p) const {
@@ -137,6 +152,103 @@ private:
         return current_sol.empty();
     }
 
+    // The subtrees at the shallowest depth with at least num_subtrees of
+    // them, or all the items decided, in the order iterative_bnb() visits
+    // them: the one taking an item before the one leaving it out.
+    std::vector<subtree> split(const std::size_t num_subtrees,
+                               std::size_t & depth) const {
+        std::vector<subtree> subtrees(1, subtree{{}, Value{0}, _budget});
+        std::vector<subtree> children;
+        for(depth = 0; depth < _value_cost_pairs.size() &&
+                       subtrees.size() < num_subtrees;
+            ++depth) {
+            const auto it = _value_cost_pairs.cbegin() +
+                            static_cast<std::ptrdiff_t>(depth);
+            children.resize(0);
+            for(subtree & s : subtrees) {
+                if(it->second <= s.budget_left) {
+                    subtree & in = children.emplace_back(s);
+                    in.taken.push_back(it);
+                    in.value += it->first;
+                    in.budget_left -= it->second;
+                }
+                children.push_back(std::move(s));
+            }
+            subtrees.swap(children);
+        }
+        return subtrees;
+    }
+
+    // iterative_bnb() on the subtrees of split(), from the threads of a team
+    // taking them through work-stealing deques. The incumbent is shared as its
+    // value and the number of the subtree it was found in, the subtrees being
+    // numbered in the serial order: a bound or a solution value improves on it
+    // if it is higher, or equal and from an earlier subtree. Every node that
+    // cannot improve is pruned, so the threads prune against the global
+    // incumbent, and the first optimal solution in the serial order is never
+    // pruned nor replaced -- it is the solution iterative_bnb() finds.
+    void parallel_bnb() {
+        _best_sol.resize(0);
+        const auto end = _value_cost_pairs.cend();
+        std::size_t depth;
+        std::vector<subtree> subtrees = split(64 * _num_threads, depth);
+        // Stored under best_mutex, the subtree before the value, and loaded
+        // the value first: whatever subtree is loaded is that of the value
+        // loaded or of a later incumbent, of a value at least as high.
+        std::atomic<Value> best_value{Value{0}};
+        std::atomic<std::size_t> best_subtree{0};
+        std::mutex best_mutex;
+        auto improves = [&](const auto x, const std::size_t k) {
+            const Value v = best_value.load(std::memory_order_acquire);
+            return x > v || (!(x < v) &&
+                             k < best_subtree.load(std::memory_order_relaxed));
+        };
+        auto search = [&](const std::size_t k,
+                          std::vector<pair_iterator> & current_sol) {
+            current_sol = std::move(subtrees[k].taken);
+            const std::size_t root_size = current_sol.size();
+            Value current_sol_value = subtrees[k].value;
+            Cost budget_left = subtrees[k].budget_left;
+            auto it = _value_cost_pairs.cbegin() +
+                      static_cast<std::ptrdiff_t>(depth);
+            for(;;) {
+                for(; it < end; ++it) {
+                    if(budget_left < it->second) continue;
+                    if(!improves(computeUpperBound(it, end, current_sol_value,
+                                                   budget_left),
+                                 k))
+                        goto backtrack;
+                    current_sol_value += it->first;
+                    budget_left -= it->second;
+                    current_sol.push_back(it);
+                }
+                if(improves(current_sol_value, k)) {
+                    std::lock_guard lock(best_mutex);
+                    if(improves(current_sol_value, k)) {
+                        _best_sol = current_sol;
+                        best_subtree.store(k, std::memory_order_relaxed);
+                        best_value.store(current_sol_value,
+                                         std::memory_order_release);
+                    }
+                }
+            backtrack:
+                if(current_sol.size() == root_size) return;
+                it = current_sol.back();
+                current_sol_value -= it->first;
+                budget_left += it->second;
+                current_sol.pop_back();
+                ++it;
+            }
+        };
+        detail::work_stealing_deques deques(subtrees.size(), _num_threads);
+        detail::thread_team team(_num_threads);
+        auto job = [&](const std::size_t i) {
+            std::vector<pair_iterator> current_sol;
+            while(const auto k = deques.pop(i)) search(*k, current_sol);
+        };
+        team.run(job);
+    }
+
 public:
     // Constrained on what the mem-initializers actually do, so
     // std::is_constructible answers what construction actually does instead of
@@ -149,7 +261,8 @@ public:
         : _items_range(std::views::all(std::forward<IR>(items_range)))
         , _value_map(maps::mapping_all(std::forward<VM>(value_map)))
         , _cost_map(maps::mapping_all(std::forward<CM>(cost_map)))
-        , _budget(std::forward<B>(budget)) {
+        , _budget(std::forward<B>(budget))
+        , _num_threads(1) {
         reset();
     }
 
@@ -199,8 +312,23 @@ public:
         return reset();
     }
 
+    // Threads for run(); 1 by default. With more, the search tree is split
+    // into a few tens of subtrees per thread, searched in parallel, and the
+    // solution is still the one found with 1. run_with_timeout() is serial.
+    knapsack_bnb & set_num_threads(const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
     knapsack_bnb & run() {
-        iterative_bnb();
+        if(_num_threads > 1)
+            parallel_bnb();
+        else
+            iterative_bnb();
         return *this;
     }
 
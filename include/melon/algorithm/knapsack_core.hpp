@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "melon/detail/stdlib_check.hpp"
+#include "melon/mapping.hpp"
+#include "melon/numeric/adaptive_integer.hpp"
+
+namespace melon {
+
+// Pisinger's expanding-core algorithm (minknap): the items are sorted by
+// value/cost ratio, and the greedy solution -- every item before the break
+// item, the first one that does not fit -- is optimal but for a few items
+// around the break item, the core. The core [s, t) starts empty at the break
+// item and grows one item at each end in turn. The states are the distinct
+// ways of choosing the core items, every item before s taken and every item
+// from t on left out; each is a (value, cost) pair, and a state of higher
+// cost and no higher value is dominated and dropped. Adding item t to the core
+// merges the states with their copies that take it, and adding item s - 1 the
+// states with their copies that leave it out. A state over the budget stays,
+// as leaving items out may bring it back under.
+// Each state is bounded by the fractional relaxation of the items outside the
+// core: under the budget, filling what is left at the ratio of item t; over
+// it, removing the excess at the ratio of item s - 1. A state whose bound
+// does not beat the best solution found so far is dropped, and the algorithm
+// stops when no state is left. An item that cannot be part of a better
+// solution, by the same kind of bound taken from the greedy solution, is
+// left out of the core altogether. On strongly correlated instances, where
+// branch-and-bound explores exponentially many nodes, the core keeps a few
+// percent of the items and the states some tens of thousands.
+// The bounds compare exactly, with cross-multiplications in
+// numeric::adaptive_integer, hence integral values and costs. Each state
+// keeps the chain of core decisions that led to it, so the solution is
+// replayed from the best state's chain.
+//
+// Same preconditions as knapsack_bnb: non-negative values, costs and budget.
+template <std::ranges::random_access_range ItemRange,
+          mapping_view<std::ranges::range_value_t<ItemRange>> ValueMap,
+          mapping_view<std::ranges::range_value_t<ItemRange>> CostMap>
+    requires std::integral<mapped_value_t<
+                 ValueMap, std::ranges::range_value_t<ItemRange>>> &&
+             std::integral<
+                 mapped_value_t<CostMap, std::ranges::range_value_t<ItemRange>>>
+class knapsack_core {
+private:
+    using Item = std::ranges::range_value_t<ItemRange>;
+    using Value = mapped_value_t<ValueMap, Item>;
+    using Cost = mapped_value_t<CostMap, Item>;
+
+    static constexpr std::size_t no_decision =
+        std::numeric_limits<std::size_t>::max();
+
+    struct state {
+        Value value;
+        Cost cost;
+        // the last decision on the core items that led here, in _decisions
+        std::size_t decision;
+    };
+    // item toggles from the greedy solution, linked from the last one
+    struct decision {
+        std::size_t item;
+        std::size_t previous;
+    };
+
+    ItemRange _items_range;
+    ValueMap _value_map;
+    CostMap _cost_map;
+
+    Cost _budget;
+    std::vector<std::ranges::iterator_t<const ItemRange>> _permuted_items;
+    std::vector<std::pair<Value, Cost>> _value_cost_pairs;
+    // indices into _value_cost_pairs
+    std::vector<std::size_t> _solution;
+
+    std::vector<state> _states;
+    std::vector<state> _next_states;
+    std::vector<decision> _decisions;
+    Value _best_value;
+    std::size_t _best_decision;
+
+private:
+    [[nodiscard]] static numeric::adaptive_integer wide(const auto v) {
+        return numeric::adaptive_integer(v);
+    }
+
+    // Merges the states with their copies shifted by (value, cost), which
+    // toggle item, into _next_states, sorted by cost and with strictly
+    // increasing values. The shift keeps the copies sorted by cost. A removal
+    // shifts by the negated pair, which wraps around for unsigned types and
+    // comes back once added: every state takes the item removed.
+    void merge_with_shifted(const std::size_t item, const Value value,
+                            const Cost cost) {
+        _next_states.resize(0);
+        auto keep = [this](const state & s) {
+            if(!_next_states.empty() && s.value <= _next_states.back().value)
+                return;
+            if(!_next_states.empty() && s.cost == _next_states.back().cost)
+                _next_states.pop_back();
+            _next_states.push_back(s);
+        };
+        auto shifted = [&](const state & s) {
+            return state{static_cast<Value>(s.value + value),
+                         static_cast<Cost>(s.cost + cost), s.decision};
+        };
+        auto keep_shifted = [&](const state & s) {
+            if(!_next_states.empty() && s.value <= _next_states.back().value)
+                return;
+            _decisions.push_back(decision{item, s.decision});
+            keep(state{s.value, s.cost, _decisions.size() - 1});
+            if(s.cost <= _budget && s.value > _best_value) {
+                _best_value = s.value;
+                _best_decision = _next_states.back().decision;
+            }
+        };
+        auto a = _states.cbegin();
+        auto b = _states.cbegin();
+        const auto end = _states.cend();
+        while(a != end || b != end) {
+            if(b == end) {
+                keep(*a++);
+                continue;
+            }
+            const state sb = shifted(*b);
+            // on a tie in cost, the higher value first: the other is dominated
+            if(a != end && (a->cost < sb.cost ||
+                            (a->cost == sb.cost && a->value >= sb.value))) {
+                keep(*a++);
+            } else {
+                keep_shifted(sb);
+                ++b;
+            }
+        }
+        _states.swap(_next_states);
+    }
+
+    // Drops the states whose fractional bound does not beat _best_value, the
+    // items outside the core [s, t) being free.
+    void prune(const std::size_t s, const std::size_t t) {
+        const std::size_t num_items = _value_cost_pairs.size();
+        std::erase_if(_states, [&](const state & st) {
+            if(st.cost <= _budget) {
+                if(t == num_items) return true;  // nothing left to add
+                const auto & [v, c] = _value_cost_pairs[t];
+                // value + (budget - cost) v / c > best
+                return (wide(st.value) - wide(_best_value)) * c +
+                           wide(_budget - st.cost) * v <=
+                       0;
+            }
+            if(s == 0) return true;  // nothing left to remove
+            const auto & [v, c] = _value_cost_pairs[s - 1];
+            // value - (cost - budget) v / c > best
+            return wide(st.value) * c - wide(st.cost - _budget) * v <=
+                   wide(_best_value) * c;
+        });
+    }
+
+public:
+    template <std::ranges::viewable_range IR, mapping_for<ValueMap> VM,
+              mapping_for<CostMap> CM, std::convertible_to<Cost> B>
+        requires std::constructible_from<ItemRange, std::views::all_t<IR>>
+    knapsack_core(IR && items_range, VM && value_map, CM && cost_map,
+                  B && budget)
+        : _items_range(std::views::all(std::forward<IR>(items_range)))
+        , _value_map(maps::mapping_all(std::forward<VM>(value_map)))
+        , _cost_map(maps::mapping_all(std::forward<CM>(cost_map)))
+        , _budget(std::forward<B>(budget))
+        , _best_value(0)
+        , _best_decision(no_decision) {
+        reset();
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    knapsack_core(const knapsack_core &) = delete;
+    knapsack_core(knapsack_core &&) = default;
+
+    knapsack_core & operator=(const knapsack_core &) = delete;
+    knapsack_core & operator=(knapsack_core &&) = default;
+
+    knapsack_core & reset() {
+        _permuted_items.resize(0);
+        _value_cost_pairs.resize(0);
+        _solution.resize(0);
+        if constexpr(std::ranges::sized_range<ItemRange>) {
+            auto num_items = std::ranges::size(_items_range);
+            _permuted_items.reserve(num_items);
+            _value_cost_pairs.reserve(num_items);
+        }
+        for(auto it = _items_range.begin(); it != _items_range.end(); ++it) {
+            const auto & i = *it;
+            const Value value = _value_map[i];
+            if(value == static_cast<Value>(0)) continue;
+            const Cost cost = _cost_map[i];
+            if(cost > _budget) continue;
+            _permuted_items.emplace_back(it);
+            _value_cost_pairs.emplace_back(value, cost);
+        }
+        // by decreasing ratio, compared exactly: the bounds in prune() are
+        // only sound if no item outside the core beats the ratio they use
+        auto zip_view = std::views::zip(_permuted_items, _value_cost_pairs);
+        std::ranges::sort(zip_view, [](auto p1, auto p2) {
+            const auto & [v1, c1] = std::get<1>(p1);
+            const auto & [v2, c2] = std::get<1>(p2);
+            return wide(v1) * c2 > wide(v2) * c1;
+        });
+        return *this;
+    }
+
+    // Through reset(), as knapsack_bnb::set_budget: the item filter depends on
+    // the budget.
+    knapsack_core & set_budget(Cost b) {
+        _budget = b;
+        return reset();
+    }
+
+    knapsack_core & run() {
+        assert(_budget >= 0);
+        const std::size_t num_items = _value_cost_pairs.size();
+        Value greedy_value = 0;
+        Cost greedy_cost = 0;
+        std::size_t break_item = 0;
+        for(; break_item < num_items; ++break_item) {
+            const auto & [v, c] = _value_cost_pairs[break_item];
+            if(greedy_cost + c > _budget) break;
+            greedy_value += v;
+            greedy_cost += c;
+        }
+
+        _decisions.resize(0);
+        _best_value = greedy_value;
+        _best_decision = no_decision;
+        _states.assign(1, state{greedy_value, greedy_cost, no_decision});
+        std::size_t s = break_item;
+        std::size_t t = break_item;
+        // Whether toggling item i may lead to a better solution, by the bound
+        // of Dembo and Hammer at the ratio of the break item:
+        //  greedy value +- value_i + (budget - greedy cost -+ cost_i) ratio.
+        // Any item outside the core failing it is left as in the greedy
+        // solution, and does not enter the core.
+        auto may_improve = [&](const std::size_t i) {
+            if(break_item == num_items) return false;
+            const auto & [vb, cb] = _value_cost_pairs[break_item];
+            const auto & [v, c] = _value_cost_pairs[i];
+            const numeric::adaptive_integer slack =
+                i < break_item ? wide(_budget - greedy_cost) + wide(c)
+                               : wide(_budget - greedy_cost) - wide(c);
+            const numeric::adaptive_integer gain =
+                i < break_item ? -wide(v) : wide(v);
+            return (wide(greedy_value) - wide(_best_value) + gain) * cb +
+                       slack * vb >
+                   0;
+        };
+        while(!_states.empty()) {
+            while(t < num_items && !may_improve(t)) ++t;
+            if(t < num_items) {
+                const auto & [v, c] = _value_cost_pairs[t];
+                merge_with_shifted(t, v, c);
+                ++t;
+            }
+            while(s > 0 && !may_improve(s - 1)) --s;
+            if(s > 0) {
+                const auto & [v, c] = _value_cost_pairs[s - 1];
+                merge_with_shifted(s - 1, static_cast<Value>(-v),
+                                   static_cast<Cost>(-c));
+                --s;
+            }
+            prune(s, t);
+        }
+
+        std::vector<bool> taken(num_items, false);
+        std::fill(taken.begin(),
+                  taken.begin() + static_cast<std::ptrdiff_t>(break_item),
+                  true);
+        for(std::size_t d = _best_decision; d != no_decision;
+            d = _decisions[d].previous)
+            taken[_decisions[d].item] = !taken[_decisions[d].item];
+        _solution.resize(0);
+        for(std::size_t i = 0; i < num_items; ++i)
+            if(taken[i]) _solution.push_back(i);
+        return *this;
+    }
+
+    [[nodiscard]] auto solution_items() const {
+        return std::views::transform(_solution, [this](const std::size_t i) {
+            return *_permuted_items[i];
+        });
+    }
+
+    [[nodiscard]] auto solution_value() const {
+        Value sum = 0;
+        for(const std::size_t i : _solution) sum += _value_cost_pairs[i].first;
+        return sum;
+    }
+
+    [[nodiscard]] auto solution_cost() const {
+        Cost sum = 0;
+        for(const std::size_t i : _solution) sum += _value_cost_pairs[i].second;
+        return sum;
+    }
+};
+
+template <typename ItemRange, typename ValueMap, typename CostMap>
+knapsack_core(ItemRange &&, ValueMap &&, CostMap &&, auto &&)
+    -> knapsack_core<std::views::all_t<ItemRange>,
+                     maps::mapping_all_t<ValueMap>,
+                     maps::mapping_all_t<CostMap>>;
+
+}  // namespace melon
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "melon/detail/stdlib_check.hpp"
+#include "melon/mapping.hpp"
+
+namespace melon {
+
+// The textbook dynamic program over the budgets 0, 1, ..., budget: after item
+// i, best[c] is the most value within cost c among the first i items. Exact,
+// in O(n budget) time whatever the correlation between values and costs, so
+// it is the solver for small integral budgets; knapsack_core is the one for
+// large budgets.
+// Each item's pass reads one row and writes the other, so the budgets do not
+// depend on one another and the pass is branch-free. The choices are kept
+// as one bit per item and budget, n (budget + 1) / 8 bytes, and replayed
+// backwards from the budget to recover the items.
+//
+// Same preconditions as knapsack_bnb: non-negative values, costs and budget.
+template <std::ranges::random_access_range ItemRange,
+          mapping_view<std::ranges::range_value_t<ItemRange>> ValueMap,
+          mapping_view<std::ranges::range_value_t<ItemRange>> CostMap>
+    requires std::is_arithmetic_v<mapped_value_t<
+                 ValueMap, std::ranges::range_value_t<ItemRange>>> &&
+             std::integral<
+                 mapped_value_t<CostMap, std::ranges::range_value_t<ItemRange>>>
+class knapsack_dp {
+private:
+    using Item = std::ranges::range_value_t<ItemRange>;
+    using Value = mapped_value_t<ValueMap, Item>;
+    using Cost = mapped_value_t<CostMap, Item>;
+    using word = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    ItemRange _items_range;
+    ValueMap _value_map;
+    CostMap _cost_map;
+
+    Cost _budget;
+    std::vector<std::ranges::iterator_t<const ItemRange>> _permuted_items;
+    std::vector<std::pair<Value, Cost>> _value_cost_pairs;
+    // indices into _value_cost_pairs
+    std::vector<std::size_t> _solution;
+
+public:
+    template <std::ranges::viewable_range IR, mapping_for<ValueMap> VM,
+              mapping_for<CostMap> CM, std::convertible_to<Cost> B>
+        requires std::constructible_from<ItemRange, std::views::all_t<IR>>
+    knapsack_dp(IR && items_range, VM && value_map, CM && cost_map,
+                B && budget)
+        : _items_range(std::views::all(std::forward<IR>(items_range)))
+        , _value_map(maps::mapping_all(std::forward<VM>(value_map)))
+        , _cost_map(maps::mapping_all(std::forward<CM>(cost_map)))
+        , _budget(std::forward<B>(budget)) {
+        reset();
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    knapsack_dp(const knapsack_dp &) = delete;
+    knapsack_dp(knapsack_dp &&) = default;
+
+    knapsack_dp & operator=(const knapsack_dp &) = delete;
+    knapsack_dp & operator=(knapsack_dp &&) = default;
+
+    knapsack_dp & reset() {
+        _permuted_items.resize(0);
+        _value_cost_pairs.resize(0);
+        _solution.resize(0);
+        if constexpr(std::ranges::sized_range<ItemRange>) {
+            auto num_items = std::ranges::size(_items_range);
+            _permuted_items.reserve(num_items);
+            _value_cost_pairs.reserve(num_items);
+        }
+        for(auto it = _items_range.begin(); it != _items_range.end(); ++it) {
+            const auto & i = *it;
+            const Value value = _value_map[i];
+            if(value == static_cast<Value>(0)) continue;
+            const Cost cost = _cost_map[i];
+            if(cost > _budget) continue;
+            _permuted_items.emplace_back(it);
+            _value_cost_pairs.emplace_back(value, cost);
+        }
+        return *this;
+    }
+
+    // Through reset(), as knapsack_bnb::set_budget: the item filter depends on
+    // the budget.
+    knapsack_dp & set_budget(Cost b) {
+        _budget = b;
+        return reset();
+    }
+
+    knapsack_dp & run() {
+        assert(_budget >= 0);
+        const auto capacity = static_cast<std::size_t>(_budget);
+        const std::size_t num_items = _value_cost_pairs.size();
+        const std::size_t row_words = capacity / word_bits + 1;
+        std::vector<word> taken(num_items * row_words, 0);
+        std::vector<Value> best(capacity + 1, Value{0});
+        std::vector<Value> next(capacity + 1);
+        for(std::size_t i = 0; i < num_items; ++i) {
+            const auto & [value, cost] = _value_cost_pairs[i];
+            const auto w = static_cast<std::size_t>(cost);
+            std::copy(best.begin(),
+                      best.begin() + static_cast<std::ptrdiff_t>(w),
+                      next.begin());
+            word * const row = taken.data() + i * row_words;
+            // a word of choices at a time, so the bits are or-ed in registers
+            for(std::size_t first = w; first <= capacity;) {
+                const std::size_t last = std::min(
+                    capacity + 1, (first / word_bits + 1) * word_bits);
+                word bits = 0;
+                for(std::size_t c = first; c < last; ++c) {
+                    const auto with = static_cast<Value>(best[c - w] + value);
+                    const bool take = with > best[c];
+                    next[c] = take ? with : best[c];
+                    bits |= static_cast<word>(take) << (c % word_bits);
+                }
+                row[first / word_bits] = bits;
+                first = last;
+            }
+            best.swap(next);
+        }
+        _solution.resize(0);
+        std::size_t c = capacity;
+        for(std::size_t i = num_items; i-- > 0;) {
+            if((taken[i * row_words + c / word_bits] >> (c % word_bits)) & 1u) {
+                _solution.push_back(i);
+                c -= static_cast<std::size_t>(_value_cost_pairs[i].second);
+            }
+        }
+        return *this;
+    }
+
+    [[nodiscard]] auto solution_items() const {
+        return std::views::transform(_solution, [this](const std::size_t i) {
+            return *_permuted_items[i];
+        });
+    }
+
+    [[nodiscard]] auto solution_value() const {
+        Value sum = 0;
+        for(const std::size_t i : _solution) sum += _value_cost_pairs[i].first;
+        return sum;
+    }
+
+    [[nodiscard]] auto solution_cost() const {
+        Cost sum = 0;
+        for(const std::size_t i : _solution) sum += _value_cost_pairs[i].second;
+        return sum;
+    }
+};
+
+template <typename ItemRange, typename ValueMap, typename CostMap>
+knapsack_dp(ItemRange &&, ValueMap &&, CostMap &&, auto &&)
+    -> knapsack_dp<std::views::all_t<ItemRange>, maps::mapping_all_t<ValueMap>,
+                   maps::mapping_all_t<CostMap>>;
+
+}  // namespace melon
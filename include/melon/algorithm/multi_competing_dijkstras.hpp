@@ -0,0 +1,297 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "melon/container/d_ary_heap.hpp"
+#include "melon/detail/map_if.hpp"
+#include "melon/detail/prefetch.hpp"
+#include "melon/graph.hpp"
+#include "melon/mapping.hpp"
+#include "melon/utility/algorithmic_generator.hpp"
+#include "melon/utility/priority_queue.hpp"
+#include "melon/utility/semiring.hpp"
+#include "melon/views/graph_view.hpp"
+
+namespace melon {
+
+namespace detail {
+// How multi_competing_dijkstras takes each map of a range of length maps: by
+// reference into an lvalue range, moved out of an rvalue one.
+template <typename LengthMaps>
+using length_maps_element_t =
+    std::conditional_t<std::is_lvalue_reference_v<LengthMaps>,
+                       std::ranges::range_reference_t<LengthMaps>,
+                       std::ranges::range_value_t<LengthMaps>>;
+}  // namespace detail
+
+template <typename Traits>
+concept multi_competing_dijkstras_traits =
+    semiring<typename Traits::semiring> &&
+    updatable_priority_queue<typename Traits::heap> && requires {
+        { Traits::store_distances } -> std::convertible_to<bool>;
+        { Traits::store_colors } -> std::convertible_to<bool>;
+    };
+
+template <typename Graph, typename ValueType>
+struct multi_competing_dijkstras_default_traits {
+    using semiring = shortest_path_semiring<ValueType>;
+    // (distance, color): the smaller color wins a tie, as blue does in
+    // competing_dijkstras.
+    using entry = std::pair<ValueType, std::size_t>;
+    struct entry_cmp {
+        [[nodiscard]] constexpr bool operator()(const entry & e1,
+                                                const entry & e2) const {
+            if(e1.first == e2.first) {
+                return e1.second < e2.second;
+            }
+            return semiring::less(e1.first, e2.first);
+        }
+    };
+    using heap =
+        updatable_d_ary_heap<2, std::pair<vertex_t<Graph>, entry>, entry_cmp,
+                             vertex_map_t<Graph, std::size_t>,
+                             maps::element_map<1>, maps::element_map<0>>;
+
+    static constexpr bool store_distances = false;
+    static constexpr bool store_colors = false;
+};
+
+// competing_dijkstras for any number of colors: k Dijkstras racing in one
+// heap, color c spreading from its sources with its own length map, and each
+// vertex claimed by the color that reaches it first -- the smallest color on
+// a tie. A claimed vertex blocks the other colors: a color only spreads
+// through the vertices it claims. Iterating yields every vertex reached, as
+// (vertex, (distance, color)) pairs in order of increasing distance.
+// Same precondition as melon::dijkstra, on every map and uncheckable by any
+// concept: an arc length must never improve a distance when combined.
+// O((m + n) log n) with the default binary heap, whatever the number of
+// colors: k - 1 pairwise races would settle each vertex up to k - 1 times.
+template <graph_view Graph, mapping_view<arc_t<Graph>> LengthMap,
+          multi_competing_dijkstras_traits Traits =
+              multi_competing_dijkstras_default_traits<
+                  Graph, mapped_value_t<LengthMap, arc_t<Graph>>>>
+    requires outward_incidence_graph<Graph> && has_vertex_map<Graph>
+class multi_competing_dijkstras
+    : public algorithm_view_interface<
+          multi_competing_dijkstras<Graph, LengthMap, Traits>> {
+private:
+    using vertex = vertex_t<Graph>;
+    using arc = arc_t<Graph>;
+    using length_type = mapped_value_t<LengthMap, arc_t<Graph>>;
+    using entry_t = typename Traits::entry;
+    using entry_cmp = typename Traits::entry_cmp;
+    using heap = typename Traits::heap;
+    enum vertex_status : char { PRE_HEAP = 0, IN_HEAP = 1, POST_HEAP = 2 };
+
+    static_assert(
+        std::is_same_v<typename Traits::heap::value_type,
+                       std::pair<vertex, std::pair<length_type, std::size_t>>>,
+        "multi_competing_dijkstras requires matching value_type with heap.");
+
+private:
+    Graph _graph;
+    // by color
+    std::vector<LengthMap> _length_maps;
+    vertex_map_t<Graph, vertex_status> _vertex_status_map;
+    heap _heap;
+    [[no_unique_address]] entry_cmp _entry_cmp;
+
+    [[no_unique_address]] vertex_map_if<Traits::store_distances, Graph,
+                                        length_type> _distances_map;
+    [[no_unique_address]] vertex_map_if<Traits::store_colors, Graph,
+                                        std::size_t> _colors_map;
+
+public:
+    // One length map per color, color c being the c-th of the range. An
+    // lvalue range is referred to, like any melon map; the maps of an rvalue
+    // one are moved in.
+    template <graph_for<Graph> G, std::ranges::input_range LMs>
+        requires mapping_for<detail::length_maps_element_t<LMs>, LengthMap>
+    multi_competing_dijkstras(G && g, LMs && lms)
+        : _graph(views::graph_all(std::forward<G>(g)))
+        , _vertex_status_map(create_vertex_map<vertex_status>(_graph, PRE_HEAP))
+        , _heap(_entry_cmp, create_vertex_map<std::size_t>(_graph))
+        , _distances_map(_graph)
+        , _colors_map(_graph) {
+        for(auto && lm : lms) {
+            if constexpr(std::is_lvalue_reference_v<LMs>)
+                _length_maps.emplace_back(maps::mapping_all(lm));
+            else
+                _length_maps.emplace_back(maps::mapping_all(std::move(lm)));
+        }
+    }
+
+    template <typename... Args>
+        requires std::constructible_from<multi_competing_dijkstras, Args...>
+    constexpr multi_competing_dijkstras(Traits, Args &&... args)
+        : multi_competing_dijkstras(std::forward<Args>(args)...) {}
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    constexpr multi_competing_dijkstras(const multi_competing_dijkstras &) =
+        delete;
+    constexpr multi_competing_dijkstras(multi_competing_dijkstras &&) = default;
+
+    constexpr multi_competing_dijkstras & operator=(
+        const multi_competing_dijkstras &) = delete;
+    constexpr multi_competing_dijkstras & operator=(
+        multi_competing_dijkstras &&) = default;
+
+    [[nodiscard]] constexpr Graph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const Graph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr Graph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const Graph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    [[nodiscard]] constexpr std::size_t num_colors() const noexcept {
+        return _length_maps.size();
+    }
+
+    template <mapping_for<LengthMap> LM>
+        requires std::assignable_from<LengthMap &, LengthMap>
+    multi_competing_dijkstras & set_length_map(const std::size_t color,
+                                               LM && length_map) {
+        assert(color < num_colors());
+        _length_maps[color] = maps::mapping_all(std::forward<LM>(length_map));
+        return *this;
+    }
+
+    multi_competing_dijkstras & reset() {
+        _vertex_status_map.fill(PRE_HEAP);
+        _heap.clear();
+        return *this;
+    }
+
+    // Strict precondition: the vertex must be untouched, as for
+    // competing_dijkstras' sources.
+    multi_competing_dijkstras & add_source(
+        const vertex & s, const std::size_t color,
+        const length_type dist_v = Traits::semiring::zero) {
+        assert(color < num_colors());
+        assert(_vertex_status_map[s] == PRE_HEAP);
+        _heap.push(std::make_pair(s, entry_t{dist_v, color}));
+        _vertex_status_map[s] = IN_HEAP;
+        return *this;
+    }
+
+    [[nodiscard]] constexpr bool finished() const
+        noexcept(noexcept(_heap.empty())) {
+        return _heap.empty();
+    }
+
+    // The noexcept measures the copy the by-value return performs, not just the
+    // top() call.
+    [[nodiscard]] constexpr auto current() const
+        noexcept(noexcept(typename heap::value_type(_heap.top()))) {
+        assert(!finished());
+        return _heap.top();
+    }
+
+    constexpr void advance() {
+        assert(!finished());
+        // A copy, not a reference binding: top() returns a reference into the
+        // heap array, and t_entry is read after the pop() below reorders it.
+        const auto [t, t_entry] = _heap.top();
+        _vertex_status_map[t] = POST_HEAP;
+        if constexpr(Traits::store_distances) _distances_map[t] = t_entry.first;
+        if constexpr(Traits::store_colors) _colors_map[t] = t_entry.second;
+        const LengthMap & length_map = _length_maps[t_entry.second];
+        auto && out_arcs_range = out_arcs(_graph, t);
+        prefetch_keys_and_values(out_arcs_range, arc_targets_map(_graph),
+                                 length_map);
+        _heap.pop();
+        for(const arc & a : out_arcs_range) {
+            const vertex & w = arc_target(_graph, a);
+            const entry_t new_entry = {
+                Traits::semiring::plus(t_entry.first, length_map[a]),
+                t_entry.second};
+            const vertex_status w_status = _vertex_status_map[w];
+            if(w_status == IN_HEAP) {
+                if(_entry_cmp(new_entry, _heap.priority(w)))
+                    _heap.promote(w, new_entry);
+            } else if(w_status == PRE_HEAP) {
+                _heap.push(std::make_pair(w, new_entry));
+                _vertex_status_map[w] = IN_HEAP;
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr bool reached(const vertex & u) const
+        noexcept(noexcept(_vertex_status_map[u] != PRE_HEAP)) {
+        return _vertex_status_map[u] != PRE_HEAP;
+    }
+    [[nodiscard]] constexpr bool visited(const vertex & u) const
+        noexcept(noexcept(_vertex_status_map[u] == POST_HEAP)) {
+        return _vertex_status_map[u] == POST_HEAP;
+    }
+    // Iteration yields each (vertex, (distance, color)) once and then forgets
+    // it, so per-vertex lookups need the maps these traits enable.
+    [[nodiscard]] constexpr length_type dist(const vertex & u) const
+        noexcept(noexcept(_distances_map[u]))
+        requires(Traits::store_distances)
+    {
+        assert(visited(u));
+        return _distances_map[u];
+    }
+    [[nodiscard]] constexpr std::size_t color(const vertex & u) const
+        noexcept(noexcept(_colors_map[u]))
+        requires(Traits::store_colors)
+    {
+        assert(visited(u));
+        return _colors_map[u];
+    }
+    // Refers into the algorithm, like every melon map view: valid while this
+    // object lives and stays put. The vertices not yet visited hold
+    // indeterminate values.
+    [[nodiscard]] constexpr auto dists_map() const & noexcept(
+        noexcept(maps::mapping_all(_distances_map._map)))
+        requires(Traits::store_distances)
+    {
+        return maps::mapping_all(_distances_map._map);
+    }
+    [[nodiscard]] constexpr auto colors_map() const & noexcept(
+        noexcept(maps::mapping_all(_colors_map._map)))
+        requires(Traits::store_colors)
+    {
+        return maps::mapping_all(_colors_map._map);
+    }
+    // Terminal, like std::move(alg).base(): the member left behind is valid but
+    // empty, so no other member may be called afterwards.
+    [[nodiscard]] constexpr auto dists_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_distances_map._map))))
+        requires(Traits::store_distances)
+    {
+        return maps::mapping_all(std::move(_distances_map._map));
+    }
+    [[nodiscard]] constexpr auto colors_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_colors_map._map))))
+        requires(Traits::store_colors)
+    {
+        return maps::mapping_all(std::move(_colors_map._map));
+    }
+};
+
+template <typename Graph, typename LengthMaps>
+multi_competing_dijkstras(Graph &&, LengthMaps &&)
+    -> multi_competing_dijkstras<
+        views::graph_all_t<Graph>,
+        maps::mapping_all_t<detail::length_maps_element_t<LengthMaps>>>;
+
+template <typename Graph, typename LengthMaps, typename Traits>
+multi_competing_dijkstras(Traits, Graph &&, LengthMaps &&)
+    -> multi_competing_dijkstras<
+        views::graph_all_t<Graph>,
+        maps::mapping_all_t<detail::length_maps_element_t<LengthMaps>>,
+        Traits>;
+
+}  // namespace melon
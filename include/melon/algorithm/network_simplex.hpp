@@ -0,0 +1,437 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "melon/graph.hpp"
+#include "melon/mapping.hpp"
+
+namespace melon {
+
+// The primal network simplex for the minimum-cost flow problem: send, at
+// least cost, flows within [0, capacity(a)] such that every vertex v emits
+// supply(v) more than it receives -- a negative supply is a demand. The
+// supplies must sum to zero for a solution to exist.
+//
+// The spanning tree starts from an artificial root joined to every vertex
+// by an arc too expensive to keep, and is stored as parent pointers and
+// child lists: a pivot walks the cycle it closes, then rehangs and
+// reprices only the subtree cut off by the leaving arc. Entering arcs are
+// chosen by block search -- the most negative reduced cost among the next
+// sqrt(m) arcs, resuming where the last block ended -- and ties for the
+// leaving arc follow Cunningham's rule, which keeps the tree strongly
+// feasible and rules out cycling.
+//
+// Capacities must be non-negative. Floating-point costs and capacities are
+// accepted, with the usual round-off caveats.
+template <graph_view Graph, mapping_view<arc_t<Graph>> CapacityMap,
+          mapping_view<arc_t<Graph>> CostMap,
+          mapping_view<vertex_t<Graph>> SupplyMap>
+    requires has_vertex_map<Graph> && has_arc_map<Graph> &&
+             std::is_signed_v<mapped_value_t<CapacityMap, arc_t<Graph>>> &&
+             std::is_signed_v<mapped_value_t<CostMap, arc_t<Graph>>> &&
+             std::convertible_to<mapped_value_t<SupplyMap, vertex_t<Graph>>,
+                                 mapped_value_t<CapacityMap, arc_t<Graph>>>
+class network_simplex {
+private:
+    using vertex = vertex_t<Graph>;
+    using arc = arc_t<Graph>;
+    using flow_t = mapped_value_t<CapacityMap, arc_t<Graph>>;
+    using cost_t = mapped_value_t<CostMap, arc_t<Graph>>;
+
+    // Non-tree arcs sit at one of their bounds; the state doubles as the
+    // sign by which a reduced cost makes the arc worth entering.
+    enum state : signed char { upper = -1, tree = 0, lower = 1 };
+
+    static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+private:
+    Graph _graph;
+    CapacityMap _capacity_map;
+    CostMap _cost_map;
+    SupplyMap _supply_map;
+    bool _converged;
+    bool _feasible;
+    arc_map_t<Graph, flow_t> _carried_flow_map;
+    vertex_map_t<Graph, cost_t> _potential_map;
+
+    // The network, indexed densely: vertex i < n, the root n, arc e < m, and
+    // the artificial arc of vertex i at m + i.
+    vertex_map_t<Graph, std::size_t> _index_map;
+    std::vector<vertex> _vertices;
+    std::vector<arc> _arcs;
+    std::vector<std::size_t> _source;
+    std::vector<std::size_t> _target;
+    std::vector<flow_t> _capacity;
+    std::vector<flow_t> _flow;
+    std::vector<cost_t> _cost;
+    std::vector<state> _state;
+    // The spanning tree: the arc to the parent and the children, linked.
+    std::vector<cost_t> _pi;
+    std::vector<std::size_t> _parent;
+    std::vector<std::size_t> _pred;
+    std::vector<std::size_t> _depth;
+    std::vector<std::size_t> _first_child;
+    std::vector<std::size_t> _next_sibling;
+    std::vector<std::size_t> _prev_sibling;
+    std::size_t _block_size;
+    std::size_t _next_arc;
+
+public:
+    template <graph_for<Graph> G, mapping_for<CapacityMap> CM,
+              mapping_for<CostMap> CoM, mapping_for<SupplyMap> SM>
+    network_simplex(G && g, CM && capacities, CoM && costs, SM && supplies)
+        : _graph(views::graph_all(std::forward<G>(g)))
+        , _capacity_map(maps::mapping_all(std::forward<CM>(capacities)))
+        , _cost_map(maps::mapping_all(std::forward<CoM>(costs)))
+        , _supply_map(maps::mapping_all(std::forward<SM>(supplies)))
+        , _converged(false)
+        , _feasible(false)
+        , _carried_flow_map(create_arc_map<flow_t>(_graph))
+        , _potential_map(create_vertex_map<cost_t>(_graph))
+        , _index_map(create_vertex_map<std::size_t>(_graph))
+        , _block_size(0)
+        , _next_arc(0) {
+        for(auto && v : vertices(_graph)) {
+            _index_map[v] = _vertices.size();
+            _vertices.push_back(v);
+        }
+        for(auto && [a, endpoints] : arcs_entries(_graph)) {
+            _arcs.push_back(a);
+            _source.push_back(_index_map[endpoints.first]);
+            _target.push_back(_index_map[endpoints.second]);
+        }
+        reset();
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    network_simplex(const network_simplex &) = delete;
+    network_simplex(network_simplex &&) = default;
+
+    network_simplex & operator=(const network_simplex &) = delete;
+    network_simplex & operator=(network_simplex &&) = default;
+
+    [[nodiscard]] constexpr Graph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const Graph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr Graph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const Graph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    // Zeroes the flows and potentials. The capacity, cost and supply maps
+    // are read again by the next run(), so they may change in between.
+    network_simplex & reset() {
+        _converged = false;
+        _feasible = false;
+        for(auto && a : arcs(_graph)) _carried_flow_map[a] = flow_t{0};
+        for(auto && v : vertices(_graph)) _potential_map[v] = cost_t{0};
+        return *this;
+    }
+
+private:
+    void initialize_tree() {
+        const std::size_t n = _vertices.size();
+        const std::size_t m = _arcs.size();
+        const std::size_t root = n;
+
+        _source.resize(m + n);
+        _target.resize(m + n);
+        _capacity.assign(m + n, flow_t{0});
+        _flow.assign(m + n, flow_t{0});
+        _cost.assign(m + n, cost_t{0});
+        _state.assign(m + n, state::lower);
+
+        cost_t max_cost{0};
+        for(std::size_t e = 0; e < m; ++e) {
+            _capacity[e] = _capacity_map[_arcs[e]];
+            _cost[e] = _cost_map[_arcs[e]];
+            assert(!(_capacity[e] < flow_t{0}));
+            max_cost = std::max(max_cost, _cost[e] < cost_t{0} ? -_cost[e]
+                                                               : _cost[e]);
+        }
+        // Dearer than any path of real arcs, so that an artificial arc keeps
+        // flow only if no feasible flow exists.
+        const cost_t artificial_cost =
+            static_cast<cost_t>((max_cost + cost_t{1}) *
+                                static_cast<cost_t>(std::max(n, std::size_t{1})));
+
+        _pi.assign(n + 1, cost_t{0});
+        _parent.assign(n + 1, none);
+        _pred.assign(n + 1, none);
+        _depth.assign(n + 1, 0);
+        _first_child.assign(n + 1, none);
+        _next_sibling.assign(n + 1, none);
+        _prev_sibling.assign(n + 1, none);
+
+        // Supplies flow up to the root and demands down from it, which makes
+        // the initial tree strongly feasible.
+        for(std::size_t i = 0; i < n; ++i) {
+            const std::size_t e = m + i;
+            const flow_t supply = static_cast<flow_t>(_supply_map[_vertices[i]]);
+            _capacity[e] = std::numeric_limits<flow_t>::max();
+            _cost[e] = artificial_cost;
+            _state[e] = state::tree;
+            if(supply < flow_t{0}) {
+                _source[e] = root;
+                _target[e] = i;
+                _flow[e] = -supply;
+                _pi[i] = artificial_cost;
+            } else {
+                _source[e] = i;
+                _target[e] = root;
+                _flow[e] = supply;
+                _pi[i] = -artificial_cost;
+            }
+            _parent[i] = root;
+            _pred[i] = e;
+            _depth[i] = 1;
+            attach(i, root);
+        }
+
+        _block_size = std::max(
+            std::size_t{10},
+            static_cast<std::size_t>(std::sqrt(static_cast<double>(m))));
+        _next_arc = 0;
+    }
+
+    void attach(const std::size_t u, const std::size_t p) noexcept {
+        _prev_sibling[u] = none;
+        _next_sibling[u] = _first_child[p];
+        if(_first_child[p] != none) _prev_sibling[_first_child[p]] = u;
+        _first_child[p] = u;
+    }
+    void detach(const std::size_t u) noexcept {
+        if(_prev_sibling[u] != none)
+            _next_sibling[_prev_sibling[u]] = _next_sibling[u];
+        else
+            _first_child[_parent[u]] = _next_sibling[u];
+        if(_next_sibling[u] != none)
+            _prev_sibling[_next_sibling[u]] = _prev_sibling[u];
+    }
+
+    [[nodiscard]] cost_t reduced_cost(const std::size_t e) const noexcept {
+        return _cost[e] + _pi[_source[e]] - _pi[_target[e]];
+    }
+
+    // The residual capacity of u's tree arc toward u, or toward its parent.
+    [[nodiscard]] flow_t residual_down(const std::size_t u) const noexcept {
+        const std::size_t e = _pred[u];
+        return _source[e] == u ? _flow[e] : _capacity[e] - _flow[e];
+    }
+    [[nodiscard]] flow_t residual_up(const std::size_t u) const noexcept {
+        const std::size_t e = _pred[u];
+        return _source[e] == u ? _capacity[e] - _flow[e] : _flow[e];
+    }
+
+    // Block search over the real arcs: artificial arcs never re-enter.
+    [[nodiscard]] bool find_entering_arc(std::size_t & in_arc) noexcept {
+        const std::size_t m = _arcs.size();
+        cost_t min_cost{0};
+        std::size_t count = _block_size;
+        for(std::size_t k = 0; k < m; ++k) {
+            const std::size_t e = (_next_arc + k) % m;
+            const cost_t c = _state[e] * reduced_cost(e);
+            if(c < min_cost) {
+                min_cost = c;
+                in_arc = e;
+            }
+            if(--count == 0) {
+                if(min_cost < cost_t{0}) {
+                    _next_arc = (e + 1) % m;
+                    return true;
+                }
+                count = _block_size;
+            }
+        }
+        return min_cost < cost_t{0};
+    }
+
+    [[nodiscard]] std::size_t find_join(std::size_t u,
+                                        std::size_t v) const noexcept {
+        while(u != v) {
+            if(_depth[u] < _depth[v])
+                v = _parent[v];
+            else
+                u = _parent[u];
+        }
+        return u;
+    }
+
+    // Makes u_in a child of v_in through in_arc, reversing the tree path from
+    // u_in up to u_out, whose arc to its parent leaves the tree; then shifts
+    // the potentials and depths of the subtree that moved.
+    void rehang(const std::size_t u_in, const std::size_t v_in,
+                const std::size_t in_arc, const std::size_t u_out) noexcept {
+        const cost_t sigma = u_in == _target[in_arc] ? reduced_cost(in_arc)
+                                                     : -reduced_cost(in_arc);
+        std::size_t u = u_in;
+        std::size_t new_parent = v_in;
+        std::size_t new_pred = in_arc;
+        for(;;) {
+            const std::size_t old_parent = _parent[u];
+            const std::size_t old_pred = _pred[u];
+            detach(u);
+            _parent[u] = new_parent;
+            _pred[u] = new_pred;
+            attach(u, new_parent);
+            if(u == u_out) break;
+            new_parent = u;
+            new_pred = old_pred;
+            u = old_parent;
+        }
+
+        // Preorder walk of the subtree, along the child links.
+        u = u_in;
+        for(;;) {
+            _pi[u] += sigma;
+            _depth[u] = _depth[_parent[u]] + 1;
+            if(_first_child[u] != none) {
+                u = _first_child[u];
+                continue;
+            }
+            while(u != u_in && _next_sibling[u] == none) u = _parent[u];
+            if(u == u_in) break;
+            u = _next_sibling[u];
+        }
+    }
+
+    void pivot(const std::size_t in_arc) noexcept {
+        // The cycle sends flow first -> second along in_arc, then up the tree
+        // to their join and down back to first.
+        const bool forward = _state[in_arc] == state::lower;
+        const std::size_t first = forward ? _source[in_arc] : _target[in_arc];
+        const std::size_t second = forward ? _target[in_arc] : _source[in_arc];
+        const std::size_t join = find_join(first, second);
+
+        flow_t delta = _capacity[in_arc];
+        std::size_t u_out = none;
+        int side = 0;
+        // Of the blocking arcs, the last one met from the join along the
+        // cycle's direction: strict here, non-strict on the second side.
+        for(std::size_t u = first; u != join; u = _parent[u]) {
+            const flow_t d = residual_down(u);
+            if(d < delta) {
+                delta = d;
+                u_out = u;
+                side = 1;
+            }
+        }
+        for(std::size_t u = second; u != join; u = _parent[u]) {
+            const flow_t d = residual_up(u);
+            if(!(delta < d)) {
+                delta = d;
+                u_out = u;
+                side = 2;
+            }
+        }
+
+        if(delta > flow_t{0}) {
+            _flow[in_arc] += forward ? delta : -delta;
+            for(std::size_t u = first; u != join; u = _parent[u])
+                _flow[_pred[u]] += _source[_pred[u]] == u ? -delta : delta;
+            for(std::size_t u = second; u != join; u = _parent[u])
+                _flow[_pred[u]] += _source[_pred[u]] == u ? delta : -delta;
+        }
+
+        if(side == 0) {  // in_arc reached its other bound
+            _state[in_arc] = forward ? state::upper : state::lower;
+            return;
+        }
+        const std::size_t out_arc = _pred[u_out];
+        _state[out_arc] =
+            _flow[out_arc] == flow_t{0} ? state::lower : state::upper;
+        _state[in_arc] = state::tree;
+        if(side == 1)
+            rehang(first, second, in_arc, u_out);
+        else
+            rehang(second, first, in_arc, u_out);
+    }
+
+public:
+    network_simplex & run() {
+        if(_converged) return *this;
+        initialize_tree();
+        std::size_t in_arc = 0;
+        while(find_entering_arc(in_arc)) pivot(in_arc);
+
+        const std::size_t m = _arcs.size();
+        _feasible = true;
+        for(std::size_t i = 0; i < _vertices.size(); ++i) {
+            if(_flow[m + i] != flow_t{0}) _feasible = false;
+            _potential_map[_vertices[i]] = _pi[i];
+        }
+        for(std::size_t e = 0; e < m; ++e) _carried_flow_map[_arcs[e]] = _flow[e];
+        _converged = true;
+        return *this;
+    }
+
+    // Precondition: run() has converged. False when no flow meets the
+    // supplies within the capacities -- flows and potentials are then those
+    // of the least infeasible solution found, and mean nothing.
+    [[nodiscard]] bool feasible() const noexcept {
+        assert(_converged);
+        return _feasible;
+    }
+
+    [[nodiscard]] cost_t total_cost() const {
+        assert(_converged);
+        cost_t sum{0};
+        for(std::size_t e = 0; e < _arcs.size(); ++e)
+            sum += static_cast<cost_t>(_flow[e]) * _cost[e];
+        return sum;
+    }
+
+    [[nodiscard]] constexpr flow_t flow(const arc & a) const
+        noexcept(noexcept(_carried_flow_map[a])) {
+        return _carried_flow_map[a];
+    }
+    // Refers into the algorithm, like every melon map view: valid while this
+    // object lives and stays put.
+    [[nodiscard]] constexpr auto flows_map() const & noexcept(
+        noexcept(maps::mapping_all(_carried_flow_map))) {
+        return maps::mapping_all(_carried_flow_map);
+    }
+    // Terminal, like std::move(alg).base(): the member left behind is valid but
+    // empty, so no other member may be called afterwards.
+    [[nodiscard]] constexpr auto flows_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_carried_flow_map)))) {
+        return maps::mapping_all(std::move(_carried_flow_map));
+    }
+
+    // Optimal dual values: at optimality, the reduced cost
+    // cost(a) + potential(source) - potential(target) is non-negative on
+    // every arc below its capacity and non-positive on every arc with flow.
+    [[nodiscard]] constexpr cost_t potential(const vertex & v) const
+        noexcept(noexcept(_potential_map[v])) {
+        return _potential_map[v];
+    }
+    [[nodiscard]] constexpr auto potentials_map() const & noexcept(
+        noexcept(maps::mapping_all(_potential_map))) {
+        return maps::mapping_all(_potential_map);
+    }
+    [[nodiscard]] constexpr auto potentials_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_potential_map)))) {
+        return maps::mapping_all(std::move(_potential_map));
+    }
+};
+
+template <typename Graph, typename CapacityMap, typename CostMap,
+          typename SupplyMap>
+network_simplex(Graph &&, CapacityMap &&, CostMap &&, SupplyMap &&)
+    -> network_simplex<views::graph_all_t<Graph>,
+                       maps::mapping_all_t<CapacityMap>,
+                       maps::mapping_all_t<CostMap>,
+                       maps::mapping_all_t<SupplyMap>>;
+
+}  // namespace melon
@@ -88,6 +88,10 @@ private:
     using heap = Traits::heap;
     enum vertex_status : char { PRE_HEAP = 0, IN_HEAP = 1, POST_HEAP = 2 };
 
+    // add_kernel() and remove_kernel() need both maps.
+    static constexpr bool incremental =
+        Traits::store_distances && Traits::store_clusters;
+
     static_assert(
         std::is_same_v<typename Traits::heap::value_type,
                        std::pair<vertex, std::pair<length_type, cluster_id_t>>>,
@@ -104,6 +108,10 @@ private:
                                         length_type> _distances_map;
     [[no_unique_address]] vertex_map_if<Traits::store_clusters, Graph,
                                         cluster_id_t> _clusters_map;
+    // Which vertices are kernels: one at distance zero of a smaller one falls
+    // into that one's cell, and must be handed its own back on the removal.
+    [[no_unique_address]] vertex_map_if<incremental, Graph, bool>
+        _kernels_map;
 
 public:
     template <graph_for<Graph> G, mapping_for<LengthMap> LM>
@@ -113,7 +121,8 @@ public:
         , _heap(_entry_cmp, create_vertex_map<std::size_t>(_graph))
         , _vertex_status_map(create_vertex_map<vertex_status>(_graph, PRE_HEAP))
         , _distances_map(_graph)
-        , _clusters_map(_graph) {}
+        , _clusters_map(_graph)
+        , _kernels_map(_graph, false) {}
 
     template <graph_for<Graph> G, mapping_for<LengthMap> LM,
               std::ranges::range KR>
@@ -148,6 +157,7 @@ public:
     constexpr network_voronoi & reset() {
         _heap.clear();
         _vertex_status_map.fill(PRE_HEAP);
+        if constexpr(incremental) _kernels_map.fill(false);
         return *this;
     }
     // Strict precondition: the kernels must be untouched, so seed before
@@ -168,6 +178,7 @@ public:
             assert(_vertex_status_map[v] == PRE_HEAP);
             _heap.push(std::make_pair(v, entry_t{Traits::semiring::zero, v}));
             _vertex_status_map[v] = IN_HEAP;
+            if constexpr(incremental) _kernels_map[v] = true;
         }
         return *this;
     }
@@ -212,6 +223,99 @@ public:
         }
     }
 
+private:
+    // Gives w the entry e if it beats the one w holds: the heap's for a
+    // vertex in it, the stored one for a settled vertex, none for an
+    // unreached one.
+    constexpr void push_if_better(const vertex & w, const entry_t & e)
+        requires(incremental)
+    {
+        switch(_vertex_status_map[w]) {
+            case IN_HEAP:
+                if(_entry_cmp(e, _heap.priority(w))) _heap.promote(w, e);
+                return;
+            case POST_HEAP:
+                if(!_entry_cmp(e, entry_t{_distances_map[w], _clusters_map[w]}))
+                    return;
+                break;
+            case PRE_HEAP:
+                break;
+        }
+        _heap.push(std::make_pair(w, e));
+        _vertex_status_map[w] = IN_HEAP;
+    }
+
+    // Settles the heap, moving to an entry only the vertices it beats.
+    constexpr void drain()
+        requires(incremental)
+    {
+        while(!_heap.empty()) {
+            const auto [t, t_entry] = _heap.top();
+            _vertex_status_map[t] = POST_HEAP;
+            _distances_map[t] = t_entry.first;
+            _clusters_map[t] = t_entry.second;
+            _heap.pop();
+            for(const arc & a : melon::out_arcs(_graph, t))
+                push_if_better(
+                    melon::arc_target(_graph, a),
+                    {Traits::semiring::plus(t_entry.first, _length_map[a]),
+                     t_entry.second});
+        }
+    }
+
+public:
+    // Incremental updates of a finished() partition, for the storing traits:
+    // only the vertices whose cell changes are visited, not the graph.
+    //
+    // add_kernel(k) runs a Dijkstra from k that stops at the vertices k does
+    // not beat: if k does not win a vertex, it wins nothing behind it either.
+    // O(c log c) for a new cell of c vertices and their out-arcs.
+    constexpr network_voronoi & add_kernel(const vertex & k)
+        requires(incremental)
+    {
+        assert(finished() && !_kernels_map[k]);
+        _kernels_map[k] = true;
+        push_if_better(k, entry_t{Traits::semiring::zero, k});
+        drain();
+        return *this;
+    }
+    // remove_kernel(k) gathers k's cell along the out-arcs from k -- the
+    // shortest paths to a vertex of the cell stay in it -- then hands every
+    // vertex of the cell back to the best of the neighbouring cells, from the
+    // distances on their boundary, by a Dijkstra confined to the cell. Its
+    // vertices no other kernel reaches are left unreached. O(c log c) for a
+    // cell of c vertices, their in-arcs and out-arcs.
+    constexpr network_voronoi & remove_kernel(const vertex & k)
+        requires(incremental && inward_incidence_graph<Graph>)
+    {
+        assert(finished() && _kernels_map[k]);
+        _kernels_map[k] = false;
+        // a kernel in the cell of another has none of its own
+        if(_clusters_map[k] != k) return *this;
+        std::vector<vertex> cell = {k};
+        _vertex_status_map[k] = PRE_HEAP;
+        for(std::size_t i = 0; i < cell.size(); ++i) {
+            for(const arc & a : melon::out_arcs(_graph, cell[i])) {
+                const vertex & w = melon::arc_target(_graph, a);
+                if(!visited(w) || _clusters_map[w] != k) continue;
+                _vertex_status_map[w] = PRE_HEAP;
+                cell.push_back(w);
+            }
+        }
+        for(const vertex & v : cell) {
+            if(_kernels_map[v]) push_if_better(v, {Traits::semiring::zero, v});
+            for(const arc & a : melon::in_arcs(_graph, v)) {
+                const vertex & u = melon::arc_source(_graph, a);
+                if(!visited(u)) continue;
+                push_if_better(
+                    v, {Traits::semiring::plus(_distances_map[u], _length_map[a]),
+                        _clusters_map[u]});
+            }
+        }
+        drain();
+        return *this;
+    }
+
     [[nodiscard]] constexpr bool reached(const vertex & u) const
         noexcept(noexcept(_vertex_status_map[u] != PRE_HEAP)) {
         return _vertex_status_map[u] != PRE_HEAP;
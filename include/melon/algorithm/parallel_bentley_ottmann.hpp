@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "melon/algorithm/bentley_ottmann.hpp"
+#include "melon/detail/not_self.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/mapping.hpp"
+
+namespace melon {
+
+// bentley_ottmann split across threads by vertical slabs. The slab boundaries
+// are quantiles of the segments' leftmost abscissas, so each slab starts about
+// as many segments as the others. Every slab runs a sweep of its own over the
+// segments meeting it, and keeps the points of its half-open x-range
+// [lo, hi). A point on a boundary belongs to the slab on its right, so none
+// is reported twice.
+// Segments crossing a boundary are not clipped: clipping would move their
+// endpoints to rational points, and so change the coordinate type the traits
+// were written for. A slab's sweep therefore starts from the leftmost endpoint
+// of its segments, and stops at its right edge. A segment is swept once in
+// every slab it meets, which costs little while segments are short compared
+// with the slabs -- road networks, typically.
+// The points come out as a single bentley_ottmann would yield them, in the
+// same order and with the same segment ids, whatever the number of threads.
+template <bentley_ottmann_traits Traits, std::ranges::view SegmentIdRange,
+          mapping_view<std::ranges::range_value_t<SegmentIdRange>> SegmentMap =
+              maps::identity_map>
+    requires std::ranges::forward_range<SegmentIdRange>
+class parallel_bentley_ottmann {
+private:
+    using segment_id_type = std::ranges::range_value_t<SegmentIdRange>;
+    using segment_type = typename Traits::segment_type;
+    using endpoint_type =
+        std::common_type_t<decltype(std::get<0>(std::declval<segment_type>())),
+                           decltype(std::get<1>(std::declval<segment_type>()))>;
+    using abscissa_type = std::decay_t<decltype(std::get<0>(
+        std::declval<endpoint_type>()))>;
+    using intersection_type = typename Traits::intersection_type;
+    using intersection_entry =
+        std::pair<intersection_type, std::vector<segment_id_type>>;
+
+    // More slabs than threads, claimed dynamically: crossings are rarely
+    // spread evenly along the x axis.
+    static constexpr std::size_t slabs_per_thread = 4;
+
+private:
+    SegmentIdRange _segment_ids_range;
+    [[no_unique_address]] SegmentMap _segment_map;
+    bool _converged;
+    std::size_t _num_threads;
+    std::vector<intersection_entry> _intersections;
+
+public:
+    template <typename SIR, mapping_for<SegmentMap> SM = maps::identity_map>
+        requires detail::not_self<SIR, parallel_bentley_ottmann> &&
+                     std::ranges::forward_range<SIR> &&
+                     std::constructible_from<SegmentIdRange,
+                                             std::views::all_t<SIR>>
+    parallel_bentley_ottmann(SIR && segments_ids_range, SM && segment_map = {})
+        : _segment_ids_range(
+              std::views::all(std::forward<SIR>(segments_ids_range)))
+        , _segment_map(maps::mapping_all(std::forward<SM>(segment_map)))
+        , _converged(false)
+        , _num_threads(detail::default_num_threads()) {}
+
+    template <typename... Args>
+        requires std::constructible_from<parallel_bentley_ottmann, Args...>
+    parallel_bentley_ottmann(Traits, Args &&... args)
+        : parallel_bentley_ottmann(std::forward<Args>(args)...) {}
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    parallel_bentley_ottmann(const parallel_bentley_ottmann &) = delete;
+    parallel_bentley_ottmann(parallel_bentley_ottmann &&) = default;
+
+    parallel_bentley_ottmann & operator=(const parallel_bentley_ottmann &) =
+        delete;
+    parallel_bentley_ottmann & operator=(parallel_bentley_ottmann &&) =
+        default;
+
+    // std::thread::hardware_concurrency() by default; 1 runs a single sweep on
+    // the calling thread.
+    parallel_bentley_ottmann & set_num_threads(const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
+    parallel_bentley_ottmann & reset() noexcept {
+        _converged = false;
+        return *this;
+    }
+
+private:
+    // Strictly increasing, and one fewer than the slabs: slab j spans
+    // [boundaries[j - 1], boundaries[j]), unbounded at both ends.
+    [[nodiscard]] std::vector<abscissa_type> slab_boundaries(
+        const std::size_t num_slabs) const {
+        std::vector<abscissa_type> leftmost;
+        for(auto && s : _segment_ids_range) {
+            const auto & [p1, p2] = _segment_map[s];
+            leftmost.emplace_back(std::min(std::get<0>(p1), std::get<0>(p2)));
+        }
+        std::vector<abscissa_type> boundaries;
+        if(leftmost.empty()) return boundaries;
+        auto first = leftmost.begin();
+        for(std::size_t k = 1; k < num_slabs; ++k) {
+            const auto nth = leftmost.begin() + static_cast<std::ptrdiff_t>(
+                                                    leftmost.size() * k /
+                                                    num_slabs);
+            std::nth_element(first, nth, leftmost.end());
+            boundaries.push_back(*nth);
+            first = nth;
+        }
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end(),
+                                     [](const auto & a, const auto & b) {
+                                         return !(a < b) && !(b < a);
+                                     }),
+                         boundaries.end());
+        return boundaries;
+    }
+
+    [[nodiscard]] static std::size_t slab_of(
+        const std::vector<abscissa_type> & boundaries, const abscissa_type & x) {
+        return static_cast<std::size_t>(
+            std::upper_bound(boundaries.begin(), boundaries.end(), x) -
+            boundaries.begin());
+    }
+
+    void sweep_slab(const std::vector<abscissa_type> & boundaries,
+                    const std::size_t j,
+                    const std::vector<segment_id_type> & segment_ids,
+                    std::vector<intersection_entry> & found) const {
+        bentley_ottmann alg(Traits{}, segment_ids, _segment_map);
+        for(; !alg.finished(); alg.advance()) {
+            const auto & [p, intersecting_segments] = alg.current();
+            // x >= hi: the rest belongs to the next slabs
+            if(j < boundaries.size() && !(std::get<0>(p) < boundaries[j]))
+                break;
+            // x < lo: the previous slabs have it
+            if(j > 0 && std::get<0>(p) < boundaries[j - 1]) continue;
+            found.emplace_back(p, std::vector<segment_id_type>(
+                                      intersecting_segments.begin(),
+                                      intersecting_segments.end()));
+        }
+    }
+
+public:
+    // Not noexcept: it spawns the worker threads, and the segment map and the
+    // sweeps may throw on any of them; the first exception thrown there is
+    // rethrown here once the other threads have stopped. The segment map is
+    // read from several threads at once.
+    parallel_bentley_ottmann & run() {
+        if(_converged) return *this;
+        const std::vector<abscissa_type> boundaries =
+            slab_boundaries(_num_threads == 1 ? 1
+                                              : slabs_per_thread * _num_threads);
+        // in the order of the id range, which each sweep seeds its events in
+        std::vector<std::vector<segment_id_type>> slab_segments(
+            boundaries.size() + 1);
+        for(auto && s : _segment_ids_range) {
+            const auto & [p1, p2] = _segment_map[s];
+            const auto & [x_min, x_max] =
+                std::minmax(std::get<0>(p1), std::get<0>(p2));
+            const std::size_t last = slab_of(boundaries, x_max);
+            for(std::size_t j = slab_of(boundaries, x_min); j <= last; ++j)
+                slab_segments[j].push_back(s);
+        }
+
+        std::vector<std::vector<intersection_entry>> slab_intersections(
+            slab_segments.size());
+        detail::thread_team team(std::min(_num_threads, slab_segments.size()));
+        detail::parallel_for(
+            team, slab_segments.size(), 1,
+            [&](std::size_t first, const std::size_t last, std::size_t) {
+                for(; first < last; ++first)
+                    sweep_slab(boundaries, first, slab_segments[first],
+                               slab_intersections[first]);
+            });
+
+        _intersections.resize(0);
+        for(auto && found : slab_intersections)
+            std::ranges::move(found, std::back_inserter(_intersections));
+        _converged = true;
+        return *this;
+    }
+
+    // Precondition: run() has converged. Each entry is an intersection point
+    // and every segment id passing through it, in lexicographic order of the
+    // point, as bentley_ottmann yields them.
+    [[nodiscard]] std::span<const intersection_entry> intersections()
+        const noexcept {
+        assert(_converged);
+        return _intersections;
+    }
+};
+
+template <typename SegmentIdRange>
+parallel_bentley_ottmann(SegmentIdRange &&) -> parallel_bentley_ottmann<
+    bentley_ottmann_default_traits<std::ranges::range_value_t<SegmentIdRange>>,
+    std::views::all_t<SegmentIdRange>, maps::identity_map>;
+
+template <typename SegmentIdRange, typename SegmentMap>
+parallel_bentley_ottmann(SegmentIdRange &&, SegmentMap &&)
+    -> parallel_bentley_ottmann<
+        bentley_ottmann_default_traits<
+            mapped_value_t<maps::mapping_all_t<SegmentMap>,
+                           std::ranges::range_value_t<SegmentIdRange>>>,
+        std::views::all_t<SegmentIdRange>, maps::mapping_all_t<SegmentMap>>;
+
+template <typename SegmentIdRange, typename Traits>
+parallel_bentley_ottmann(Traits, SegmentIdRange &&)
+    -> parallel_bentley_ottmann<Traits, std::views::all_t<SegmentIdRange>,
+                                maps::identity_map>;
+
+template <typename SegmentIdRange, typename SegmentMap, typename Traits>
+parallel_bentley_ottmann(Traits, SegmentIdRange &&, SegmentMap &&)
+    -> parallel_bentley_ottmann<Traits, std::views::all_t<SegmentIdRange>,
+                                maps::mapping_all_t<SegmentMap>>;
+
+}  // namespace melon
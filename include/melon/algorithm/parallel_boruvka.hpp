@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "melon/container/concurrent_disjoint_sets.hpp"
+#include "melon/detail/parallel_partition.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/undirected_graph.hpp"
+
+namespace melon {
+
+// Borůvka's minimum spanning forest, each round split across threads:
+//  - every component picks its lightest incident edge, by an atomic minimum
+//    over the edges it shares with the others, all edges in parallel;
+//  - the components are hooked along the picked edges through a
+//    concurrent_disjoint_sets, all components in parallel;
+//  - the graph is contracted by relabelling the endpoints of every edge with
+//    their new component, and the edges now inside one are dropped.
+// Each round at least halves the number of components, so there are at most
+// log2(n) of them, and every one is O(m + n) work over what is left.
+//
+// Ties are broken by the position of the edge in the edge list, a total order,
+// so the picked edges never close a cycle and the forest is the same for any
+// number of threads: the one kruskal would pick with a stable sort.
+template <undirected_graph_view UGraph, mapping_view<edge_t<UGraph>> CostMap>
+    requires has_vertex_map<UGraph> &&
+             std::totally_ordered<mapped_value_t<CostMap, edge_t<UGraph>>>
+class parallel_boruvka {
+private:
+    using vertex = vertex_t<UGraph>;
+    using edge = edge_t<UGraph>;
+    using cost_type = mapped_value_t<CostMap, edge>;
+
+    static constexpr std::size_t grain = 1024;
+    static constexpr std::size_t no_edge =
+        std::numeric_limits<std::size_t>::max();
+
+    // Endpoints are component positions, rewritten at every contraction.
+    struct edge_entry {
+        edge e;
+        cost_type cost;
+        std::size_t source;
+        std::size_t target;
+    };
+
+private:
+    UGraph _ugraph;
+    CostMap _cost_map;
+    bool _converged;
+    std::size_t _num_threads;
+    std::vector<edge_entry> _entries;
+    std::vector<edge_entry> _scratch;
+    std::vector<unsigned char> _classes;
+    // the components still having edges, by their root
+    std::vector<std::size_t> _components;
+    // per root: its lightest incident edge, no_edge between rounds; per edge:
+    // whether a root was hooked along it this round
+    std::vector<std::size_t> _lightest_edge;
+    std::vector<unsigned char> _hooked_along;
+    concurrent_disjoint_sets<std::size_t> _components_sets;
+    std::vector<edge> _tree_edges;
+    cost_type _total_cost;
+
+public:
+    template <undirected_graph_for<UGraph> UG, mapping_for<CostMap> CM>
+    parallel_boruvka(UG && ug, CM && cm)
+        : _ugraph(views::undirected_graph_all(std::forward<UG>(ug)))
+        , _cost_map(maps::mapping_all(std::forward<CM>(cm)))
+        , _converged(false)
+        , _num_threads(detail::default_num_threads())
+        , _total_cost() {}
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    parallel_boruvka(const parallel_boruvka &) = delete;
+    parallel_boruvka(parallel_boruvka &&) = default;
+
+    parallel_boruvka & operator=(const parallel_boruvka &) = delete;
+    parallel_boruvka & operator=(parallel_boruvka &&) = default;
+
+    [[nodiscard]] constexpr UGraph & base() & noexcept { return _ugraph; }
+    [[nodiscard]] constexpr const UGraph & base() const & noexcept {
+        return _ugraph;
+    }
+    [[nodiscard]] constexpr UGraph && base() && noexcept {
+        return std::move(_ugraph);
+    }
+    [[nodiscard]] constexpr const UGraph && base() const && noexcept {
+        return std::move(_ugraph);
+    }
+
+    // std::thread::hardware_concurrency() by default; 1 runs the same rounds
+    // on the calling thread.
+    parallel_boruvka & set_num_threads(const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
+    parallel_boruvka & reset() noexcept {
+        _converged = false;
+        return *this;
+    }
+
+private:
+    [[nodiscard]] bool lighter(const std::size_t i,
+                               const std::size_t j) const noexcept {
+        if(_entries[i].cost < _entries[j].cost) return true;
+        if(_entries[j].cost < _entries[i].cost) return false;
+        return i < j;
+    }
+
+    void offer(const std::size_t root, const std::size_t i) noexcept {
+        std::atomic_ref<std::size_t> lightest(_lightest_edge[root]);
+        std::size_t current = lightest.load(std::memory_order_relaxed);
+        while(current == no_edge || lighter(i, current)) {
+            if(lightest.compare_exchange_weak(current, i,
+                                              std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    template <typename Body>
+    static void for_each_index(detail::thread_team & team,
+                               const std::size_t count, Body && body) {
+        detail::parallel_for(
+            team, count, grain,
+            [&](std::size_t first, const std::size_t last, std::size_t) {
+                for(; first < last; ++first) body(first);
+            });
+    }
+
+    // The edge list with component positions for endpoints, self-loops left
+    // out, and the components that have an edge.
+    void fill_entries() {
+        auto position_map = create_vertex_map<std::size_t>(_ugraph);
+        std::size_t num_vertices = 0;
+        for(auto && v : vertices(_ugraph)) position_map[v] = num_vertices++;
+        _components_sets.resize(num_vertices);
+        _lightest_edge.assign(num_vertices, no_edge);
+
+        _entries.resize(0);
+        if constexpr(has_num_edges<UGraph>) {
+            _entries.reserve(num_edges(_ugraph));
+        }
+        std::vector<unsigned char> has_edge(num_vertices, false);
+        for(auto && e : edges(_ugraph)) {
+            auto && [u, v] = edge_endpoints(_ugraph, e);
+            const std::size_t pu = position_map[u], pv = position_map[v];
+            if(pu == pv) continue;
+            _entries.push_back({e, _cost_map[e], pu, pv});
+            has_edge[pu] = has_edge[pv] = true;
+        }
+        _scratch.resize(_entries.size());
+        _classes.resize(_entries.size());
+        _hooked_along.assign(_entries.size(), false);
+        _components.resize(0);
+        for(std::size_t c = 0; c < num_vertices; ++c)
+            if(has_edge[c]) _components.push_back(c);
+    }
+
+public:
+    // Not noexcept: it allocates, runs the user's cost map and spawns the
+    // worker threads.
+    parallel_boruvka & run() {
+        if(_converged) return *this;
+        fill_entries();
+        _tree_edges.resize(0);
+        _total_cost = cost_type();
+        detail::thread_team team(_num_threads);
+
+        while(!_entries.empty()) {
+            for_each_index(team, _entries.size(), [this](const std::size_t i) {
+                offer(_entries[i].source, i);
+                offer(_entries[i].target, i);
+            });
+            // the lightest edge of a component is never inside it, so unite
+            // fails only for an edge picked by both of its endpoints
+            for_each_index(
+                team, _components.size(), [this](const std::size_t k) {
+                    const std::size_t i = _lightest_edge[_components[k]];
+                    if(i == no_edge) return;
+                    if(_components_sets.unite(_entries[i].source,
+                                              _entries[i].target))
+                        _hooked_along[i] = true;
+                });
+            for(auto && c : _components) {
+                const std::size_t i = std::exchange(_lightest_edge[c], no_edge);
+                if(i == no_edge || !_hooked_along[i]) continue;
+                _hooked_along[i] = false;
+                _tree_edges.push_back(_entries[i].e);
+                _total_cost += _entries[i].cost;
+            }
+
+            // contraction
+            const auto bounds = detail::stable_partition<1>(
+                &team, std::span(_entries), std::span(_scratch),
+                std::span(_classes), [this](edge_entry & entry) {
+                    entry.source = _components_sets.find(entry.source);
+                    entry.target = _components_sets.find(entry.target);
+                    return entry.source == entry.target ? std::size_t{1}
+                                                        : std::size_t{0};
+                });
+            _entries.resize(bounds[1]);
+            // the hooked ones, and those left without edges to pick
+            std::erase_if(_components, [this](const std::size_t c) {
+                return _components_sets.find(c) != c;
+            });
+        }
+        _converged = true;
+        return *this;
+    }
+
+    // The two below: precondition, run() has converged.
+    [[nodiscard]] std::span<const edge> tree_edges() const noexcept {
+        assert(_converged);
+        return _tree_edges;
+    }
+    [[nodiscard]] cost_type total_cost() const noexcept {
+        assert(_converged);
+        return _total_cost;
+    }
+};
+
+template <typename UGraph, typename CostMap>
+parallel_boruvka(UGraph &&, CostMap &&)
+    -> parallel_boruvka<views::undirected_graph_all_t<UGraph>,
+                        maps::mapping_all_t<CostMap>>;
+
+}  // namespace melon
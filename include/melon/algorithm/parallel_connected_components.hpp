@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "melon/container/concurrent_disjoint_sets.hpp"
+#include "melon/detail/not_self.hpp"
+#include "melon/detail/specialization_of.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/undirected_graph.hpp"
+#include "melon/views/undirect.hpp"
+
+namespace melon {
+
+// Sutton, Ben-Nun and Bar-Noy's Afforest: the connected components of an
+// undirected graph by a concurrent union-find over its edges, split across
+// threads. Each vertex first links to its first two neighbours only, which on
+// most real graphs already gathers the bulk of the vertices into one giant
+// component; that component is spotted by sampling, and the vertices in it
+// skip their remaining edges -- an edge leaving it is still seen from its
+// other end, incidence being symmetric. Only the vertices outside it link
+// along the rest of their edges.
+//
+// The union-find is a concurrent_disjoint_sets over the positions of the
+// vertices in vertices(g). It roots every set at its smallest position, so the
+// labels, dense and numbered in the order of each component's first vertex,
+// are the same for any number of threads. O(m alpha(n)) work.
+template <undirected_graph_view UGraph>
+    requires has_incidence<UGraph> && has_vertex_map<UGraph>
+class parallel_connected_components {
+private:
+    using vertex = vertex_t<UGraph>;
+
+    // Neighbours linked by every vertex before the giant component is
+    // sampled, and the number of samples: the paper's choices.
+    static constexpr std::size_t neighbor_rounds = 2;
+    static constexpr std::size_t num_samples = 1024;
+    static constexpr std::size_t grain = 1024;
+
+    // Then a vertex may be its own position, see position().
+    static constexpr bool iota_vertices =
+        std::integral<vertex> &&
+        detail::specialization_of<vertices_range_t<UGraph>,
+                                  std::ranges::iota_view>;
+
+private:
+    UGraph _graph;
+    bool _converged;
+    std::size_t _num_threads;
+    std::vector<vertex> _vertices;
+    bool _vertices_are_positions;
+    concurrent_disjoint_sets<std::size_t> _sets;
+    // the position of each vertex until the unions are done, then its label
+    vertex_map_t<UGraph, std::size_t> _component_map;
+    std::vector<std::size_t> _component_sizes;
+
+public:
+    template <typename UG>
+        requires detail::not_self<UG, parallel_connected_components> &&
+                     undirected_graph_for<UG, UGraph>
+    explicit parallel_connected_components(UG && g)
+        : _graph(views::undirected_graph_all(std::forward<UG>(g)))
+        , _converged(false)
+        , _num_threads(detail::default_num_threads())
+        , _component_map(create_vertex_map<std::size_t>(_graph)) {
+        for(auto && v : vertices(_graph)) _vertices.push_back(v);
+        _vertices_are_positions =
+            iota_vertices && (_vertices.empty() || _vertices.front() == 0);
+        _sets.resize(_vertices.size());
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    parallel_connected_components(const parallel_connected_components &) =
+        delete;
+    parallel_connected_components(parallel_connected_components &&) = default;
+
+    parallel_connected_components & operator=(
+        const parallel_connected_components &) = delete;
+    parallel_connected_components & operator=(
+        parallel_connected_components &&) = default;
+
+    [[nodiscard]] constexpr UGraph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const UGraph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr UGraph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const UGraph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    // std::thread::hardware_concurrency() by default; 1 runs the same phases
+    // on the calling thread.
+    parallel_connected_components & set_num_threads(
+        const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
+    parallel_connected_components & reset() noexcept {
+        _converged = false;
+        return *this;
+    }
+
+private:
+    // On vertices that count up from 0 -- those of every melon container -- a
+    // vertex is its own position, which spares a random access per edge.
+    [[nodiscard]] std::size_t position(const vertex & v) const {
+        if constexpr(iota_vertices)
+            if(_vertices_are_positions) return static_cast<std::size_t>(v);
+        return _component_map[v];
+    }
+
+    template <typename Body>
+    void for_each_position(detail::thread_team & team, Body && body) {
+        detail::parallel_for(
+            team, _vertices.size(), grain,
+            [&](std::size_t first, const std::size_t last, std::size_t) {
+                for(; first < last; ++first) body(first);
+            });
+    }
+
+    // The most frequent root among a fixed sample of vertices.
+    [[nodiscard]] std::size_t most_frequent_root() {
+        std::vector<std::size_t> sample(num_samples);
+        std::minstd_rand engine(0);
+        std::uniform_int_distribution<std::size_t> pick(0,
+                                                        _vertices.size() - 1);
+        for(auto && s : sample) s = _sets.find(pick(engine));
+        std::ranges::sort(sample);
+        std::size_t best = sample[0];
+        std::size_t best_count = 0;
+        for(std::size_t i = 0; i < sample.size();) {
+            std::size_t j = i;
+            while(j < sample.size() && sample[j] == sample[i]) ++j;
+            if(j - i > best_count) {
+                best = sample[i];
+                best_count = j - i;
+            }
+            i = j;
+        }
+        return best;
+    }
+
+    // Each root precedes the rest of its set, so one pass in position order
+    // meets it, and labels it, first.
+    void label_components(detail::thread_team & team) {
+        for_each_position(team, [this](const std::size_t i) {
+            _component_map[_vertices[i]] = _sets.find(i);
+        });
+        _component_sizes.clear();
+        for(std::size_t i = 0; i < _vertices.size(); ++i) {
+            const std::size_t root = _component_map[_vertices[i]];
+            if(root == i) {
+                _component_map[_vertices[i]] = _component_sizes.size();
+                _component_sizes.push_back(0);
+            } else {
+                _component_map[_vertices[i]] = _component_map[_vertices[root]];
+            }
+            ++_component_sizes[_component_map[_vertices[i]]];
+        }
+    }
+
+public:
+    // Not noexcept: it spawns the worker threads, and the graph's incidence
+    // ranges may allocate on any of them; the first exception thrown there is
+    // rethrown here once the other threads have stopped.
+    parallel_connected_components & run() {
+        if(_converged) return *this;
+        detail::thread_team team(_num_threads);
+        _sets.reset();
+        for_each_position(team, [this](const std::size_t i) {
+            _component_map[_vertices[i]] = i;
+        });
+        if(!_vertices.empty()) {
+            for(std::size_t round = 0; round < neighbor_rounds; ++round) {
+                for_each_position(team, [this, round](const std::size_t i) {
+                    auto && neighbors = incidence(_graph, _vertices[i]);
+                    auto it = std::ranges::begin(neighbors);
+                    const auto end = std::ranges::end(neighbors);
+                    for(std::size_t k = 0; k < round && it != end; ++k) ++it;
+                    if(it != end)
+                        _sets.unite(i, position(std::get<1>(*it)));
+                });
+            }
+
+            const std::size_t giant = most_frequent_root();
+            for_each_position(team, [this, giant](const std::size_t i) {
+                if(_sets.find(i) == giant) return;
+                std::size_t k = 0;
+                for(auto && [e, w] : incidence(_graph, _vertices[i]))
+                    if(k++ >= neighbor_rounds) _sets.unite(i, position(w));
+            });
+        }
+        label_components(team);
+        _converged = true;
+        return *this;
+    }
+
+    // The three below and the two maps: precondition, run() has converged.
+    [[nodiscard]] std::size_t num_components() const noexcept {
+        assert(_converged);
+        return _component_sizes.size();
+    }
+    [[nodiscard]] std::size_t component(const vertex & u) const
+        noexcept(noexcept(_component_map[u])) {
+        assert(_converged);
+        return _component_map[u];
+    }
+    [[nodiscard]] std::span<const std::size_t> component_sizes()
+        const noexcept {
+        assert(_converged);
+        return _component_sizes;
+    }
+
+    // Refers into the algorithm, like every melon map view: valid while this
+    // object lives and stays put.
+    [[nodiscard]] auto components_map() const & noexcept(
+        noexcept(maps::mapping_all(_component_map))) {
+        assert(_converged);
+        return maps::mapping_all(_component_map);
+    }
+    // Terminal, like std::move(alg).base(): the member left behind is valid but
+    // empty, so no other member may be called afterwards.
+    [[nodiscard]] auto components_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_component_map)))) {
+        assert(_converged);
+        return maps::mapping_all(std::move(_component_map));
+    }
+};
+
+template <typename UGraph>
+parallel_connected_components(UGraph &&)
+    -> parallel_connected_components<views::undirected_graph_all_t<UGraph>>;
+
+// As weakly_connected_components: the digraph is undirected first, so that
+// every arc is seen from both of its ends.
+template <graph Graph>
+    requires outward_incidence_graph<Graph> && inward_incidence_graph<Graph> &&
+             has_vertex_map<Graph>
+auto parallel_weakly_connected_components(Graph && g) {
+    return parallel_connected_components(
+        views::undirect(std::forward<Graph>(g)));
+}
+
+}  // namespace melon
@@ -0,0 +1,413 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <type_traits>
+#include <vector>
+
+#include "melon/detail/thread_team.hpp"
+#include "melon/graph.hpp"
+#include "melon/mapping.hpp"
+
+namespace melon {
+
+// A multi-threaded push-relabel maximum flow: rounds of concurrent discharges
+// over a shared worklist of active vertices, in the style of Hong's lock-free
+// algorithm, interleaved with parallel global relabelings. Excesses, heights
+// and flows are updated through std::atomic_ref, so the graph's vertex and arc
+// maps must hand out lvalues of the value type.
+//
+// flow_value() is the same for any number of threads, the maximum flow value
+// being unique; the per-arc flows are a maximum flow but not necessarily the
+// same one from one run to the next. Capacities must be non-negative.
+// O(n^2 m) discharge steps, split across the threads.
+template <graph_view Graph, mapping_view<arc_t<Graph>> CapacityMap>
+    requires outward_incidence_graph<Graph> && inward_incidence_graph<Graph> &&
+             has_vertex_map<Graph> && has_arc_map<Graph> &&
+             std::is_arithmetic_v<mapped_value_t<CapacityMap, arc_t<Graph>>> &&
+             std::is_lvalue_reference_v<mapped_reference_t<
+                 arc_map_t<Graph, mapped_value_t<CapacityMap, arc_t<Graph>>>,
+                 arc_t<Graph>>> &&
+             std::is_lvalue_reference_v<mapped_reference_t<
+                 vertex_map_t<Graph, std::size_t>, vertex_t<Graph>>>
+class parallel_push_relabel {
+private:
+    using vertex = vertex_t<Graph>;
+    using arc = arc_t<Graph>;
+    using value_t = mapped_value_t<CapacityMap, arc_t<Graph>>;
+
+    // Large enough that one thread's scheduling overhead is amortized, small
+    // enough that a round over a few hundred active vertices still spreads.
+    static constexpr std::size_t grain = 64;
+
+private:
+    Graph _graph;
+    CapacityMap _capacity_map;
+    vertex _s;
+    vertex _t;
+    // Unconditional, not `#ifndef NDEBUG`: melon is header-only, so a layout
+    // that depends on NDEBUG differs between translation units of one program
+    // -- an ODR violation no test and no sanitizer sees.
+    bool _source_set;
+    bool _target_set;
+    bool _converged;
+    std::size_t _num_threads;
+    std::vector<vertex> _vertices;
+    std::size_t _num_arcs;
+    arc_map_t<Graph, value_t> _carried_flow_map;
+    vertex_map_t<Graph, value_t> _excess_map;
+    vertex_map_t<Graph, std::size_t> _height_map;
+    // char, not bool: a vertex map of bool may be a packed std::vector<bool>,
+    // whose proxies std::atomic_ref cannot bind to.
+    vertex_map_t<Graph, char> _queued_map;
+    std::vector<vertex> _active;
+    std::vector<vertex> _next_active;
+
+public:
+    // Leaves the terminals unset -- run(), flow_value() and minimum_cut() all
+    // read them, so set_source() and set_target() must be called first.
+    template <graph_for<Graph> G, mapping_for<CapacityMap> CM>
+    parallel_push_relabel(G && g, CM && cm)
+        : _graph(views::graph_all(std::forward<G>(g)))
+        , _capacity_map(maps::mapping_all(std::forward<CM>(cm)))
+        , _source_set(false)
+        , _target_set(false)
+        , _converged(false)
+        , _num_threads(detail::default_num_threads())
+        , _num_arcs(
+              static_cast<std::size_t>(std::ranges::distance(arcs(_graph))))
+        , _carried_flow_map(create_arc_map<value_t>(_graph))
+        , _excess_map(create_vertex_map<value_t>(_graph))
+        , _height_map(create_vertex_map<std::size_t>(_graph))
+        , _queued_map(create_vertex_map<char>(_graph)) {
+        std::ranges::copy(vertices(_graph), std::back_inserter(_vertices));
+        _active.resize(_vertices.size());
+        _next_active.resize(_vertices.size());
+        reset();
+    }
+
+    template <graph_for<Graph> G, mapping_for<CapacityMap> CM>
+    parallel_push_relabel(G && g, CM && cm, const vertex & s, const vertex & t)
+        : parallel_push_relabel(std::forward<G>(g), std::forward<CM>(cm)) {
+        set_source(s);
+        set_target(t);
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    // The worker threads live inside run(), so nothing here refers to `this`.
+    parallel_push_relabel(const parallel_push_relabel &) = delete;
+    parallel_push_relabel(parallel_push_relabel &&) = default;
+
+    parallel_push_relabel & operator=(const parallel_push_relabel &) = delete;
+    parallel_push_relabel & operator=(parallel_push_relabel &&) = default;
+
+    [[nodiscard]] constexpr Graph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const Graph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr Graph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const Graph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    parallel_push_relabel & set_source(const vertex & s) {
+        _s = s;
+        _source_set = true;
+        _converged = false;
+        return *this;
+    }
+
+    parallel_push_relabel & set_target(const vertex & t) {
+        _t = t;
+        _target_set = true;
+        _converged = false;
+        return *this;
+    }
+
+    // Defaults to std::thread::hardware_concurrency(). A single thread runs
+    // the same rounds on the calling thread alone.
+    parallel_push_relabel & set_num_threads(const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
+    parallel_push_relabel & reset() {
+        _converged = false;
+        for(auto && a : arcs(_graph)) _carried_flow_map[a] = value_t{0};
+        for(const vertex & v : _vertices) _excess_map[v] = value_t{0};
+        return *this;
+    }
+
+private:
+    // A vertex with no residual path to either terminal. Excess never sits on
+    // one -- every unit of excess can still flow back to the source -- so the
+    // value only has to exceed every real height, 2n - 1 at most.
+    [[nodiscard]] std::size_t unreached_height() const noexcept {
+        return 2 * _vertices.size();
+    }
+
+    [[nodiscard]] auto height_ref(const vertex & v) {
+        return std::atomic_ref<std::size_t>(_height_map[v]);
+    }
+    [[nodiscard]] auto excess_ref(const vertex & v) {
+        return std::atomic_ref<value_t>(_excess_map[v]);
+    }
+    [[nodiscard]] auto flow_ref(const arc & a) {
+        return std::atomic_ref<value_t>(_carried_flow_map[a]);
+    }
+
+    void initialize_preflow() {
+        reset();
+        for(auto && a : out_arcs(_graph, _s)) {
+            const vertex w = arc_target(_graph, a);
+            if(w == _s) continue;
+            _carried_flow_map[a] = _capacity_map[a];
+            _excess_map[w] += _capacity_map[a];
+        }
+    }
+
+    // Level-synchronous BFS over the reversed residual network, from the
+    // `frontier_size` vertices at the front of _active. Heights are claimed
+    // with a compare-exchange from unreached_height(), so each vertex joins
+    // exactly one level however many threads reach it at once.
+    void parallel_reverse_bfs(detail::thread_team & team,
+                              std::size_t frontier_size) {
+        while(frontier_size > 0) {
+            std::atomic<std::size_t> next_size{0};
+            const auto claim = [&](const vertex & v, const std::size_t h) {
+                std::size_t expected = unreached_height();
+                if(!height_ref(v).compare_exchange_strong(expected, h)) return;
+                _next_active[next_size.fetch_add(1)] = v;
+            };
+            detail::parallel_for(
+                team, frontier_size, grain,
+                [&](std::size_t first, const std::size_t last, std::size_t) {
+                    for(; first < last; ++first) {
+                        const vertex u = _active[first];
+                        const std::size_t h = height_ref(u).load() + 1;
+                        for(auto && a : in_arcs(_graph, u)) {
+                            if(_carried_flow_map[a] == _capacity_map[a])
+                                continue;
+                            claim(arc_source(_graph, a), h);
+                        }
+                        for(auto && a : out_arcs(_graph, u)) {
+                            if(_carried_flow_map[a] == value_t{0}) continue;
+                            claim(arc_target(_graph, a), h);
+                        }
+                    }
+                });
+            std::swap(_active, _next_active);
+            frontier_size = next_size.load();
+        }
+    }
+
+    // Exact distance labels: to the target below n, to the source from n on.
+    // Returns the number of active vertices, gathered at the front of _active.
+    std::size_t global_relabel(detail::thread_team & team) {
+        detail::parallel_for(team, _vertices.size(), grain * 16,
+                             [&](std::size_t first, const std::size_t last,
+                                 std::size_t) {
+                                 for(; first < last; ++first)
+                                     _height_map[_vertices[first]] =
+                                         unreached_height();
+                             });
+        _height_map[_s] = _vertices.size();
+        _height_map[_t] = 0;
+        _active[0] = _t;
+        parallel_reverse_bfs(team, 1);
+        _active[0] = _s;
+        parallel_reverse_bfs(team, 1);
+
+        std::atomic<std::size_t> num_active{0};
+        detail::parallel_for(
+            team, _vertices.size(), grain * 16,
+            [&](std::size_t first, const std::size_t last, std::size_t) {
+                for(; first < last; ++first) {
+                    const vertex & v = _vertices[first];
+                    const bool active =
+                        v != _s && v != _t && _excess_map[v] > value_t{0};
+                    _queued_map[v] = active ? 1 : 0;
+                    if(active) _active[num_active.fetch_add(1)] = v;
+                }
+            });
+        return num_active.load();
+    }
+
+    void enqueue(const vertex & w, std::atomic<std::size_t> & next_size) {
+        if(std::atomic_ref<char>(_queued_map[w]).exchange(1) != 0) return;
+        _next_active[next_size.fetch_add(1)] = w;
+    }
+
+    // Hong's discharge: push to the lowest residual neighbour if it is below
+    // u, relabel u just above it otherwise. Its correctness without locks
+    // rests on two invariants. Only the thread discharging u ever lowers a
+    // residual capacity out of u or raises u's height, which holds because a
+    // vertex appears at most once per round in _active. And pushes go to the
+    // *lowest* neighbour only: pushing along every admissible arc found by the
+    // scan, as the sequential algorithm may, lets two stale height reads
+    // bounce the same excess back and forth forever.
+    std::size_t discharge(const vertex & u,
+                          std::atomic<std::size_t> & next_size) {
+        std::atomic_ref<char>(_queued_map[u]).store(0);
+        std::size_t work = 0;
+        for(;;) {
+            const value_t excess = excess_ref(u).load();
+            if(!(excess > value_t{0})) break;
+
+            std::size_t lowest_height = std::numeric_limits<std::size_t>::max();
+            arc lowest_arc{};
+            vertex lowest_neighbor{};
+            value_t lowest_residual{0};
+            bool forward = true;
+            for(auto && a : out_arcs(_graph, u)) {
+                ++work;
+                const vertex w = arc_target(_graph, a);
+                if(w == u) continue;
+                const value_t residual = _capacity_map[a] - flow_ref(a).load();
+                if(!(residual > value_t{0})) continue;
+                const std::size_t h = height_ref(w).load();
+                if(h >= lowest_height) continue;
+                lowest_height = h;
+                lowest_arc = a;
+                lowest_neighbor = w;
+                lowest_residual = residual;
+                forward = true;
+            }
+            for(auto && a : in_arcs(_graph, u)) {
+                ++work;
+                const vertex w = arc_source(_graph, a);
+                if(w == u) continue;
+                const value_t residual = flow_ref(a).load();
+                if(!(residual > value_t{0})) continue;
+                const std::size_t h = height_ref(w).load();
+                if(h >= lowest_height) continue;
+                lowest_height = h;
+                lowest_arc = a;
+                lowest_neighbor = w;
+                lowest_residual = residual;
+                forward = false;
+            }
+            if(lowest_height == std::numeric_limits<std::size_t>::max()) break;
+
+            if(height_ref(u).load() <= lowest_height) {
+                height_ref(u).store(lowest_height + 1);
+                continue;
+            }
+            const value_t delta = std::min(excess, lowest_residual);
+            if(forward)
+                flow_ref(lowest_arc).fetch_add(delta);
+            else
+                flow_ref(lowest_arc).fetch_sub(delta);
+            excess_ref(u).fetch_sub(delta);
+            const value_t previous = excess_ref(lowest_neighbor).fetch_add(delta);
+            if(!(previous > value_t{0}) && lowest_neighbor != _s &&
+               lowest_neighbor != _t)
+                enqueue(lowest_neighbor, next_size);
+        }
+        return work;
+    }
+
+public:
+    // Not noexcept: it spawns the worker threads and runs the caller's
+    // capacity map on every one of them; the first exception thrown there is
+    // rethrown here once the other threads have stopped.
+    parallel_push_relabel & run() {
+        assert(_source_set && _target_set);
+        if(_converged) return *this;
+        detail::thread_team team(_num_threads);
+        initialize_preflow();
+        // The global-relabel frequency of Baumstark, Blelloch and Shun: once
+        // the discharges since the last one have scanned about 6n + m arcs,
+        // the heights they steer by are stale enough that relabeling from
+        // scratch is the cheaper way forward.
+        const std::size_t relabel_threshold = 6 * _vertices.size() + _num_arcs;
+        std::size_t num_active = global_relabel(team);
+        std::size_t work_since_relabel = 0;
+        while(num_active > 0) {
+            std::atomic<std::size_t> next_size{0};
+            std::atomic<std::size_t> round_work{0};
+            detail::parallel_for(
+                team, num_active, 1,
+                [&](std::size_t first, const std::size_t last, std::size_t) {
+                    std::size_t work = 0;
+                    for(; first < last; ++first)
+                        work += discharge(_active[first], next_size);
+                    round_work.fetch_add(work, std::memory_order_relaxed);
+                });
+            work_since_relabel += round_work.load();
+            if(work_since_relabel >= relabel_threshold) {
+                num_active = global_relabel(team);
+                work_since_relabel = 0;
+            } else {
+                std::swap(_active, _next_active);
+                num_active = next_size.load();
+            }
+        }
+        // One last relabeling, for minimum_cut(): it leaves every vertex
+        // that still reaches the target below n.
+        global_relabel(team);
+        _converged = true;
+        return *this;
+    }
+
+    // The excess gathered at the target: zero after reset(), the maximum flow
+    // value once run() has converged.
+    [[nodiscard]] constexpr value_t flow_value() const {
+        assert(_target_set);
+        return _excess_map[_t];
+    }
+
+    [[nodiscard]] constexpr value_t flow(const arc & a) const
+        noexcept(noexcept(_carried_flow_map[a])) {
+        return _carried_flow_map[a];
+    }
+    // Refers into the algorithm, like every melon map view: valid while this
+    // object lives and stays put.
+    [[nodiscard]] constexpr auto flows_map() const & noexcept(
+        noexcept(maps::mapping_all(_carried_flow_map))) {
+        return maps::mapping_all(_carried_flow_map);
+    }
+    // Terminal, like std::move(alg).base(): the member left behind is valid but
+    // empty, so no other member may be called afterwards.
+    [[nodiscard]] constexpr auto flows_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_carried_flow_map)))) {
+        return maps::mapping_all(std::move(_carried_flow_map));
+    }
+
+    // Precondition: run() has converged. The cut separates the vertices that
+    // the final relabeling found below n -- those with a residual path to the
+    // target -- from the others, the target side dinitz reports too.
+    [[nodiscard]] constexpr auto minimum_cut() const {
+        assert(_converged);
+        return std::views::filter(
+            arcs(_graph), [this](const arc_t<Graph> & a) {
+                return _height_map[arc_source(_graph, a)] >=
+                           _vertices.size() &&
+                       _height_map[arc_target(_graph, a)] < _vertices.size();
+            });
+    }
+};
+
+template <typename Graph, typename CapacityMap>
+parallel_push_relabel(Graph &&, CapacityMap &&)
+    -> parallel_push_relabel<views::graph_all_t<Graph>,
+                             maps::mapping_all_t<CapacityMap>>;
+
+template <typename Graph, typename CapacityMap>
+parallel_push_relabel(Graph &&, CapacityMap &&, const vertex_t<Graph> &,
+                      const vertex_t<Graph> &)
+    -> parallel_push_relabel<views::graph_all_t<Graph>,
+                             maps::mapping_all_t<CapacityMap>>;
+
+}  // namespace melon
@@ -0,0 +1,435 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "melon/detail/not_self.hpp"
+#include "melon/detail/specialization_of.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/graph.hpp"
+#include "melon/views/graph_view.hpp"
+
+namespace melon {
+
+// The strongly connected components of a digraph, by McLendon, Hendrickson,
+// Plimpton and Rauchwerger's forward-backward decomposition in the Multistep
+// arrangement of Slota, Rajamanickam and Madduri, every phase split across
+// threads:
+//  - trimming: a vertex with no incoming or no outgoing arc among those left is
+//    a component of its own, and removing it may trim its neighbours in turn;
+//  - forward-backward: the vertices both reachable from and reaching a pivot
+//    of high degree form its component -- the giant one, on most graphs --
+//    found by two level-synchronous BFS over out_neighbors and in_neighbors;
+//  - colouring: each vertex left takes the largest vertex id that reaches it,
+//    and the vertices of colour r that reach r are r's component. It peels off
+//    the many small components in a few rounds.
+//
+// Labels are dense, numbered in the order of each component's first vertex in
+// vertices(g), so they are the same for any number of threads.
+template <graph_view Graph>
+    requires outward_adjacency_graph<Graph> && inward_adjacency_graph<Graph> &&
+             has_vertex_map<Graph>
+class parallel_strongly_connected_components {
+private:
+    using vertex = vertex_t<Graph>;
+
+    static constexpr std::size_t grain = 1024;
+    static constexpr std::size_t frontier_grain = 64;
+    static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    // Then a vertex may be its own position, see position().
+    static constexpr bool iota_vertices =
+        std::integral<vertex> &&
+        detail::specialization_of<vertices_range_t<Graph>,
+                                  std::ranges::iota_view>;
+
+    enum : unsigned char { forward_mark = 1, backward_mark = 2 };
+
+private:
+    Graph _graph;
+    bool _converged;
+    std::size_t _num_threads;
+    std::vector<vertex> _vertices;
+    bool _vertices_are_positions;
+    // the position of each vertex until the components are found, then its
+    // label
+    vertex_map_t<Graph, std::size_t> _component_map;
+    std::vector<std::size_t> _component_sizes;
+
+    // By position: the component representative, none while unassigned; the
+    // in and out degrees among the unassigned vertices; the colour; the marks
+    // of the searches.
+    std::vector<std::size_t> _representative;
+    std::vector<std::size_t> _in_degree;
+    std::vector<std::size_t> _out_degree;
+    std::vector<std::size_t> _color;
+    std::vector<unsigned char> _marks;
+    std::vector<std::size_t> _frontier;
+    std::vector<std::vector<std::size_t>> _local_frontiers;
+
+public:
+    template <typename G>
+        requires detail::not_self<G, parallel_strongly_connected_components> &&
+                     graph_for<G, Graph>
+    explicit parallel_strongly_connected_components(G && g)
+        : _graph(views::graph_all(std::forward<G>(g)))
+        , _converged(false)
+        , _num_threads(detail::default_num_threads())
+        , _component_map(create_vertex_map<std::size_t>(_graph)) {
+        for(auto && v : vertices(_graph)) _vertices.push_back(v);
+        _vertices_are_positions =
+            iota_vertices && (_vertices.empty() || _vertices.front() == 0);
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    parallel_strongly_connected_components(
+        const parallel_strongly_connected_components &) = delete;
+    parallel_strongly_connected_components(
+        parallel_strongly_connected_components &&) = default;
+
+    parallel_strongly_connected_components & operator=(
+        const parallel_strongly_connected_components &) = delete;
+    parallel_strongly_connected_components & operator=(
+        parallel_strongly_connected_components &&) = default;
+
+    [[nodiscard]] constexpr Graph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const Graph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr Graph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const Graph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    // std::thread::hardware_concurrency() by default; 1 runs the same phases
+    // on the calling thread.
+    parallel_strongly_connected_components & set_num_threads(
+        const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
+    parallel_strongly_connected_components & reset() noexcept {
+        _converged = false;
+        return *this;
+    }
+
+private:
+    // On vertices that count up from 0 -- those of every melon container -- a
+    // vertex is its own position, which spares a random access per arc.
+    [[nodiscard]] std::size_t position(const vertex & v) const {
+        if constexpr(iota_vertices)
+            if(_vertices_are_positions) return static_cast<std::size_t>(v);
+        return _component_map[v];
+    }
+
+    [[nodiscard]] static std::atomic_ref<std::size_t> ref(std::size_t & x) {
+        return std::atomic_ref<std::size_t>(x);
+    }
+    [[nodiscard]] bool assigned(const std::size_t i) {
+        return ref(_representative[i]).load(std::memory_order_relaxed) != none;
+    }
+    // Whether this call is the one that put i in r's component.
+    bool assign(const std::size_t i, const std::size_t r) {
+        std::size_t expected = none;
+        return ref(_representative[i])
+            .compare_exchange_strong(expected, r, std::memory_order_relaxed);
+    }
+    // Whether this call is the one that set the mark on i.
+    bool mark(const std::size_t i, const unsigned char m) {
+        std::atomic_ref<unsigned char> marks(_marks[i]);
+        // the plain load spares most of the read-modify-writes
+        if(marks.load(std::memory_order_relaxed) & m) return false;
+        return (marks.fetch_or(m, std::memory_order_relaxed) & m) == 0;
+    }
+
+    template <typename Body>
+    void for_each_position(detail::thread_team & team, Body && body) {
+        detail::parallel_for(
+            team, _vertices.size(), grain,
+            [&](std::size_t first, const std::size_t last, std::size_t) {
+                for(; first < last; ++first) body(first);
+            });
+    }
+
+    template <bool Forward, typename Body>
+    void for_each_neighbor(const std::size_t i, Body && body) {
+        if constexpr(Forward) {
+            for(auto && w : out_neighbors(_graph, _vertices[i]))
+                body(position(w));
+        } else {
+            for(auto && w : in_neighbors(_graph, _vertices[i]))
+                body(position(w));
+        }
+    }
+
+    // One level of a search: visit(v, w) is called for every neighbour w of
+    // every v of the frontier, which is replaced by the w it returned true
+    // for. Forward follows out_neighbors, backward in_neighbors.
+    template <bool Forward, typename Visit>
+    void expand(detail::thread_team & team, Visit && visit) {
+        for(auto && local : _local_frontiers) local.resize(0);
+        detail::parallel_for(
+            team, _frontier.size(), frontier_grain,
+            [&](std::size_t first, const std::size_t last,
+                const std::size_t t) {
+                for(; first < last; ++first) {
+                    const std::size_t v = _frontier[first];
+                    for_each_neighbor<Forward>(v, [&](const std::size_t w) {
+                        if(visit(v, w)) _local_frontiers[t].push_back(w);
+                    });
+                }
+            });
+        _frontier.resize(0);
+        for(auto && local : _local_frontiers)
+            _frontier.insert(_frontier.end(), local.begin(), local.end());
+    }
+
+    // Collects the positions for which pred holds into _frontier.
+    template <typename Pred>
+    void gather(detail::thread_team & team, Pred && pred) {
+        for(auto && local : _local_frontiers) local.resize(0);
+        detail::parallel_for(
+            team, _vertices.size(), grain,
+            [&](std::size_t first, const std::size_t last,
+                const std::size_t t) {
+                for(; first < last; ++first)
+                    if(pred(first)) _local_frontiers[t].push_back(first);
+            });
+        _frontier.resize(0);
+        for(auto && local : _local_frontiers)
+            _frontier.insert(_frontier.end(), local.begin(), local.end());
+    }
+
+    void trim(detail::thread_team & team) {
+        for_each_position(team, [this](const std::size_t i) {
+            std::size_t in = 0, out = 0;
+            for_each_neighbor<false>(i, [&](const std::size_t w) {
+                if(w != i) ++in;
+            });
+            for_each_neighbor<true>(i, [&](const std::size_t w) {
+                if(w != i) ++out;
+            });
+            _in_degree[i] = in;
+            _out_degree[i] = out;
+        });
+        gather(team, [this](const std::size_t i) {
+            return (_in_degree[i] == 0 || _out_degree[i] == 0) && assign(i, i);
+        });
+        // A removed vertex takes its arcs with it: a neighbour left with no
+        // incoming, or no outgoing, arc is removed next.
+        while(!_frontier.empty()) {
+            for(auto && local : _local_frontiers) local.resize(0);
+            detail::parallel_for(
+                team, _frontier.size(), frontier_grain,
+                [&](std::size_t first, const std::size_t last,
+                    const std::size_t t) {
+                    for(; first < last; ++first) {
+                        const std::size_t v = _frontier[first];
+                        const auto release = [&](std::size_t & degree,
+                                                 const std::size_t w) {
+                            if(w == v || assigned(w)) return;
+                            if(ref(degree).fetch_sub(
+                                   1, std::memory_order_relaxed) == 1 &&
+                               assign(w, w))
+                                _local_frontiers[t].push_back(w);
+                        };
+                        for_each_neighbor<true>(v, [&](const std::size_t w) {
+                            release(_in_degree[w], w);
+                        });
+                        for_each_neighbor<false>(v, [&](const std::size_t w) {
+                            release(_out_degree[w], w);
+                        });
+                    }
+                });
+            _frontier.resize(0);
+            for(auto && local : _local_frontiers)
+                _frontier.insert(_frontier.end(), local.begin(), local.end());
+        }
+    }
+
+    void forward_backward(detail::thread_team & team) {
+        // the pivot most likely in the giant component
+        std::vector<std::size_t> best(team.size(), none);
+        detail::parallel_for(
+            team, _vertices.size(), grain,
+            [&](std::size_t first, const std::size_t last,
+                const std::size_t t) {
+                for(; first < last; ++first) {
+                    if(assigned(first)) continue;
+                    const auto score = [this](const std::size_t i) {
+                        return _in_degree[i] * _out_degree[i];
+                    };
+                    if(best[t] == none || score(first) > score(best[t]))
+                        best[t] = first;
+                }
+            });
+        std::size_t pivot = none;
+        for(auto && b : best) {
+            if(b == none) continue;
+            if(pivot == none ||
+               _in_degree[b] * _out_degree[b] >
+                   _in_degree[pivot] * _out_degree[pivot] ||
+               (_in_degree[b] * _out_degree[b] ==
+                    _in_degree[pivot] * _out_degree[pivot] &&
+                b < pivot))
+                pivot = b;
+        }
+        if(pivot == none) return;
+
+        _frontier.assign(1, pivot);
+        _marks[pivot] = forward_mark | backward_mark;
+        while(!_frontier.empty())
+            expand<true>(team, [this](std::size_t, const std::size_t w) {
+                return !assigned(w) && mark(w, forward_mark);
+            });
+        // A path from the component back to the pivot stays in it, so the
+        // backward search need not leave the vertices reached forward. The
+        // rest is left to the colouring, not split three ways and recursed on.
+        _frontier.assign(1, pivot);
+        while(!_frontier.empty())
+            expand<false>(team, [this](std::size_t, const std::size_t w) {
+                std::atomic_ref<unsigned char> marks(_marks[w]);
+                return (marks.load(std::memory_order_relaxed) & forward_mark) &&
+                       mark(w, backward_mark);
+            });
+        for_each_position(team, [this, pivot](const std::size_t i) {
+            if(_marks[i] == (forward_mark | backward_mark))
+                _representative[i] = pivot;
+            _marks[i] = 0;
+        });
+    }
+
+    void color(detail::thread_team & team) {
+        for(;;) {
+            gather(team, [this](const std::size_t i) {
+                _color[i] = i;
+                return !assigned(i);
+            });
+            if(_frontier.empty()) return;
+            // the largest position reaching each vertex, pushed along the arcs
+            // from the vertices whose colour changed
+            while(!_frontier.empty()) {
+                expand<true>(team, [this](const std::size_t v,
+                                          const std::size_t w) {
+                    if(assigned(w)) return false;
+                    const std::size_t c =
+                        ref(_color[v]).load(std::memory_order_relaxed);
+                    std::size_t current =
+                        ref(_color[w]).load(std::memory_order_relaxed);
+                    while(current < c) {
+                        if(ref(_color[w]).compare_exchange_weak(
+                               current, c, std::memory_order_relaxed))
+                            // only the first raise of this level queues w
+                            return mark(w, forward_mark);
+                    }
+                    return false;
+                });
+                for(auto && w : _frontier) _marks[w] = 0;
+            }
+            // the vertices of colour r that reach r are r's component
+            gather(team, [this](const std::size_t i) {
+                return !assigned(i) && _color[i] == i && assign(i, i);
+            });
+            while(!_frontier.empty())
+                expand<false>(team, [this](const std::size_t v,
+                                           const std::size_t w) {
+                    return _color[w] == _color[v] && assign(w, _color[v]);
+                });
+        }
+    }
+
+    // Each representative is met first at the smallest position of its
+    // component, and labelled there.
+    void label_components() {
+        _component_sizes.clear();
+        std::ranges::fill(_color, none);
+        for(std::size_t i = 0; i < _vertices.size(); ++i) {
+            std::size_t & label = _color[_representative[i]];
+            if(label == none) {
+                label = _component_sizes.size();
+                _component_sizes.push_back(0);
+            }
+            _component_map[_vertices[i]] = label;
+            ++_component_sizes[label];
+        }
+    }
+
+public:
+    // Not noexcept: it allocates and spawns the worker threads, and the
+    // graph's neighbour ranges may allocate on any of them; the first exception
+    // thrown there is rethrown here once the other threads have stopped.
+    parallel_strongly_connected_components & run() {
+        if(_converged) return *this;
+        const std::size_t n = _vertices.size();
+        _representative.assign(n, none);
+        _in_degree.resize(n);
+        _out_degree.resize(n);
+        _color.resize(n);
+        _marks.assign(n, 0);
+        detail::thread_team team(_num_threads);
+        _local_frontiers.resize(team.size());
+        if(!_vertices_are_positions) {
+            for_each_position(team, [this](const std::size_t i) {
+                _component_map[_vertices[i]] = i;
+            });
+        }
+        trim(team);
+        forward_backward(team);
+        color(team);
+        label_components();
+        _converged = true;
+        return *this;
+    }
+
+    // The three below and the two maps: precondition, run() has converged.
+    [[nodiscard]] std::size_t num_components() const noexcept {
+        assert(_converged);
+        return _component_sizes.size();
+    }
+    [[nodiscard]] std::size_t component(const vertex & u) const
+        noexcept(noexcept(_component_map[u])) {
+        assert(_converged);
+        return _component_map[u];
+    }
+    [[nodiscard]] std::span<const std::size_t> component_sizes()
+        const noexcept {
+        assert(_converged);
+        return _component_sizes;
+    }
+
+    // Refers into the algorithm, like every melon map view: valid while this
+    // object lives and stays put.
+    [[nodiscard]] auto components_map() const & noexcept(
+        noexcept(maps::mapping_all(_component_map))) {
+        assert(_converged);
+        return maps::mapping_all(_component_map);
+    }
+    // Terminal, like std::move(alg).base(): the member left behind is valid but
+    // empty, so no other member may be called afterwards.
+    [[nodiscard]] auto components_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_component_map)))) {
+        assert(_converged);
+        return maps::mapping_all(std::move(_component_map));
+    }
+};
+
+template <typename Graph>
+parallel_strongly_connected_components(Graph &&)
+    -> parallel_strongly_connected_components<views::graph_all_t<Graph>>;
+
+}  // namespace melon
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "melon/detail/not_self.hpp"
+#include "melon/detail/specialization_of.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/graph.hpp"
+#include "melon/utility/algorithmic_generator.hpp"
+#include "melon/views/graph_view.hpp"
+
+namespace melon {
+
+// Kahn's algorithm, level-synchronous: yields the topological levels of a DAG
+// one at a time, each as a std::span of its vertices -- first the sources,
+// then the vertices all of whose in-neighbours are in earlier levels. The
+// level of a vertex is the number of arcs on the longest path from a source
+// down to it, topological_sort's rank, so the vertices of a level never depend
+// on each other.
+//
+// A level is expanded across threads: each takes a share of its vertices and
+// decrements the remaining in-degrees of their out-neighbours atomically, and
+// the one that brings an in-degree to 0 puts the vertex in the next level. The
+// levels are the same for any number of threads; the order of the vertices
+// within one is not, past the first.
+template <graph_view Graph>
+    requires outward_adjacency_graph<Graph> && has_vertex_map<Graph>
+class parallel_topological_sort
+    : public algorithm_view_interface<parallel_topological_sort<Graph>> {
+private:
+    using vertex = vertex_t<Graph>;
+
+    static constexpr std::size_t grain = 1024;
+    static constexpr std::size_t frontier_grain = 64;
+    static constexpr std::size_t unreached =
+        std::numeric_limits<std::size_t>::max();
+
+    // Then a vertex may be its own position, see position().
+    static constexpr bool iota_vertices =
+        std::integral<vertex> &&
+        detail::specialization_of<vertices_range_t<Graph>,
+                                  std::ranges::iota_view>;
+
+private:
+    Graph _graph;
+    std::size_t _num_threads;
+    // spawned on the first level large enough to share, then kept parked
+    std::unique_ptr<detail::thread_team> _team;
+    std::vector<vertex> _vertices;
+    bool _vertices_are_positions;
+    vertex_map_t<Graph, std::size_t> _position_map;
+    vertex_map_t<Graph, std::size_t> _level_map;
+    // by position
+    std::vector<std::size_t> _remaining_in_degree;
+    // the levels yielded so far, one after the other; reserved for every
+    // vertex, so the spans handed out stay valid
+    std::vector<vertex> _order;
+    std::size_t _level_first;
+    std::size_t _level;
+    std::vector<std::vector<vertex>> _local_levels;
+
+public:
+    template <typename G>
+        requires detail::not_self<G, parallel_topological_sort> &&
+                     graph_for<G, Graph>
+    explicit parallel_topological_sort(G && g)
+        : _graph(views::graph_all(std::forward<G>(g)))
+        , _num_threads(detail::default_num_threads())
+        , _position_map(create_vertex_map<std::size_t>(_graph))
+        , _level_map(create_vertex_map<std::size_t>(_graph)) {
+        for(auto && v : vertices(_graph)) _vertices.push_back(v);
+        _vertices_are_positions =
+            iota_vertices && (_vertices.empty() || _vertices.front() == 0);
+        if(!_vertices_are_positions)
+            for(std::size_t i = 0; i < _vertices.size(); ++i)
+                _position_map[_vertices[i]] = i;
+        reset();
+    }
+
+    // Move-only; see the melon::traversal_algorithm concept for the ruling.
+    // The team is held by pointer and _level_first is an index, so the moves
+    // stay defaulted.
+    parallel_topological_sort(const parallel_topological_sort &) = delete;
+    parallel_topological_sort(parallel_topological_sort &&) = default;
+
+    parallel_topological_sort & operator=(const parallel_topological_sort &) =
+        delete;
+    parallel_topological_sort & operator=(parallel_topological_sort &&) =
+        default;
+
+    [[nodiscard]] constexpr Graph & base() & noexcept { return _graph; }
+    [[nodiscard]] constexpr const Graph & base() const & noexcept {
+        return _graph;
+    }
+    [[nodiscard]] constexpr Graph && base() && noexcept {
+        return std::move(_graph);
+    }
+    [[nodiscard]] constexpr const Graph && base() const && noexcept {
+        return std::move(_graph);
+    }
+
+    // std::thread::hardware_concurrency() by default. The constructor has
+    // already found the sources with it; the count applies from there on.
+    parallel_topological_sort & set_num_threads(
+        const std::size_t num_threads) {
+        assert(num_threads > 0);
+        if(_team && _team->size() != num_threads) _team.reset();
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
+private:
+    // On vertices that count up from 0 -- those of every melon container -- a
+    // vertex is its own position, which spares a random access per arc.
+    [[nodiscard]] std::size_t position(const vertex & v) const {
+        if constexpr(iota_vertices)
+            if(_vertices_are_positions) return static_cast<std::size_t>(v);
+        return _position_map[v];
+    }
+
+    // Whether this arc was the last one keeping its target out of a level;
+    // atomic when the level is shared between threads.
+    [[nodiscard]] static bool release(std::size_t & remaining_in_degree,
+                                      const bool shared) noexcept {
+        if(!shared) return --remaining_in_degree == 0;
+        return std::atomic_ref<std::size_t>(remaining_in_degree)
+                   .fetch_sub(1, std::memory_order_relaxed) == 1;
+    }
+
+    // The team for `count` items of `item_grain`, or none if they are better
+    // left to the calling thread.
+    [[nodiscard]] detail::thread_team * team_for(
+        const std::size_t count, const std::size_t item_grain) {
+        if(_num_threads == 1 || count <= item_grain) return nullptr;
+        if(!_team) _team = std::make_unique<detail::thread_team>(_num_threads);
+        _local_levels.resize(_team->size());
+        return _team.get();
+    }
+
+    // Calls take(i, level) for every i in [first, last), split across the
+    // team if there is one; take pushes onto `level` the vertices it finds, and
+    // they all end up at the back of _order.
+    template <typename Take>
+    void append_level(detail::thread_team * team, const std::size_t first,
+                      const std::size_t last, const std::size_t item_grain,
+                      Take && take) {
+        if(team == nullptr) {
+            for(std::size_t i = first; i < last; ++i) take(i, _order);
+            return;
+        }
+        for(auto && local : _local_levels) local.resize(0);
+        detail::parallel_for(
+            *team, last - first, item_grain,
+            [&](std::size_t chunk_first, const std::size_t chunk_last,
+                const std::size_t t) {
+                for(; chunk_first < chunk_last; ++chunk_first)
+                    take(first + chunk_first, _local_levels[t]);
+            });
+        for(auto && local : _local_levels)
+            _order.insert(_order.end(), local.begin(), local.end());
+    }
+
+public:
+    // Not noexcept: it allocates, spawns the worker threads on a large graph,
+    // and the graph's neighbour ranges may allocate on any of them.
+    parallel_topological_sort & reset() {
+        const std::size_t n = _vertices.size();
+        _remaining_in_degree.assign(n, 0);
+        _order.resize(0);
+        _order.reserve(n);
+        _level_first = 0;
+        _level = 0;
+
+        // the in-degrees: the graph's own if it has them, else counted
+        detail::thread_team * team = team_for(n, grain);
+        append_level(team, 0, n, grain,
+                     [this, team](const std::size_t i, auto &) {
+                         _level_map[_vertices[i]] = unreached;
+                         if constexpr(has_in_degree<Graph>) {
+                             _remaining_in_degree[i] =
+                                 in_degree(_graph, _vertices[i]);
+                         } else {
+                             for(auto && w :
+                                 out_neighbors(_graph, _vertices[i])) {
+                                 std::size_t & d =
+                                     _remaining_in_degree[position(w)];
+                                 if(team == nullptr)
+                                     ++d;
+                                 else
+                                     std::atomic_ref<std::size_t>(d).fetch_add(
+                                         1, std::memory_order_relaxed);
+                             }
+                         }
+                     });
+        append_level(team, 0, n, grain,
+                     [this](const std::size_t i, auto & level) {
+                         if(_remaining_in_degree[i] > 0) return;
+                         _level_map[_vertices[i]] = 0;
+                         level.push_back(_vertices[i]);
+                     });
+        return *this;
+    }
+
+    [[nodiscard]] bool finished() const noexcept {
+        return _level_first == _order.size();
+    }
+
+    // The current level; its span, and those of the levels before it, stay
+    // valid until reset().
+    [[nodiscard]] std::span<const vertex> current() const noexcept {
+        assert(!finished());
+        return std::span<const vertex>(_order).subspan(_level_first);
+    }
+
+    void advance() {
+        assert(!finished());
+        const std::size_t first = _level_first, last = _order.size();
+        _level_first = last;
+        ++_level;
+        detail::thread_team * team = team_for(last - first, frontier_grain);
+        append_level(
+            team, first, last, frontier_grain,
+            [this, team](const std::size_t i, auto & level) {
+                for(auto && w : out_neighbors(_graph, _order[i])) {
+                    if(!release(_remaining_in_degree[position(w)],
+                                team != nullptr))
+                        continue;
+                    _level_map[w] = _level;
+                    level.push_back(w);
+                }
+            });
+    }
+
+    // The number of levels yielded so far, current() included.
+    [[nodiscard]] std::size_t num_levels() const noexcept {
+        return finished() ? _level : _level + 1;
+    }
+
+    // Whether the graph carried no directed cycle. Precondition: finished(),
+    // as for topological_sort.
+    [[nodiscard]] bool is_acyclic() const noexcept {
+        assert(finished());
+        return _order.size() == _vertices.size();
+    }
+
+    // The vertices yielded so far, level after level.
+    [[nodiscard]] std::span<const vertex> order() const noexcept {
+        return _order;
+    }
+
+    [[nodiscard]] bool reached(const vertex & u) const
+        noexcept(noexcept(_level_map[u])) {
+        return _level_map[u] != unreached;
+    }
+    [[nodiscard]] std::size_t level(const vertex & u) const
+        noexcept(noexcept(_level_map[u])) {
+        assert(reached(u));
+        return _level_map[u];
+    }
+    // The level of every vertex reached, and
+    // std::numeric_limits<std::size_t>::max() for the others. Refers into the
+    // algorithm, like every melon map view: valid while this object lives and
+    // stays put.
+    [[nodiscard]] auto levels_map() const & noexcept(
+        noexcept(maps::mapping_all(_level_map))) {
+        return maps::mapping_all(_level_map);
+    }
+    // Terminal, like std::move(alg).base(): the member left behind is valid but
+    // empty, so no other member may be called afterwards.
+    [[nodiscard]] auto levels_map() && noexcept(
+        noexcept(maps::mapping_all(std::move(_level_map)))) {
+        return maps::mapping_all(std::move(_level_map));
+    }
+};
+
+template <typename Graph>
+parallel_topological_sort(Graph &&)
+    -> parallel_topological_sort<views::graph_all_t<Graph>>;
+
+}  // namespace melon
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <ranges>
 #include <thread>
@@ -14,6 +16,8 @@
 #include <vector>
 
 #include "melon/detail/stdlib_check.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/detail/work_stealing_deques.hpp"
 #include "melon/mapping.hpp"
 
 namespace melon {
@@ -51,6 +55,16 @@ private:
     std::vector<std::pair<typename decltype(_value_cost_pairs)::const_iterator,
                           std::size_t>>
         _best_sol;
+    std::size_t _num_threads;
+
+    using pair_iterator = typename decltype(_value_cost_pairs)::const_iterator;
+    // The nodes of the search tree where the first items, up to a common
+    // depth, are decided: `taken` are those in, with their counts.
+    struct subtree {
+        std::vector<std::pair<pair_iterator, std::size_t>> taken;
+        Value value;
+        Cost budget_left;
+    };
 
 private:
     double value_cost_ratio(const std::pair<Value, Cost> & p) const {
@@ -138,6 +152,108 @@ private:
         return _best_sol;
     }
 
+    // The subtrees at the shallowest depth with at least num_subtrees of
+    // them, or all the items decided, in the order iterative_bnb() visits
+    // them: by decreasing count of each item. Stops short of an item cheap
+    // enough to split into far more subtrees than asked.
+    std::vector<subtree> split(const std::size_t num_subtrees,
+                               std::size_t & depth) const {
+        std::vector<subtree> subtrees(1, subtree{{}, Value{0}, _budget});
+        std::vector<subtree> children;
+        auto max_count = [](const subtree & s, const pair_iterator it) {
+            return static_cast<std::size_t>(s.budget_left / it->second);
+        };
+        for(depth = 0; depth < _value_cost_pairs.size() &&
+                       subtrees.size() < num_subtrees;
+            ++depth) {
+            const auto it = _value_cost_pairs.cbegin() +
+                            static_cast<std::ptrdiff_t>(depth);
+            std::size_t num_children = 0;
+            for(const subtree & s : subtrees) {
+                num_children += std::min(max_count(s, it), 16 * num_subtrees);
+                if(++num_children > 16 * num_subtrees) return subtrees;
+            }
+            children.resize(0);
+            for(subtree & s : subtrees) {
+                for(std::size_t count = max_count(s, it); count > 0; --count) {
+                    subtree & in = children.emplace_back(s);
+                    in.taken.emplace_back(it, count);
+                    in.value += static_cast<Value>(count) * it->first;
+                    in.budget_left -= static_cast<Cost>(count) * it->second;
+                }
+                children.push_back(std::move(s));
+            }
+            subtrees.swap(children);
+        }
+        return subtrees;
+    }
+
+    // iterative_bnb() on the subtrees of split(), from the threads of a team
+    // taking them through work-stealing deques, as knapsack_bnb does: the
+    // incumbent is shared as its value and the number of the subtree it was
+    // found in, so the threads prune against the global incumbent and the
+    // solution is the one iterative_bnb() finds.
+    void parallel_bnb() {
+        _best_sol.resize(0);
+        const auto end = _value_cost_pairs.cend();
+        std::size_t depth;
+        std::vector<subtree> subtrees = split(64 * _num_threads, depth);
+        std::atomic<Value> best_value{Value{0}};
+        std::atomic<std::size_t> best_subtree{0};
+        std::mutex best_mutex;
+        auto improves = [&](const auto x, const std::size_t k) {
+            const Value v = best_value.load(std::memory_order_acquire);
+            return x > v || (!(x < v) &&
+                             k < best_subtree.load(std::memory_order_relaxed));
+        };
+        auto search = [&](const std::size_t k, auto & current_sol) {
+            current_sol = std::move(subtrees[k].taken);
+            const std::size_t root_size = current_sol.size();
+            Value current_sol_value = subtrees[k].value;
+            Cost budget_left = subtrees[k].budget_left;
+            auto it = _value_cost_pairs.cbegin() +
+                      static_cast<std::ptrdiff_t>(depth);
+            for(;;) {
+                for(; it < end; ++it) {
+                    if(budget_left < it->second) continue;
+                    if(!improves(current_sol_value +
+                                     budget_left * value_cost_ratio(*it),
+                                 k))
+                        goto backtrack;
+                    const std::size_t num_take =
+                        static_cast<std::size_t>(budget_left / it->second);
+                    current_sol_value +=
+                        static_cast<Value>(num_take) * it->first;
+                    budget_left -= static_cast<Cost>(num_take) * it->second;
+                    current_sol.emplace_back(it, num_take);
+                }
+                if(improves(current_sol_value, k)) {
+                    std::lock_guard lock(best_mutex);
+                    if(improves(current_sol_value, k)) {
+                        _best_sol = current_sol;
+                        best_subtree.store(k, std::memory_order_relaxed);
+                        best_value.store(current_sol_value,
+                                         std::memory_order_release);
+                    }
+                }
+            backtrack:
+                if(current_sol.size() == root_size) return;
+                it = current_sol.back().first;
+                if(--current_sol.back().second == 0) current_sol.pop_back();
+                current_sol_value -= it->first;
+                budget_left += it->second;
+                ++it;
+            }
+        };
+        detail::work_stealing_deques deques(subtrees.size(), _num_threads);
+        detail::thread_team team(_num_threads);
+        auto job = [&](const std::size_t i) {
+            std::vector<std::pair<pair_iterator, std::size_t>> current_sol;
+            while(const auto k = deques.pop(i)) search(*k, current_sol);
+        };
+        team.run(job);
+    }
+
 public:
     // Constrained on what the mem-initializers actually do, so
     // std::is_constructible answers what construction actually does instead of
@@ -150,7 +266,8 @@ public:
         : _items_range(std::views::all(std::forward<IR>(items_range)))
         , _value_map(maps::mapping_all(std::forward<VM>(value_map)))
         , _cost_map(maps::mapping_all(std::forward<CM>(cost_map)))
-        , _budget(std::forward<B>(budget)) {
+        , _budget(std::forward<B>(budget))
+        , _num_threads(1) {
         reset();
     }
 
@@ -226,8 +343,22 @@ public:
         return reset();
     }
 
+    // As knapsack_bnb::set_num_threads: 1 by default, and the same solution
+    // with more. run_with_timeout() is serial.
+    unbounded_knapsack_bnb & set_num_threads(const std::size_t num_threads) {
+        assert(num_threads > 0);
+        _num_threads = num_threads;
+        return *this;
+    }
+    [[nodiscard]] std::size_t num_threads() const noexcept {
+        return _num_threads;
+    }
+
     unbounded_knapsack_bnb & run() {
-        iterative_bnb();
+        if(_num_threads > 1)
+            parallel_bnb();
+        else
+            iterative_bnb();
         return *this;
     }
 
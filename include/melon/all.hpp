@@ -11,6 +11,7 @@
 #include "melon/mapping.hpp"
 #include "melon/undirected_graph.hpp"
 
+#include "melon/container/concurrent_disjoint_sets.hpp"
 #include "melon/container/d_ary_heap.hpp"
 #include "melon/container/disjoint_sets.hpp"
 #include "melon/container/mutable_digraph.hpp"
@@ -21,37 +22,55 @@
 
 #include "melon/views/complete_digraph.hpp"
 #include "melon/views/graph_view.hpp"
+#include "melon/views/grid_digraph.hpp"
 #include "melon/views/reverse.hpp"
 #include "melon/views/subgraph.hpp"
 #include "melon/views/undirect.hpp"
 #include "melon/views/undirected_graph_view.hpp"
 
 #include "melon/algorithm/bentley_ottmann.hpp"
+#include "melon/algorithm/bidirectional_biobjective_dijkstra.hpp"
 #include "melon/algorithm/bidirectional_dijkstra.hpp"
 #include "melon/algorithm/biobjective_dijkstra.hpp"
+#include "melon/algorithm/boykov_kolmogorov.hpp"
 #include "melon/algorithm/breadth_first_search.hpp"
 #include "melon/algorithm/competing_dijkstras.hpp"
 #include "melon/algorithm/connected_components.hpp"
+#include "melon/algorithm/cost_scaling.hpp"
 #include "melon/algorithm/depth_first_search.hpp"
 #include "melon/algorithm/dijkstra.hpp"
 #include "melon/algorithm/dinitz.hpp"
 #include "melon/algorithm/edmonds_karp.hpp"
+#include "melon/algorithm/filter_kruskal.hpp"
 #include "melon/algorithm/knapsack_bnb.hpp"
+#include "melon/algorithm/knapsack_core.hpp"
+#include "melon/algorithm/knapsack_dp.hpp"
 #include "melon/algorithm/kruskal.hpp"
+#include "melon/algorithm/multi_competing_dijkstras.hpp"
+#include "melon/algorithm/network_simplex.hpp"
 #include "melon/algorithm/network_voronoi.hpp"
+#include "melon/algorithm/parallel_bentley_ottmann.hpp"
+#include "melon/algorithm/parallel_boruvka.hpp"
+#include "melon/algorithm/parallel_connected_components.hpp"
+#include "melon/algorithm/parallel_push_relabel.hpp"
+#include "melon/algorithm/parallel_strongly_connected_components.hpp"
+#include "melon/algorithm/parallel_topological_sort.hpp"
 #include "melon/algorithm/strongly_connected_components.hpp"
 #include "melon/algorithm/topological_sort.hpp"
 #include "melon/algorithm/traversal_forest.hpp"
 #include "melon/algorithm/unbounded_knapsack_bnb.hpp"
 
+#include "melon/numeric/adaptive_integer.hpp"
 #include "melon/numeric/bounded_value.hpp"
 #include "melon/numeric/rational.hpp"
 #include "melon/utility/algorithmic_generator.hpp"
 #include "melon/utility/alias_method_sampler.hpp"
 #include "melon/utility/erdos_renyi.hpp"
+#include "melon/utility/generators.hpp"
 #include "melon/utility/geometry.hpp"
 #include "melon/utility/graphviz_printer.hpp"
 #include "melon/utility/make_static_digraph.hpp"
 #include "melon/utility/priority_queue.hpp"
 #include "melon/utility/semiring.hpp"
 #include "melon/utility/static_digraph_builder.hpp"
+#include "melon/utility/sum_tree_sampler.hpp"
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace melon {
+
+// Union-find over the dense range [0, size()) that any number of threads may
+// use at once: find, same_set and unite are lock-free, built on one atomic
+// parent per element, after Jayanti and Tarjan's concurrent disjoint set union.
+//
+// Linking is by index -- the larger root is hooked under the smaller one by
+// compare-exchange -- so every parent is smaller than its child, and find walks
+// a strictly decreasing chain: it is wait-free, bounded by the element itself.
+// It splits the path as it goes, each element pointed at its grandparent by a
+// compare-exchange that may fail harmlessly when another thread got there
+// first. Once the unites have returned, the root of each set is its smallest
+// element, whatever the thread count or interleaving.
+//
+// Unlike disjoint_sets there is no key map and no push: the elements are the
+// indices themselves, all present from the construction.
+template <std::unsigned_integral T = unsigned int>
+class concurrent_disjoint_sets {
+public:
+    using value_type = T;
+
+private:
+    std::vector<std::atomic<T>> _parent;
+
+public:
+    concurrent_disjoint_sets() = default;
+    explicit concurrent_disjoint_sets(const std::size_t size) : _parent(size) {
+        reset();
+    }
+
+    // std::atomic is neither copyable nor movable: the parents are moved as a
+    // whole buffer, and copying is left out.
+    concurrent_disjoint_sets(const concurrent_disjoint_sets &) = delete;
+    concurrent_disjoint_sets(concurrent_disjoint_sets &&) = default;
+
+    concurrent_disjoint_sets & operator=(const concurrent_disjoint_sets &) =
+        delete;
+    concurrent_disjoint_sets & operator=(concurrent_disjoint_sets &&) = default;
+
+    [[nodiscard]] std::size_t size() const noexcept { return _parent.size(); }
+    [[nodiscard]] bool empty() const noexcept { return _parent.empty(); }
+
+    // Every element back to a singleton. Neither this nor resize() may run
+    // concurrently with anything else.
+    void reset() noexcept {
+        for(std::size_t i = 0; i < _parent.size(); ++i)
+            _parent[i].store(static_cast<T>(i), std::memory_order_relaxed);
+    }
+    void resize(const std::size_t size) {
+        _parent = std::vector<std::atomic<T>>(size);
+        reset();
+    }
+
+    // The three below: safe from any number of threads at once.
+    [[nodiscard]] T find(T x) noexcept {
+        assert(x < size());
+        T p = _parent[x].load(std::memory_order_acquire);
+        while(p != x) {
+            const T gp = _parent[p].load(std::memory_order_acquire);
+            if(gp != p) {
+                T expected = p;
+                _parent[x].compare_exchange_weak(expected, gp,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed);
+            }
+            x = p;
+            p = gp;
+        }
+        return x;
+    }
+
+    // Whether x and y are in the same set at the linearisation point: a root
+    // seen for one of them may be linked concurrently, hence the retry.
+    [[nodiscard]] bool same_set(T x, T y) noexcept {
+        for(;;) {
+            x = find(x);
+            y = find(y);
+            if(x == y) return true;
+            if(_parent[x].load(std::memory_order_acquire) == x) return false;
+        }
+    }
+
+    // Unites the sets of x and y; false if they already were one. Exactly one
+    // of several threads uniting the same two sets gets true.
+    bool unite(T x, T y) noexcept {
+        for(;;) {
+            x = find(x);
+            y = find(y);
+            if(x == y) return false;
+            if(x < y) std::swap(x, y);
+            T expected = x;
+            if(_parent[x].compare_exchange_strong(expected, y,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_relaxed))
+                return true;
+        }
+    }
+};
+
+}  // namespace melon
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace melon {
+namespace detail {
+
+// Blocks carved out of chunks that double in size, and recycled through one
+// free list per block size: what node-based containers ask for, one node at a
+// time, in as many sizes as they have node types. Chunks are only given back
+// on destruction, so a container that is cleared and refilled allocates
+// nothing the second time. Unsynchronized: one pool per thread.
+class node_pool {
+private:
+    struct free_block {
+        free_block * next;
+    };
+    struct size_class {
+        std::size_t block_size;
+        free_block * free_list;
+    };
+    static constexpr std::size_t block_alignment = alignof(std::max_align_t);
+
+    // a node type or two: a linear search beats anything fancier
+    std::vector<size_class> _size_classes;
+    std::byte * _chunk_next = nullptr;
+    std::byte * _chunk_end = nullptr;
+    std::size_t _chunk_size = 4096;
+    std::vector<void *> _chunks;
+
+    [[nodiscard]] static constexpr std::size_t block_size(
+        const std::size_t bytes) noexcept {
+        return (std::max(bytes, sizeof(free_block)) + block_alignment - 1) /
+               block_alignment * block_alignment;
+    }
+    [[nodiscard]] size_class & size_class_of(const std::size_t size) {
+        for(size_class & c : _size_classes)
+            if(c.block_size == size) return c;
+        return _size_classes.emplace_back(size_class{size, nullptr});
+    }
+
+public:
+    node_pool() = default;
+    node_pool(const node_pool &) = delete;
+    node_pool & operator=(const node_pool &) = delete;
+    ~node_pool() {
+        for(void * chunk : _chunks) ::operator delete(chunk);
+    }
+
+    [[nodiscard]] void * allocate(const std::size_t bytes,
+                                  const std::size_t alignment) {
+        if(alignment > block_alignment)
+            return ::operator new(bytes, std::align_val_t{alignment});
+        const std::size_t size = block_size(bytes);
+        size_class & c = size_class_of(size);
+        if(c.free_list != nullptr) {
+            free_block * const block = c.free_list;
+            c.free_list = block->next;
+            return block;
+        }
+        if(static_cast<std::size_t>(_chunk_end - _chunk_next) < size) {
+            _chunk_size = std::max(2 * _chunk_size, size);
+            _chunks.reserve(_chunks.size() + 1);
+            _chunk_next = static_cast<std::byte *>(::operator new(_chunk_size));
+            _chunks.push_back(_chunk_next);
+            _chunk_end = _chunk_next + _chunk_size;
+        }
+        void * const block = _chunk_next;
+        _chunk_next += size;
+        return block;
+    }
+
+    void deallocate(void * const p, const std::size_t bytes,
+                    const std::size_t alignment) noexcept {
+        if(alignment > block_alignment) {
+            ::operator delete(p, std::align_val_t{alignment});
+            return;
+        }
+        // allocate() registered the size class, so this does not allocate
+        size_class & c = size_class_of(block_size(bytes));
+        c.free_list = ::new(p) free_block{c.free_list};
+    }
+};
+
+// Owns a node_pool at an address that moves with it. Move assignment swaps:
+// the containers of the object assigned to still free their nodes into the
+// pool it held, so that pool must outlive the assignment -- the moved-from
+// side keeps it.
+class node_pool_box {
+private:
+    std::unique_ptr<node_pool> _pool;
+
+public:
+    node_pool_box() : _pool(std::make_unique<node_pool>()) {}
+    node_pool_box(node_pool_box &&) noexcept = default;
+    node_pool_box & operator=(node_pool_box && other) noexcept {
+        _pool.swap(other._pool);
+        return *this;
+    }
+
+    [[nodiscard]] node_pool & operator*() const noexcept { return *_pool; }
+};
+
+// A std allocator drawing single objects from a node_pool, and arrays from
+// the global heap; default-constructed, it has no pool and draws everything
+// from the global heap. Copies and rebinds share the pool and compare equal,
+// so nodes extracted from one container can be inserted in another built
+// with a copy of its allocator. It refers to the pool without owning it:
+// whoever hands it out keeps it alive past the containers.
+// The allocator propagates on assignment and swap, so a container assigned
+// to frees its nodes into its old pool before adopting the other's.
+template <typename T>
+class node_pool_allocator {
+private:
+    template <typename U>
+    friend class node_pool_allocator;
+
+    node_pool * _pool = nullptr;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    constexpr node_pool_allocator() noexcept = default;
+    constexpr explicit node_pool_allocator(node_pool & pool) noexcept
+        : _pool(std::addressof(pool)) {}
+    template <typename U>
+    constexpr node_pool_allocator(const node_pool_allocator<U> & other) noexcept
+        : _pool(other._pool) {}
+
+    [[nodiscard]] T * allocate(const std::size_t n) {
+        if(_pool == nullptr || n != 1) return std::allocator<T>{}.allocate(n);
+        return static_cast<T *>(_pool->allocate(sizeof(T), alignof(T)));
+    }
+    void deallocate(T * const p, const std::size_t n) noexcept {
+        if(_pool == nullptr || n != 1)
+            return std::allocator<T>{}.deallocate(p, n);
+        _pool->deallocate(p, sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    [[nodiscard]] constexpr bool operator==(
+        const node_pool_allocator<U> & other) const noexcept {
+        return _pool == other._pool;
+    }
+};
+
+}  // namespace detail
+}  // namespace melon
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "melon/detail/thread_team.hpp"
+
+namespace melon {
+namespace detail {
+
+// Stably reorders `values` by classify(value), a class in [0, K]; the values
+// of class K are dropped. classify may also update the value it is given,
+// before it is moved. Goes through `scratch`, as long as `values`, and keeps
+// the classes in `classes`, as long too. With a team, each of its threads
+// takes one contiguous chunk; without, the calling thread does it all. Either
+// way the result is the same. Returns where each class begins and where the
+// kept values end, as offsets into `values`.
+template <std::size_t K, typename T, typename Classify>
+std::array<std::size_t, K + 1> stable_partition(
+    thread_team * team, const std::span<T> values, const std::span<T> scratch,
+    const std::span<unsigned char> classes, Classify && classify) {
+    static_assert(K < 256);
+    assert(scratch.size() >= values.size() && classes.size() >= values.size());
+    const std::size_t size = values.size();
+    const std::size_t num_chunks =
+        team ? std::max(std::size_t{1}, std::min(team->size(), size)) : 1;
+    const auto chunk_first = [&](const std::size_t c) {
+        return size * c / num_chunks;
+    };
+    const auto run_chunks = [&](auto & job) {
+        if(team && num_chunks > 1) {
+            auto guarded_job = [&](const std::size_t c) {
+                if(c < num_chunks) job(c);
+            };
+            team->run(guarded_job);
+        } else {
+            job(std::size_t{0});
+        }
+    };
+
+    std::vector<std::array<std::size_t, K + 1>> offsets(num_chunks);
+    auto classify_chunk = [&](const std::size_t c) {
+        auto & count = offsets[c];
+        count.fill(0);
+        for(std::size_t i = chunk_first(c); i < chunk_first(c + 1); ++i) {
+            const std::size_t k = classify(values[i]);
+            assert(k <= K);
+            classes[i] = static_cast<unsigned char>(k);
+            ++count[k];
+        }
+    };
+    run_chunks(classify_chunk);
+
+    std::array<std::size_t, K + 1> bounds;
+    std::size_t offset = 0;
+    for(std::size_t k = 0; k < K; ++k) {
+        bounds[k] = offset;
+        for(auto && count : offsets) {
+            const std::size_t chunk_count = count[k];
+            count[k] = offset;
+            offset += chunk_count;
+        }
+    }
+    bounds[K] = offset;
+
+    auto scatter_chunk = [&](const std::size_t c) {
+        auto & next = offsets[c];
+        for(std::size_t i = chunk_first(c); i < chunk_first(c + 1); ++i)
+            if(classes[i] < K) scratch[next[classes[i]]++] = std::move(values[i]);
+    };
+    run_chunks(scatter_chunk);
+    auto copy_chunk = [&](const std::size_t c) {
+        const std::size_t kept = bounds[K];
+        std::move(scratch.begin() +
+                      static_cast<std::ptrdiff_t>(kept * c / num_chunks),
+                  scratch.begin() +
+                      static_cast<std::ptrdiff_t>(kept * (c + 1) / num_chunks),
+                  values.begin() +
+                      static_cast<std::ptrdiff_t>(kept * c / num_chunks));
+    };
+    run_chunks(copy_chunk);
+    return bounds;
+}
+
+}  // namespace detail
+}  // namespace melon
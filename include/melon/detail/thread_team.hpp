@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace melon {
+namespace detail {
+
+// std::thread::hardware_concurrency() may legitimately answer 0.
+[[nodiscard]] inline std::size_t default_num_threads() noexcept {
+    return std::max(std::size_t{1}, static_cast<std::size_t>(
+                                        std::thread::hardware_concurrency()));
+}
+
+// A fixed team of threads running one job at a time, fork-join style:
+// run(job) calls job(i) once for every i in [0, size()) -- the calling thread
+// takes i == 0 -- and returns once every call has returned. The workers are
+// spawned once and parked between jobs, so a round-synchronous algorithm pays
+// a wake-up per round, not a thread creation.
+//
+// A job that throws does not take the team down: the first exception is kept
+// and rethrown from run() on the calling thread, after every other call of the
+// same job has returned.
+class thread_team {
+private:
+    std::mutex _mutex;
+    std::condition_variable _job_posted;
+    std::condition_variable _job_done;
+    void (*_invoke)(void *, std::size_t);
+    void * _job;
+    std::size_t _generation;
+    std::size_t _running;
+    bool _stopping;
+    std::exception_ptr _exception;
+    // Declared last, so destroyed -- joined -- first: a worker still reads
+    // every member above until its thread has returned.
+    std::vector<std::jthread> _workers;
+
+public:
+    explicit thread_team(const std::size_t num_threads)
+        : _invoke(nullptr)
+        , _job(nullptr)
+        , _generation(0)
+        , _running(0)
+        , _stopping(false) {
+        assert(num_threads > 0);
+        _workers.reserve(num_threads - 1);
+        for(std::size_t i = 1; i < num_threads; ++i)
+            _workers.emplace_back([this, i] { work(i); });
+    }
+
+    // Not movable: every worker holds `this`.
+    thread_team(const thread_team &) = delete;
+    thread_team & operator=(const thread_team &) = delete;
+
+    ~thread_team() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _job_posted.notify_all();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return _workers.size() + 1;
+    }
+
+private:
+    void execute(const std::size_t i) noexcept {
+        try {
+            _invoke(_job, i);
+        } catch(...) {
+            std::lock_guard lock(_mutex);
+            if(!_exception) _exception = std::current_exception();
+        }
+    }
+
+    void work(const std::size_t i) {
+        std::size_t seen_generation = 0;
+        for(;;) {
+            {
+                std::unique_lock lock(_mutex);
+                _job_posted.wait(lock, [&] {
+                    return _stopping || _generation != seen_generation;
+                });
+                if(_stopping) return;
+                seen_generation = _generation;
+            }
+            execute(i);
+            {
+                std::lock_guard lock(_mutex);
+                if(--_running > 0) continue;
+            }
+            _job_done.notify_one();
+        }
+    }
+
+public:
+    template <typename Job>
+    void run(Job & job) {
+        {
+            std::lock_guard lock(_mutex);
+            _invoke = [](void * j, std::size_t i) {
+                (*static_cast<Job *>(j))(i);
+            };
+            _job = &job;
+            _running = _workers.size();
+            _exception = nullptr;
+            ++_generation;
+        }
+        _job_posted.notify_all();
+        execute(0);
+        std::unique_lock lock(_mutex);
+        _job_done.wait(lock, [this] { return _running == 0; });
+        if(_exception) std::rethrow_exception(_exception);
+    }
+};
+
+// Calls body(first, last, i) on disjoint chunks [first, last) covering
+// [0, count), from the team's thread i. Chunks are claimed dynamically from a
+// shared counter, so a thread stuck on a heavy chunk does not hold up the
+// others; `grain` trades that balance against contention on the counter.
+template <typename Body>
+void parallel_for(thread_team & team, const std::size_t count,
+                  const std::size_t grain, Body && body) {
+    assert(grain > 0);
+    if(team.size() == 1 || count <= grain) {
+        if(count > 0) body(std::size_t{0}, count, std::size_t{0});
+        return;
+    }
+    std::atomic<std::size_t> next_chunk{0};
+    auto job = [&](const std::size_t i) {
+        for(;;) {
+            const std::size_t first =
+                next_chunk.fetch_add(grain, std::memory_order_relaxed);
+            if(first >= count) return;
+            body(first, std::min(count, first + grain), i);
+        }
+    };
+    team.run(job);
+}
+
+}  // namespace detail
+}  // namespace melon
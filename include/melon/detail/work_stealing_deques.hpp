@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace melon {
+namespace detail {
+
+// The tasks [0, num_tasks), dealt in contiguous blocks to one deque per
+// thread. pop(i) takes the front task of deque i, and once it is empty steals
+// the back task of the next non-empty one. So each thread works through its
+// block in order, and a thread left idle takes the task furthest from where
+// its victim is. The tasks are all known upfront, so a deque is the range of
+// the tasks it has left, under its own mutex: a pop holds it for two loads and
+// a store, far less than any task worth splitting off.
+class work_stealing_deques {
+private:
+    struct deque {
+        std::mutex mutex;
+        std::size_t front;
+        std::size_t back;
+    };
+
+    std::unique_ptr<deque[]> _deques;
+    std::size_t _num_deques;
+
+public:
+    work_stealing_deques(const std::size_t num_tasks,
+                         const std::size_t num_deques)
+        : _deques(std::make_unique<deque[]>(num_deques))
+        , _num_deques(num_deques) {
+        assert(num_deques > 0);
+        for(std::size_t i = 0; i < num_deques; ++i) {
+            _deques[i].front = num_tasks * i / num_deques;
+            _deques[i].back = num_tasks * (i + 1) / num_deques;
+        }
+    }
+
+    // Not movable: the deques are shared between the threads.
+    work_stealing_deques(const work_stealing_deques &) = delete;
+    work_stealing_deques & operator=(const work_stealing_deques &) = delete;
+
+    [[nodiscard]] std::optional<std::size_t> pop(const std::size_t i) {
+        assert(i < _num_deques);
+        {
+            deque & own = _deques[i];
+            std::lock_guard lock(own.mutex);
+            if(own.front < own.back) return own.front++;
+        }
+        for(std::size_t j = 1; j < _num_deques; ++j) {
+            deque & victim = _deques[(i + j) % _num_deques];
+            std::lock_guard lock(victim.mutex);
+            if(victim.front < victim.back) return --victim.back;
+        }
+        return std::nullopt;
+    }
+};
+
+}  // namespace detail
+}  // namespace melon
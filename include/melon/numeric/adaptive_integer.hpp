@@ -0,0 +1,458 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "melon/numeric/bounded_value.hpp"
+#include "melon/numeric/rational.hpp"
+
+namespace melon {
+namespace numeric {
+namespace detail {
+
+// The inline tier of adaptive_integer: __int128 where the compiler has it,
+// so that the product of two 64-bit values -- the cross-multiplications of
+// rational<int64_t> coordinates -- never leaves it. __extension__ keeps
+// -Wpedantic quiet, CMAKE_CXX_EXTENSIONS being off.
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef __int128 adaptive_small_int;
+__extension__ typedef unsigned __int128 adaptive_small_uint;
+#else
+typedef std::int64_t adaptive_small_int;
+typedef std::uint64_t adaptive_small_uint;
+#endif
+// Not numeric_limits: strict ANSI mode leaves it unspecialized for __int128.
+inline constexpr adaptive_small_uint adaptive_small_max =
+    ~adaptive_small_uint{0} >> 1;
+
+// __builtin_*_overflow where the compiler has them: on x86-64 they compile to
+// the arithmetic instruction and a branch on its overflow flag. Elsewhere,
+// the predicates bounded_value uses for the same question.
+[[nodiscard]] constexpr bool add_overflow(const adaptive_small_int a,
+                                          const adaptive_small_int b,
+                                          adaptive_small_int & r) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, &r);
+#else
+    if(default_promotion_strategy::plus_overflows(a, b)) return true;
+    r = a + b;
+    return false;
+#endif
+}
+[[nodiscard]] constexpr bool sub_overflow(const adaptive_small_int a,
+                                          const adaptive_small_int b,
+                                          adaptive_small_int & r) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_sub_overflow(a, b, &r);
+#else
+    if(default_promotion_strategy::substract_overflows(a, b)) return true;
+    r = a - b;
+    return false;
+#endif
+}
+[[nodiscard]] constexpr bool mul_overflow(const adaptive_small_int a,
+                                          const adaptive_small_int b,
+                                          adaptive_small_int & r) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr(sizeof(adaptive_small_int) > sizeof(std::int64_t)) {
+        // the common case, a single widening multiplication
+        const auto a64 = static_cast<std::int64_t>(a);
+        const auto b64 = static_cast<std::int64_t>(b);
+        if(a64 == a && b64 == b) [[likely]] {
+            r = adaptive_small_int{a64} * b64;
+            return false;
+        }
+    }
+    return __builtin_mul_overflow(a, b, &r);
+#else
+    if(default_promotion_strategy::multiply_overflows(a, b)) return true;
+    r = a * b;
+    return false;
+#endif
+}
+
+// Sign and magnitude, the magnitude in base 2^32 from the least significant
+// limb and without leading zero limbs: zero has no limbs and is not negative.
+// Schoolbook algorithms throughout -- the operands adaptive_integer hands
+// over are a few limbs past the inline tier, not thousands of digits.
+class big_integer {
+private:
+    using limb = std::uint32_t;
+    using magnitude = std::vector<limb>;
+    static constexpr int limb_bits = 32;
+
+    bool _negative = false;
+    magnitude _limbs;
+
+    constexpr void trim() noexcept {
+        while(!_limbs.empty() && _limbs.back() == 0) _limbs.pop_back();
+        if(_limbs.empty()) _negative = false;
+    }
+
+    [[nodiscard]] static constexpr std::strong_ordering compare_magnitudes(
+        const magnitude & a, const magnitude & b) noexcept {
+        if(a.size() != b.size()) return a.size() <=> b.size();
+        for(std::size_t i = a.size(); i-- > 0;)
+            if(a[i] != b[i]) return a[i] <=> b[i];
+        return std::strong_ordering::equal;
+    }
+    [[nodiscard]] static constexpr magnitude add_magnitudes(
+        const magnitude & a, const magnitude & b) {
+        const magnitude & longer = a.size() < b.size() ? b : a;
+        const magnitude & shorter = a.size() < b.size() ? a : b;
+        magnitude sum(longer.size() + 1);
+        std::uint64_t carry = 0;
+        for(std::size_t i = 0; i < longer.size(); ++i) {
+            carry += longer[i];
+            if(i < shorter.size()) carry += shorter[i];
+            sum[i] = static_cast<limb>(carry);
+            carry >>= limb_bits;
+        }
+        sum.back() = static_cast<limb>(carry);
+        return sum;
+    }
+    // Precondition: |a| >= |b|.
+    [[nodiscard]] static constexpr magnitude subtract_magnitudes(
+        const magnitude & a, const magnitude & b) {
+        magnitude difference(a.size());
+        std::uint64_t borrow = 0;
+        for(std::size_t i = 0; i < a.size(); ++i) {
+            const std::uint64_t subtrahend =
+                borrow + (i < b.size() ? b[i] : limb{0});
+            borrow = a[i] < subtrahend;
+            difference[i] = static_cast<limb>(
+                (borrow << limb_bits) + a[i] - subtrahend);
+        }
+        assert(borrow == 0);
+        return difference;
+    }
+    [[nodiscard]] static constexpr magnitude multiply_magnitudes(
+        const magnitude & a, const magnitude & b) {
+        magnitude product(a.size() + b.size());
+        for(std::size_t i = 0; i < a.size(); ++i) {
+            std::uint64_t carry = 0;
+            for(std::size_t j = 0; j < b.size(); ++j) {
+                // at most (2^32 - 1)^2 + 2 (2^32 - 1) = 2^64 - 1
+                carry += std::uint64_t{a[i]} * b[j] + product[i + j];
+                product[i + j] = static_cast<limb>(carry);
+                carry >>= limb_bits;
+            }
+            product[i + b.size()] = static_cast<limb>(carry);
+        }
+        return product;
+    }
+
+    constexpr big_integer(const bool negative, magnitude && limbs)
+        : _negative(negative), _limbs(std::move(limbs)) {
+        trim();
+    }
+
+public:
+    constexpr big_integer() = default;
+    constexpr explicit big_integer(const adaptive_small_int v)
+        : _negative(v < 0) {
+        // through the unsigned type, which negating the minimum does not
+        // overflow
+        adaptive_small_uint m = static_cast<adaptive_small_uint>(v);
+        if(_negative) m = adaptive_small_uint{0} - m;
+        for(; m != 0; m >>= limb_bits) _limbs.push_back(static_cast<limb>(m));
+    }
+
+    // Whether the value fits adaptive_small_int, and if so writes it to v.
+    [[nodiscard]] constexpr bool to_small(adaptive_small_int & v) const {
+        if(_limbs.size() * sizeof(limb) > sizeof(adaptive_small_uint))
+            return false;
+        adaptive_small_uint m = 0;
+        for(std::size_t i = _limbs.size(); i-- > 0;)
+            m = (m << limb_bits) | _limbs[i];
+        if(m > adaptive_small_max + (_negative ? 1u : 0u)) return false;
+        v = static_cast<adaptive_small_int>(
+            _negative ? adaptive_small_uint{0} - m : m);
+        return true;
+    }
+
+    [[nodiscard]] constexpr bool is_negative() const noexcept {
+        return _negative;
+    }
+
+    [[nodiscard]] constexpr double to_double() const noexcept {
+        double d = 0.0;
+        for(std::size_t i = _limbs.size(); i-- > 0;)
+            d = d * 4294967296.0 + _limbs[i];
+        return _negative ? -d : d;
+    }
+
+    [[nodiscard]] std::string to_string() const {
+        if(_limbs.empty()) return "0";
+        // peels nine decimal digits at a time off a copy of the magnitude
+        magnitude m = _limbs;
+        std::string digits;
+        while(!m.empty()) {
+            std::uint64_t remainder = 0;
+            for(std::size_t i = m.size(); i-- > 0;) {
+                const std::uint64_t current = (remainder << limb_bits) | m[i];
+                m[i] = static_cast<limb>(current / 1000000000u);
+                remainder = current % 1000000000u;
+            }
+            while(!m.empty() && m.back() == 0) m.pop_back();
+            for(int k = 0; k < 9 && (!m.empty() || remainder != 0); ++k) {
+                digits.push_back(static_cast<char>('0' + remainder % 10));
+                remainder /= 10;
+            }
+        }
+        if(_negative) digits.push_back('-');
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+    [[nodiscard]] constexpr big_integer operator-() const {
+        big_integer r = *this;
+        if(!r._limbs.empty()) r._negative = !r._negative;
+        return r;
+    }
+
+    [[nodiscard]] friend constexpr big_integer operator+(
+        const big_integer & a, const big_integer & b) {
+        if(a._negative == b._negative)
+            return big_integer(a._negative,
+                               add_magnitudes(a._limbs, b._limbs));
+        if(compare_magnitudes(a._limbs, b._limbs) < 0)
+            return big_integer(b._negative,
+                               subtract_magnitudes(b._limbs, a._limbs));
+        return big_integer(a._negative,
+                           subtract_magnitudes(a._limbs, b._limbs));
+    }
+    [[nodiscard]] friend constexpr big_integer operator-(
+        const big_integer & a, const big_integer & b) {
+        return a + -b;
+    }
+    [[nodiscard]] friend constexpr big_integer operator*(
+        const big_integer & a, const big_integer & b) {
+        return big_integer(a._negative != b._negative,
+                           multiply_magnitudes(a._limbs, b._limbs));
+    }
+
+    [[nodiscard]] friend constexpr bool operator==(const big_integer & a,
+                                                   const big_integer & b) {
+        return a._negative == b._negative && a._limbs == b._limbs;
+    }
+    [[nodiscard]] friend constexpr std::strong_ordering operator<=>(
+        const big_integer & a, const big_integer & b) {
+        if(a._negative != b._negative)
+            return a._negative ? std::strong_ordering::less
+                               : std::strong_ordering::greater;
+        return a._negative ? compare_magnitudes(b._limbs, a._limbs)
+                           : compare_magnitudes(a._limbs, b._limbs);
+    }
+};
+
+}  // namespace detail
+
+// A signed integer of unbounded range, for the components of a rational.
+// Values live inline, in a 128-bit integer where the compiler has one (64
+// bits otherwise), and every operation on two inline values is the machine
+// operation followed by an overflow check. Only a result that overflows is
+// recomputed in arbitrary precision, on the heap; a result that fits again is
+// brought back inline, so a computation that strays past 128 bits for a
+// moment does not stay slow.
+// Products of two 64-bit values stay inline, so rational<adaptive_integer>
+// coordinates built from 64-bit integers compare by cross-multiplication at
+// the cost of 128-bit arithmetic, where rational<std::int64_t> would
+// silently overflow.
+// No division: rational never divides its components except in normalize(),
+// which needs std::gcd and so built-in integers.
+class adaptive_integer {
+private:
+    using small_int = detail::adaptive_small_int;
+
+    small_int _small;
+    // the value instead of _small when it does not fit there, null otherwise
+    std::unique_ptr<detail::big_integer> _big;
+
+    struct small_tag {};
+    constexpr adaptive_integer(small_tag, const small_int v) noexcept
+        : _small(v) {}
+
+    [[nodiscard]] static constexpr adaptive_integer from_big(
+        detail::big_integer && b) {
+        adaptive_integer r;
+        if(!b.to_small(r._small))
+            r._big = std::make_unique<detail::big_integer>(std::move(b));
+        return r;
+    }
+    [[nodiscard]] constexpr detail::big_integer to_big() const {
+        return _big ? *_big : detail::big_integer(_small);
+    }
+
+    // The slow paths, kept out of line: inlined, their allocations make every
+    // fast path set up a stack frame.
+    [[gnu::noinline, gnu::cold]] static constexpr adaptive_integer big_negate(
+        const adaptive_integer & a) {
+        return from_big(-a.to_big());
+    }
+    [[gnu::noinline, gnu::cold]] static constexpr adaptive_integer big_add(
+        const adaptive_integer & a, const adaptive_integer & b) {
+        return from_big(a.to_big() + b.to_big());
+    }
+    [[gnu::noinline, gnu::cold]] static constexpr adaptive_integer
+    big_subtract(const adaptive_integer & a, const adaptive_integer & b) {
+        return from_big(a.to_big() - b.to_big());
+    }
+    [[gnu::noinline, gnu::cold]] static constexpr adaptive_integer
+    big_multiply(const adaptive_integer & a, const adaptive_integer & b) {
+        return from_big(a.to_big() * b.to_big());
+    }
+    [[gnu::noinline, gnu::cold]] static constexpr std::unique_ptr<
+        detail::big_integer>
+    clone(const detail::big_integer & b) {
+        return std::make_unique<detail::big_integer>(b);
+    }
+
+public:
+    constexpr adaptive_integer() noexcept : _small(0) {}
+
+    template <std::integral T>
+    constexpr adaptive_integer(const T v) : _small(0) {
+        if constexpr(std::unsigned_integral<T> &&
+                     sizeof(T) >= sizeof(small_int)) {
+            if(v > detail::adaptive_small_max) {
+                // v = 2 (v / 2) + v % 2, each term inline
+                *this = adaptive_integer(static_cast<T>(v / 2)) * 2 +
+                        adaptive_integer(static_cast<T>(v % 2));
+                return;
+            }
+        }
+        _small = static_cast<small_int>(v);
+    }
+    template <typename T>
+        requires std::derived_from<T, bounded_value_base_base>
+    constexpr adaptive_integer(const T & v) : adaptive_integer(v.value()) {}
+
+    constexpr adaptive_integer(const adaptive_integer & o)
+        : _small(o._small)
+        , _big(o._big ? clone(*o._big) : nullptr) {}
+    constexpr adaptive_integer(adaptive_integer &&) noexcept = default;
+    constexpr adaptive_integer & operator=(const adaptive_integer & o) {
+        if(this != &o) {
+            _small = o._small;
+            _big = o._big ? clone(*o._big) : nullptr;
+        }
+        return *this;
+    }
+    constexpr adaptive_integer & operator=(adaptive_integer &&) noexcept =
+        default;
+
+    // Whether the value left the inline tier; for tests and statistics, the
+    // value is the same either way.
+    [[nodiscard]] constexpr bool is_big() const noexcept {
+        return static_cast<bool>(_big);
+    }
+
+    explicit constexpr operator double() const noexcept {
+        return _big ? _big->to_double() : static_cast<double>(_small);
+    }
+    [[nodiscard]] std::string to_string() const { return to_big().to_string(); }
+    friend std::ostream & operator<<(std::ostream & os,
+                                     const adaptive_integer & v) {
+        return os << v.to_string();
+    }
+
+    [[nodiscard]] constexpr adaptive_integer operator+() const { return *this; }
+    [[nodiscard]] constexpr adaptive_integer operator-() const {
+        small_int r;
+        if(!_big && !detail::sub_overflow(0, _small, r)) [[likely]]
+            return adaptive_integer(small_tag{}, r);
+        return big_negate(*this);
+    }
+
+    // Hidden friends on two adaptive_integer: an integral or bounded_value
+    // operand gets there through the implicit constructors.
+    [[nodiscard]] friend constexpr adaptive_integer operator+(
+        const adaptive_integer & a, const adaptive_integer & b) {
+        small_int r;
+        if(!a._big && !b._big && !detail::add_overflow(a._small, b._small, r))
+            [[likely]]
+            return adaptive_integer(small_tag{}, r);
+        return big_add(a, b);
+    }
+    [[nodiscard]] friend constexpr adaptive_integer operator-(
+        const adaptive_integer & a, const adaptive_integer & b) {
+        small_int r;
+        if(!a._big && !b._big && !detail::sub_overflow(a._small, b._small, r))
+            [[likely]]
+            return adaptive_integer(small_tag{}, r);
+        return big_subtract(a, b);
+    }
+    [[nodiscard]] friend constexpr adaptive_integer operator*(
+        const adaptive_integer & a, const adaptive_integer & b) {
+        small_int r;
+        if(!a._big && !b._big && !detail::mul_overflow(a._small, b._small, r))
+            [[likely]]
+            return adaptive_integer(small_tag{}, r);
+        return big_multiply(a, b);
+    }
+
+    // The const_value<int, 1> denominators of integer<adaptive_integer>
+    // multiply everything in the rational operators; built-in components fold
+    // these away, and so does this.
+    template <typename T, T V, typename PS>
+    [[nodiscard]] friend constexpr adaptive_integer operator*(
+        const adaptive_integer & a, const const_value<T, V, PS> &) {
+        if constexpr(V == 1) return a;
+        else return a * adaptive_integer(V);
+    }
+    template <typename T, T V, typename PS>
+    [[nodiscard]] friend constexpr adaptive_integer operator*(
+        const const_value<T, V, PS> & c, const adaptive_integer & a) {
+        return a * c;
+    }
+
+    constexpr adaptive_integer & operator+=(const adaptive_integer & o) {
+        return *this = *this + o;
+    }
+    constexpr adaptive_integer & operator-=(const adaptive_integer & o) {
+        return *this = *this - o;
+    }
+    constexpr adaptive_integer & operator*=(const adaptive_integer & o) {
+        return *this = *this * o;
+    }
+
+    // A big value is out of the inline range, so it is ordered against an
+    // inline one by its sign alone.
+    [[nodiscard]] friend constexpr bool operator==(const adaptive_integer & a,
+                                                   const adaptive_integer & b) {
+        if(!a._big && !b._big) [[likely]]
+            return a._small == b._small;
+        if(a._big && b._big) return *a._big == *b._big;
+        return false;
+    }
+    [[nodiscard]] friend constexpr std::strong_ordering operator<=>(
+        const adaptive_integer & a, const adaptive_integer & b) {
+        if(!a._big && !b._big) [[likely]]
+            return a._small <=> b._small;
+        if(a._big && b._big) return *a._big <=> *b._big;
+        if(a._big)
+            return a._big->is_negative() ? std::strong_ordering::less
+                                         : std::strong_ordering::greater;
+        return b._big->is_negative() ? std::strong_ordering::greater
+                                     : std::strong_ordering::less;
+    }
+};
+
+// Exact rationals that do not overflow: unnormalized like every rational,
+// compared by cross-multiplication, and as fast as 128-bit arithmetic while
+// the components fit there.
+using adaptive_rational = rational<adaptive_integer, adaptive_integer>;
+
+}  // namespace numeric
+}  // namespace melon
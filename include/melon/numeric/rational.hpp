@@ -133,7 +133,8 @@ public:
     // operands' denominators, so a chain of operations on plain integral
     // components grows them multiplicatively until they overflow, silently.
     // Call normalize() along the way, or use components that track their own
-    // bounds (bounded_value), when the chain is long.
+    // bounds (bounded_value) or do not overflow (adaptive_integer), when the
+    // chain is long.
     //
     // Hidden friends, the ADL-hygiene shape: namespace-scope operator
     // templates would be candidates for *every* unqualified `a op b` in melon,
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <random>
 #include <ranges>
@@ -13,8 +16,48 @@
 #include "melon/container/d_ary_heap.hpp"
 #include "melon/container/static_map.hpp"
 #include "melon/detail/stdlib_check.hpp"
+#include "melon/detail/thread_team.hpp"
 
 namespace melon {
+namespace detail {
+
+// 64 uniform bits from any generator: its output as is when it spans them,
+// two outputs when it spans 32 bits, as std::mt19937 does, and through
+// std::uniform_int_distribution otherwise.
+template <std::uniform_random_bit_generator Generator>
+[[nodiscard]] std::uint64_t random_word(Generator & gen) {
+    constexpr std::uint64_t max = Generator::max();
+    if constexpr(Generator::min() == 0 && max == ~std::uint64_t{0}) {
+        return gen();
+    } else if constexpr(Generator::min() == 0 && max == 0xffffffffu) {
+        const std::uint64_t high = gen();
+        return (high << 32) | gen();
+    } else {
+        return std::uniform_int_distribution<std::uint64_t>()(gen);
+    }
+}
+
+// The high and the low 64 bits of a * b.
+[[nodiscard]] inline std::pair<std::uint64_t, std::uint64_t> wide_multiply(
+    const std::uint64_t a, const std::uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 product = static_cast<uint128>(a) * b;
+    return {static_cast<std::uint64_t>(product >> 64),
+            static_cast<std::uint64_t>(product)};
+#else
+    const std::uint64_t a_low = a & 0xffffffffu, a_high = a >> 32;
+    const std::uint64_t b_low = b & 0xffffffffu, b_high = b >> 32;
+    const std::uint64_t low_low = a_low * b_low;
+    const std::uint64_t high_low = a_high * b_low;
+    const std::uint64_t cross =
+        (low_low >> 32) + (high_low & 0xffffffffu) + a_low * b_high;
+    return {a_high * b_high + (high_low >> 32) + (cross >> 32),
+            (cross << 32) | (low_low & 0xffffffffu)};
+#endif
+}
+
+}  // namespace detail
 
 template <typename Traits>
 concept alias_method_sampler_traits = requires {
@@ -39,20 +82,35 @@ public:
     using result_type = std::ranges::range_reference_t<ItemRange>;
 
 private:
-    using index_type = int;
+    using index_type = std::size_t;
+
+    // The probability of keeping the drawn index and its alias side by side,
+    // so that a draw touches one cache line of the table.
+    struct bucket {
+        Prob prob;
+        index_type alias;
+    };
+
+    // The chunks the parallel construction works by, of a fixed size so that
+    // its sums, hence the table, do not depend on the number of threads.
+    static constexpr std::size_t build_chunk_size = std::size_t{1} << 14;
+    static constexpr std::size_t batch_size = 256;
 
     ItemRange _items;
-    static_map<index_type, Prob> _probs;
-    static_map<index_type, index_type> _aliases;
+    static_map<index_type, bucket> _buckets;
     index_type _last_index;
 
+    [[nodiscard]] constexpr result_type item_at(const index_type i) const {
+        return _items[static_cast<std::ranges::range_difference_t<ItemRange>>(
+            i)];
+    }
+
 public:
     template <std::ranges::random_access_range R,
               std::invocable<std::ranges::range_value_t<R>> P>
     constexpr alias_method_sampler(R && items, P && prob_map)
         : _items(std::views::all(std::forward<R>(items)))
-        , _probs(_items.size())
-        , _aliases(_items.size())
+        , _buckets(_items.size())
         , _last_index(static_cast<index_type>(_items.size()) - index_type{1}) {
         // An empty item range would give the index distribution the range
         // [0, -1], whose precondition is a <= b.
@@ -71,14 +129,14 @@ public:
         for(auto && [i, item] : std::views::enumerate(_items)) {
             const Prob w = prob_map(item);
             assert(w >= Prob{0});
-            _probs[static_cast<index_type>(i)] = w;
+            _buckets[static_cast<index_type>(i)].prob = w;
             weights_sum += w;
         }
         assert(weights_sum > Prob{0});
         const Prob scale = static_cast<Prob>(n) / weights_sum;
-        for(index_type i = 0; i < static_cast<index_type>(n); ++i) {
-            const Prob prob = _probs[i] * scale;
-            _probs[i] = prob;
+        for(index_type i = 0; i < n; ++i) {
+            const Prob prob = _buckets[i].prob * scale;
+            _buckets[i] = bucket{prob, i};
             *overfull_end = *underfull_end = i;
             const bool is_underfull = (prob < 1.0);
             underfull_end += is_underfull;
@@ -89,21 +147,23 @@ public:
         auto underfull_it = underfull_buckets.get();
 
         if constexpr(Traits::heuristic_preprocessing) {
-            std::make_heap(
-                overfull_it, overfull_end,
-                [this](auto && i, auto && j) { return _probs[i] < _probs[j]; });
-            std::make_heap(
-                underfull_it, underfull_end,
-                [this](auto && i, auto && j) { return _probs[i] > _probs[j]; });
+            std::make_heap(overfull_it, overfull_end,
+                           [this](auto && i, auto && j) {
+                               return _buckets[i].prob < _buckets[j].prob;
+                           });
+            std::make_heap(underfull_it, underfull_end,
+                           [this](auto && i, auto && j) {
+                               return _buckets[i].prob > _buckets[j].prob;
+                           });
         }
 
         for(; overfull_it != overfull_end && underfull_it != underfull_end;
             ++overfull_it, ++underfull_it) {
             const index_type overfull_index = *overfull_it;
             const index_type underfull_index = *underfull_it;
-            auto & overfull_prob = _probs[overfull_index];
-            const auto & underfull_prob = _probs[underfull_index];
-            auto & underfull_alias = _aliases[underfull_index];
+            auto & overfull_prob = _buckets[overfull_index].prob;
+            const auto & underfull_prob = _buckets[underfull_index].prob;
+            auto & underfull_alias = _buckets[underfull_index].alias;
 
             overfull_prob = (overfull_prob + underfull_prob) - 1.0;
             underfull_alias = overfull_index;
@@ -114,9 +174,175 @@ public:
             overfull_end += !became_underfull;
         }
         for(; overfull_it != overfull_end; ++overfull_it)
-            _probs[*overfull_it] = 1.0;
+            _buckets[*overfull_it].prob = 1.0;
         for(; underfull_it != underfull_end; ++underfull_it)
-            _probs[*underfull_it] = 1.0;
+            _buckets[*underfull_it].prob = 1.0;
+    }
+
+    // Builds the table on num_threads threads, by the sweep of Hübschle-
+    // Schneider and Sanders rather than the pairing above: the table differs
+    // from the serial constructor's, but not with the number of threads.
+    // The scaled weights below 1 (light) and from 1 on (heavy) are listed in
+    // index order, with the running sums D of the lights' deficits 1 - w and
+    // E of the heavies' excesses w - 1. The sweep covers each light by the
+    // current heavy while the lights' deficit before it is below the excess
+    // up to that heavy; otherwise the heavy, whose remaining weight has
+    // fallen under 1, is covered by the next heavy. That is a merge of the
+    // two sorted sequences of sums, and each step is decided by the sums
+    // alone, so the merge is cut into pieces run in parallel, each finding
+    // where it starts by binary search. prob_map is called from several
+    // threads at once.
+    template <std::ranges::random_access_range R,
+              std::invocable<std::ranges::range_value_t<R>> P>
+        requires(!Traits::heuristic_preprocessing)
+    alias_method_sampler(R && items, P && prob_map,
+                         const std::size_t num_threads)
+        : _items(std::views::all(std::forward<R>(items)))
+        , _buckets(_items.size())
+        , _last_index(static_cast<index_type>(_items.size()) - index_type{1}) {
+        assert(!std::ranges::empty(_items));
+        assert(num_threads > 0);
+        const std::size_t n = _items.size();
+        const std::size_t num_chunks =
+            (n + build_chunk_size - 1) / build_chunk_size;
+        detail::thread_team team(std::min(num_threads, num_chunks));
+        auto for_each_chunk = [&](auto && body) {
+            detail::parallel_for(
+                team, num_chunks, 1,
+                [&](const std::size_t first, const std::size_t last,
+                    std::size_t) {
+                    for(std::size_t c = first; c < last; ++c)
+                        body(c * build_chunk_size,
+                             std::min(n, (c + 1) * build_chunk_size), c);
+                });
+        };
+
+        std::vector<Prob> chunk_sums(num_chunks);
+        for_each_chunk([&](const std::size_t first, const std::size_t last,
+                           const std::size_t c) {
+            Prob sum = Prob{0};
+            for(index_type i = first; i < last; ++i) {
+                const Prob w = prob_map(item_at(i));
+                assert(w >= Prob{0});
+                _buckets[i] = bucket{w, i};
+                sum += w;
+            }
+            chunk_sums[c] = sum;
+        });
+        Prob weights_sum = Prob{0};
+        for(const Prob sum : chunk_sums) weights_sum += sum;
+        assert(weights_sum > Prob{0});
+        const Prob scale = static_cast<Prob>(n) / weights_sum;
+
+        // per chunk, then from the chunks before: the lights, the deficits
+        // and the excesses
+        std::vector<std::size_t> lights_before(num_chunks + 1, 0);
+        std::vector<Prob> deficit_before(num_chunks + 1, Prob{0});
+        std::vector<Prob> excess_before(num_chunks + 1, Prob{0});
+        for_each_chunk([&](const std::size_t first, const std::size_t last,
+                           const std::size_t c) {
+            std::size_t num_lights = 0;
+            Prob deficit = Prob{0};
+            Prob excess = Prob{0};
+            for(index_type i = first; i < last; ++i) {
+                const Prob prob = _buckets[i].prob * scale;
+                _buckets[i].prob = prob;
+                if(prob < Prob{1}) {
+                    ++num_lights;
+                    deficit += Prob{1} - prob;
+                } else {
+                    excess += prob - Prob{1};
+                }
+            }
+            lights_before[c + 1] = num_lights;
+            deficit_before[c + 1] = deficit;
+            excess_before[c + 1] = excess;
+        });
+        for(std::size_t c = 0; c < num_chunks; ++c) {
+            lights_before[c + 1] += lights_before[c];
+            deficit_before[c + 1] += deficit_before[c];
+            excess_before[c + 1] += excess_before[c];
+        }
+
+        // the lights with D before them, the heavies with E up to them
+        struct entry {
+            index_type index;
+            Prob sum;
+        };
+        const std::size_t num_lights = lights_before[num_chunks];
+        const std::size_t num_heavies = n - num_lights;
+        // With all the weights equal and not representable, every scaled one
+        // may round below 1, or from 1 on: no pair to make, every bucket is
+        // kept, as the serial constructor's leftovers are.
+        if(num_lights == 0 || num_heavies == 0) {
+            for(index_type i = 0; i < n; ++i) _buckets[i].prob = Prob{1};
+            return;
+        }
+        auto lights = std::make_unique_for_overwrite<entry[]>(num_lights);
+        auto heavies = std::make_unique_for_overwrite<entry[]>(num_heavies);
+        for_each_chunk([&](const std::size_t first, const std::size_t last,
+                           const std::size_t c) {
+            std::size_t l = lights_before[c];
+            std::size_t h = first - l;
+            Prob deficit = deficit_before[c];
+            Prob excess = excess_before[c];
+            for(index_type i = first; i < last; ++i) {
+                const Prob prob = _buckets[i].prob;
+                if(prob < Prob{1}) {
+                    lights[l++] = entry{i, deficit};
+                    deficit += Prob{1} - prob;
+                } else {
+                    excess += prob - Prob{1};
+                    heavies[h++] = entry{i, excess};
+                }
+            }
+        });
+
+        // The last heavy is never covered: it takes what is left of the
+        // lights, and keeps its bucket.
+        const std::size_t num_steps = num_lights + num_heavies - 1;
+        const Prob total_deficit = deficit_before[num_chunks];
+        auto light_first = [&](const std::size_t l, const std::size_t h) {
+            return l < num_lights &&
+                   (h + 1 == num_heavies || lights[l].sum < heavies[h].sum);
+        };
+        const std::size_t num_step_chunks =
+            (num_steps + build_chunk_size - 1) / build_chunk_size;
+        detail::parallel_for(
+            team, num_step_chunks, 1,
+            [&](const std::size_t first_chunk, const std::size_t last_chunk,
+                std::size_t) {
+                const std::size_t first = first_chunk * build_chunk_size;
+                const std::size_t last =
+                    std::min(num_steps, last_chunk * build_chunk_size);
+                // the fewest lights among the first `first` steps such that
+                // the next light does not go before the heavies taken
+                std::size_t low =
+                    first > num_heavies - 1 ? first - (num_heavies - 1) : 0;
+                std::size_t high = std::min(first, num_lights);
+                while(low < high) {
+                    const std::size_t l = low + (high - low) / 2;
+                    if(light_first(l, first - l - 1))
+                        low = l + 1;
+                    else
+                        high = l;
+                }
+                std::size_t l = low;
+                std::size_t h = first - low;
+                for(std::size_t step = first; step < last; ++step) {
+                    if(light_first(l, h)) {
+                        _buckets[lights[l++].index].alias = heavies[h].index;
+                        continue;
+                    }
+                    const Prob deficit =
+                        l < num_lights ? lights[l].sum : total_deficit;
+                    _buckets[heavies[h].index] =
+                        bucket{Prob{1} + heavies[h].sum - deficit,
+                               heavies[h + 1].index};
+                    ++h;
+                }
+            });
+        _buckets[heavies[num_heavies - 1].index].prob = Prob{1};
     }
 
 public:
@@ -135,15 +361,61 @@ public:
     // The two distributions are locals, not `mutable` members: a distribution
     // carries its own state, so writing one through a const operator() would
     // race between two threads sampling from the same const sampler.
+    // The drawn index is kept on a coin strictly below its probability, so an
+    // item of zero weight is never drawn, not even on a coin of exactly 0.
     template <std::uniform_random_bit_generator Generator>
     [[nodiscard]] decltype(auto) operator()(Generator & gen) const {
         std::uniform_int_distribution<index_type> index_distribution(
             index_type{0}, _last_index);
         std::uniform_real_distribution<Prob> prob_distribution(0.0, 1.0);
         const index_type i = index_distribution(gen);
-        const auto prob = _probs[i];
-        const auto alias = _aliases[i];
-        return _items[i + (prob_distribution(gen) > prob) * (alias - i)];
+        const auto [prob, alias] = _buckets[i];
+        return item_at(prob_distribution(gen) < prob ? i : alias);
+    }
+
+    // Fills `out` with independent draws, batch_size at a time: the random
+    // words first, in a loop of generator calls alone, then the items. The
+    // index and the coin of a draw both come from one 64-bit word u, as the
+    // integral and the fractional parts of u n / 2^64, so each is off the
+    // uniform by at most n / 2^64 -- without the rejection loop and the
+    // division of the std distributions. The buckets of a batch are
+    // prefetched before any is read, so that the cache misses of a large
+    // table overlap. The draws are not those of as many calls to operator().
+    template <std::uniform_random_bit_generator Generator,
+              std::ranges::forward_range Out>
+        requires std::ranges::output_range<Out, result_type>
+    void sample_n(Generator & gen, Out && out) const {
+        // the leading bits of the fraction that Prob holds exactly
+        constexpr int coin_bits =
+            std::min(std::numeric_limits<Prob>::digits, 64);
+        constexpr Prob coin_scale =
+            Prob{1} / static_cast<Prob>(std::uint64_t{1} << (coin_bits - 1)) /
+            Prob{2};
+        const std::uint64_t n = _last_index + 1;
+        std::array<std::uint64_t, batch_size> words;
+        std::array<index_type, batch_size> indices;
+        auto out_it = std::ranges::begin(out);
+        const auto out_end = std::ranges::end(out);
+        while(out_it != out_end) {
+            std::size_t size = 0;
+            for(auto it = out_it; size < batch_size && it != out_end;
+                ++size, ++it)
+                words[size] = detail::random_word(gen);
+            for(std::size_t k = 0; k < size; ++k) {
+                const auto [index, fraction] =
+                    detail::wide_multiply(words[k], n);
+                indices[k] = static_cast<index_type>(index);
+                words[k] = fraction >> (64 - coin_bits);
+#if defined(__GNUC__)
+                __builtin_prefetch(&_buckets[indices[k]]);
+#endif
+            }
+            for(std::size_t k = 0; k < size; ++k, ++out_it) {
+                const auto [prob, alias] = _buckets[indices[k]];
+                const Prob coin = static_cast<Prob>(words[k]) * coin_scale;
+                *out_it = item_at(coin < prob ? indices[k] : alias);
+            }
+        }
     }
 };
 
@@ -153,11 +425,28 @@ alias_method_sampler(Range &&, ProbMap &&)
         std::views::all_t<Range>,
         std::invoke_result_t<ProbMap, std::ranges::range_value_t<Range>>>;
 
-template <typename Range, typename ProbMap, typename Traits>
+template <typename Range, typename ProbMap>
+alias_method_sampler(Range &&, ProbMap &&, std::size_t)
+    -> alias_method_sampler<
+        std::views::all_t<Range>,
+        std::invoke_result_t<ProbMap, std::ranges::range_value_t<Range>>>;
+
+// Constrained, or it would also take the three arguments of the
+// thread-count constructor, the items for the traits.
+template <typename Range, typename ProbMap,
+          alias_method_sampler_traits Traits>
 alias_method_sampler(Traits, Range &&, ProbMap &&)
     -> alias_method_sampler<
         std::views::all_t<Range>,
         std::invoke_result_t<ProbMap, std::ranges::range_value_t<Range>>,
         Traits>;
 
+template <typename Range, typename ProbMap,
+          alias_method_sampler_traits Traits>
+alias_method_sampler(Traits, Range &&, ProbMap &&, std::size_t)
+    -> alias_method_sampler<
+        std::views::all_t<Range>,
+        std::invoke_result_t<ProbMap, std::ranges::range_value_t<Range>>,
+        Traits>;
+
 }  // namespace melon
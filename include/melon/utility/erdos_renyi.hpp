@@ -1,36 +1,140 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <random>
+#include <utility>
+#include <vector>
 
 #include "melon/container/static_digraph.hpp"
+#include "melon/detail/thread_team.hpp"
 #include "melon/graph.hpp"
-#include "melon/utility/static_digraph_builder.hpp"
 
 namespace melon {
+namespace detail {
+
+// The arcs of rows [first_row, last_row) of a G(n, p) digraph, by the
+// geometric skips of Batagelj and Brandes: the n - 1 possible arcs of each
+// row are numbered in order of source then target, and the gap to the next
+// arc is drawn from the geometric distribution of parameter p, as
+// floor(log(1 - u) / log(1 - p)). So the cost is one draw per arc, not per
+// pair, and the arcs come out sorted.
+template <typename Vertex>
+void erdos_renyi_rows(const std::uint64_t num_vertices,
+                      const double log_complement, const std::uint64_t seed,
+                      const std::uint64_t first_row,
+                      const std::uint64_t last_row,
+                      std::vector<Vertex> & sources,
+                      std::vector<Vertex> & targets) {
+    const std::uint64_t row_size = num_vertices - 1;
+    std::mt19937_64 engine(seed);
+    std::uniform_real_distribution<double> distr{0.0, 1.0};
+    // the next candidate is the arc to the position-th vertex but the source;
+    // the division is done once per row crossed, not once per arc
+    std::uint64_t source = first_row;
+    std::uint64_t position = 0;
+    for(;; ++position) {
+        // 1 - u is exact, u being a multiple of 2^-53
+        const double skip =
+            std::floor(std::log(1.0 - distr(engine)) / log_complement);
+        const std::uint64_t left = (last_row - source) * row_size - position;
+        if(!(skip < static_cast<double>(left))) return;
+        position += static_cast<std::uint64_t>(skip);
+        if(position >= row_size) {
+            source += position / row_size;
+            position %= row_size;
+        }
+        sources.push_back(static_cast<Vertex>(source));
+        targets.push_back(static_cast<Vertex>(
+            position < source ? position : position + 1));
+    }
+}
+
+}  // namespace detail
 
 // The generator is taken by reference so the caller owns the seed: this
 // overload is the only way to get a reproducible random graph, and the only
 // one safe to call concurrently (each thread with its own generator).
-// The distribution stays a local for the same reason: it carries state of its
-// own, so a function-local `static` would race between concurrent calls.
+//
+// The rows are cut into blocks of about 2^16 expected arcs each, and each
+// block is drawn by a std::mt19937_64 of its own, seeded by one draw of the
+// caller's generator: the graph is the same whatever num_threads, and the
+// blocks are dealt to that many threads. The arcs come sorted by source then
+// target, and go to G's (num_vertices, sources, targets) constructor without
+// being sorted again. O(n + m) time and draws.
 template <typename G, std::uniform_random_bit_generator Generator>
 [[nodiscard]] G erdos_renyi(const std::size_t num_vertices_,
-                            const double expected_density, Generator & gen) {
+                            const double expected_density, Generator & gen,
+                            const std::size_t num_threads = 1) {
     using vertex = vertex_t<G>;
+    assert(num_threads > 0);
+    std::vector<vertex> sources;
+    std::vector<vertex> targets;
+    if(num_vertices_ < 2 || !(expected_density > 0.0))
+        return G(num_vertices_, std::move(sources), std::move(targets));
 
-    std::uniform_real_distribution<double> distr{0.0, 1.0};
-    static_digraph_builder<G> builder(num_vertices_);
+    const std::uint64_t n = num_vertices_;
+    const double log_complement =
+        expected_density < 1.0 ? std::log1p(-expected_density)
+                               : -std::numeric_limits<double>::infinity();
+    const double row_arcs =
+        std::min(1.0, expected_density) * static_cast<double>(n - 1);
+    const std::uint64_t rows_per_block = static_cast<std::uint64_t>(
+        std::clamp(65536.0 / row_arcs, 1.0, static_cast<double>(n)));
+    const std::size_t num_blocks = (n + rows_per_block - 1) / rows_per_block;
+    std::vector<std::uint64_t> seeds(num_blocks);
+    std::uniform_int_distribution<std::uint64_t> seed_distr;
+    for(auto & seed : seeds) seed = seed_distr(gen);
 
-    for(std::size_t i = 0; i < num_vertices_; ++i) {
-        for(std::size_t j = 0; j < num_vertices_; ++j) {
-            if(i == j) continue;
-            if(distr(gen) < expected_density)
-                builder.add_arc(vertex(i), vertex(j));
+    auto block_rows = [&](const std::size_t b) {
+        const std::uint64_t first = b * rows_per_block;
+        return std::pair{first, std::min(n, first + rows_per_block)};
+    };
+    if(num_threads == 1 || num_blocks == 1) {
+        for(std::size_t b = 0; b < num_blocks; ++b) {
+            const auto [first, last] = block_rows(b);
+            detail::erdos_renyi_rows(n, log_complement, seeds[b], first, last,
+                                     sources, targets);
         }
+        return G(num_vertices_, std::move(sources), std::move(targets));
     }
 
-    return std::get<0>(builder.build());
+    std::vector<std::vector<vertex>> block_sources(num_blocks);
+    std::vector<std::vector<vertex>> block_targets(num_blocks);
+    detail::thread_team team(std::min(num_threads, num_blocks));
+    detail::parallel_for(
+        team, num_blocks, 1,
+        [&](const std::size_t first_block, const std::size_t last_block,
+            std::size_t) {
+            for(std::size_t b = first_block; b < last_block; ++b) {
+                const auto [first, last] = block_rows(b);
+                detail::erdos_renyi_rows(n, log_complement, seeds[b], first,
+                                         last, block_sources[b],
+                                         block_targets[b]);
+            }
+        });
+    std::vector<std::size_t> offsets(num_blocks + 1, 0);
+    for(std::size_t b = 0; b < num_blocks; ++b)
+        offsets[b + 1] = offsets[b] + block_sources[b].size();
+    sources.resize(offsets[num_blocks]);
+    targets.resize(offsets[num_blocks]);
+    detail::parallel_for(
+        team, num_blocks, 1,
+        [&](const std::size_t first_block, const std::size_t last_block,
+            std::size_t) {
+            for(std::size_t b = first_block; b < last_block; ++b) {
+                const auto offset = static_cast<std::ptrdiff_t>(offsets[b]);
+                std::ranges::copy(block_sources[b], sources.begin() + offset);
+                std::ranges::copy(block_targets[b], targets.begin() + offset);
+                std::vector<vertex>().swap(block_sources[b]);
+                std::vector<vertex>().swap(block_targets[b]);
+            }
+        });
+    return G(num_vertices_, std::move(sources), std::move(targets));
 }
 
 // Seeds a generator of its own from std::random_device, so successive calls
@@ -0,0 +1,474 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "melon/container/static_digraph.hpp"
+#include "melon/container/static_map.hpp"
+#include "melon/detail/thread_team.hpp"
+#include "melon/graph.hpp"
+
+// Benchmark instances with the structure of real inputs, where erdos_renyi
+// has none: power-law digraphs (R-MAT, preferential attachment), road-like
+// grids and random geometric graphs. Every generator takes the caller's
+// generator by reference and a thread count, and the instance depends on the
+// generator's state only: the work is cut into fixed blocks, each drawn by a
+// std::mt19937_64 of its own seeded by one draw of the caller's generator, and
+// the threads only share the blocks out. Each returns a flat tuple, the
+// static_digraph_builder shape: the static_digraph, then its maps.
+//
+// The arc weights are drawn by a copy of the given distribution, or of any
+// callable taking a std::mt19937_64 &, in arc order once the graph is built.
+
+namespace melon {
+namespace detail {
+
+// The unit of work of the generators: about this many arcs, or points.
+inline constexpr std::size_t generator_block_size = std::size_t{1} << 16;
+
+template <std::uniform_random_bit_generator Generator>
+[[nodiscard]] std::vector<std::uint64_t> generator_seeds(
+    Generator & gen, const std::size_t count) {
+    std::vector<std::uint64_t> seeds(count);
+    std::uniform_int_distribution<std::uint64_t> distribution;
+    for(auto & seed : seeds) seed = distribution(gen);
+    return seeds;
+}
+
+template <typename F>
+void for_each_generator_block(thread_team & team, const std::size_t num_blocks,
+                              F && f) {
+    parallel_for(team, num_blocks, 1,
+                 [&](const std::size_t first, const std::size_t last,
+                     std::size_t) {
+                     for(std::size_t b = first; b < last; ++b) f(b);
+                 });
+}
+
+template <typename Distribution, std::uniform_random_bit_generator Generator>
+    requires std::invocable<Distribution &, std::mt19937_64 &>
+[[nodiscard]] auto random_arc_map(thread_team & team,
+                                  const static_digraph & graph,
+                                  const Distribution & distribution,
+                                  Generator & gen) {
+    using value = std::remove_cvref_t<
+        std::invoke_result_t<Distribution &, std::mt19937_64 &>>;
+    auto map = graph.create_arc_map<value>();
+    const std::size_t num_arcs = graph.num_arcs();
+    const std::size_t num_blocks =
+        (num_arcs + generator_block_size - 1) / generator_block_size;
+    const auto seeds = generator_seeds(gen, num_blocks);
+    for_each_generator_block(team, num_blocks, [&](const std::size_t b) {
+        std::mt19937_64 engine(seeds[b]);
+        // a copy per block: a distribution may carry state between draws
+        Distribution block_distribution = distribution;
+        const std::size_t last =
+            std::min(num_arcs, (b + 1) * generator_block_size);
+        for(std::size_t a = b * generator_block_size; a < last; ++a)
+            map[static_cast<arc_t<static_digraph>>(a)] =
+                std::invoke(block_distribution, engine);
+    });
+    return map;
+}
+
+// The static_digraph of arcs in any order: a stable counting sort on the
+// sources, O(n + m), for the generators whose arcs do not come out sorted.
+[[nodiscard]] inline static_digraph digraph_by_source(
+    const std::size_t num_vertices,
+    const std::vector<vertex_t<static_digraph>> & sources,
+    const std::vector<vertex_t<static_digraph>> & targets) {
+    using vertex = vertex_t<static_digraph>;
+    std::vector<std::size_t> begin(num_vertices + 1, 0);
+    for(const vertex s : sources) ++begin[s + 1];
+    std::partial_sum(begin.begin(), begin.end(), begin.begin());
+    std::vector<vertex> sorted_sources(sources.size());
+    std::vector<vertex> sorted_targets(targets.size());
+    for(std::size_t u = 0; u < num_vertices; ++u)
+        std::fill(sorted_sources.begin() +
+                      static_cast<std::ptrdiff_t>(begin[u]),
+                  sorted_sources.begin() +
+                      static_cast<std::ptrdiff_t>(begin[u + 1]),
+                  static_cast<vertex>(u));
+    for(std::size_t a = 0; a < sources.size(); ++a)
+        sorted_targets[begin[sources[a]]++] = targets[a];
+    return static_digraph(num_vertices, std::move(sorted_sources),
+                          std::move(sorted_targets));
+}
+
+// splitmix64's finalizer: a bijection of the 64-bit words whose outputs look
+// independent even for consecutive inputs.
+[[nodiscard]] constexpr std::uint64_t mix_bits(std::uint64_t x) noexcept {
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+}  // namespace detail
+
+// The Graph500 defaults: d = 1 - a - b - c = 0.05.
+struct rmat_parameters {
+    std::size_t scale;
+    std::size_t edge_factor = 16;
+    double a = 0.57;
+    double b = 0.19;
+    double c = 0.19;
+    bool scramble_ids = true;
+};
+
+// The R-MAT (Kronecker) digraph of Graph500: 2^scale vertices and
+// edge_factor * 2^scale arcs, each placed by descending scale times into one
+// of the four quadrants of the adjacency matrix, with probabilities a, b, c
+// and d. With scramble_ids, the vertices are then renumbered by a random
+// permutation, or the hubs would be the low ids. Self-loops and parallel arcs
+// are kept, as in Graph500. The arcs are drawn in parallel, then sorted by
+// source in one serial counting pass.
+template <std::uniform_random_bit_generator Generator,
+          typename WeightDistribution>
+    requires std::invocable<WeightDistribution &, std::mt19937_64 &>
+[[nodiscard]] auto rmat_digraph(const rmat_parameters & parameters,
+                                Generator & gen,
+                                const WeightDistribution & weight_distribution,
+                                const std::size_t num_threads = 1) {
+    using vertex = vertex_t<static_digraph>;
+    assert(num_threads > 0);
+    assert(parameters.scale < std::numeric_limits<vertex>::digits);
+    assert(parameters.a >= 0.0 && parameters.b >= 0.0 && parameters.c >= 0.0);
+    assert(parameters.a + parameters.b + parameters.c <= 1.0);
+    const std::size_t num_vertices = std::size_t{1} << parameters.scale;
+    const std::size_t num_arcs = parameters.edge_factor * num_vertices;
+    assert(num_arcs <= std::numeric_limits<arc_t<static_digraph>>::max());
+
+    std::vector<vertex> ids(num_vertices);
+    std::iota(ids.begin(), ids.end(), vertex{0});
+    if(parameters.scramble_ids)
+        std::shuffle(ids.begin(), ids.end(),
+                     std::mt19937_64(detail::generator_seeds(gen, 1)[0]));
+
+    // A level takes 16 bits of a word, compared with the cumulated
+    // probabilities rounded to multiples of 2^-16: far below the noise of any
+    // benchmark, and a quarter of the engine calls of one word per level,
+    // which would dominate the generation.
+    const auto threshold = [](const double p) {
+        return static_cast<std::uint64_t>(
+            std::round(std::ldexp(std::min(p, 1.0), 16)));
+    };
+    const std::uint64_t to_b = threshold(parameters.a);
+    const std::uint64_t to_c = threshold(parameters.a + parameters.b);
+    const std::uint64_t to_d =
+        threshold(parameters.a + parameters.b + parameters.c);
+
+    std::vector<vertex> sources(num_arcs);
+    std::vector<vertex> targets(num_arcs);
+    const std::size_t num_blocks =
+        (num_arcs + detail::generator_block_size - 1) /
+        detail::generator_block_size;
+    const auto seeds = detail::generator_seeds(gen, num_blocks);
+    detail::thread_team team(num_threads);
+    detail::for_each_generator_block(
+        team, num_blocks, [&](const std::size_t block) {
+            std::mt19937_64 engine(seeds[block]);
+            const std::size_t last =
+                std::min(num_arcs, (block + 1) * detail::generator_block_size);
+            for(std::size_t a = block * detail::generator_block_size; a < last;
+                ++a) {
+                std::size_t s = 0;
+                std::size_t t = 0;
+                std::uint64_t word = 0;
+                for(std::size_t level = 0; level < parameters.scale; ++level) {
+                    if(level % 4 == 0) word = engine();
+                    const std::uint64_t x = word & 0xffff;
+                    word >>= 16;
+                    // quadrants b and d on the right: x past an odd number
+                    // of the thresholds, counted without a branch
+                    s = 2 * s + (x >= to_c);
+                    t = 2 * t + ((x >= to_b) ^ (x >= to_c) ^ (x >= to_d));
+                }
+                sources[a] = ids[s];
+                targets[a] = ids[t];
+            }
+        });
+    auto graph = detail::digraph_by_source(num_vertices, sources, targets);
+    auto weights =
+        detail::random_arc_map(team, graph, weight_distribution, gen);
+    return std::make_tuple(std::move(graph), std::move(weights));
+}
+
+// The grid of the given extents, in any dimension, each vertex linked to its
+// 2 * D axis neighbors by one arc each way: a stand-in for road networks,
+// with low degree and a large diameter. The vertices are numbered in row-major
+// order, the last coordinate varying fastest, and the weights are drawn
+// independently for the two directions.
+//
+//   auto [grid, length] = random_grid_digraph(
+//       {1000, 1000}, gen, std::uniform_int_distribution<int>{1, 100});
+template <std::size_t D, std::uniform_random_bit_generator Generator,
+          typename WeightDistribution>
+    requires(D > 0) && std::invocable<WeightDistribution &, std::mt19937_64 &>
+[[nodiscard]] auto random_grid_digraph(
+    const std::size_t (&extents)[D], Generator & gen,
+    const WeightDistribution & weight_distribution,
+    const std::size_t num_threads = 1) {
+    using vertex = vertex_t<static_digraph>;
+    assert(num_threads > 0);
+    std::array<std::size_t, D> strides;
+    strides[D - 1] = 1;
+    for(std::size_t d = D - 1; d > 0; --d)
+        strides[d - 1] = strides[d] * extents[d];
+    const std::size_t num_vertices = strides[0] * extents[0];
+    assert(num_vertices <= std::numeric_limits<vertex>::max());
+
+    const auto for_each_neighbor = [&](const std::size_t u, auto && f) {
+        std::array<std::size_t, D> coords;
+        for(std::size_t d = 0; d < D; ++d)
+            coords[d] = u / strides[d] % extents[d];
+        // in increasing order of the targets
+        for(std::size_t d = 0; d < D; ++d)
+            if(coords[d] > 0) f(u - strides[d]);
+        for(std::size_t d = D; d-- > 0;)
+            if(coords[d] + 1 < extents[d]) f(u + strides[d]);
+    };
+
+    const std::size_t vertices_per_block = detail::generator_block_size / D;
+    const std::size_t num_blocks =
+        (num_vertices + vertices_per_block - 1) / vertices_per_block;
+    const auto block_vertices = [&](const std::size_t b) {
+        return std::pair{b * vertices_per_block,
+                         std::min(num_vertices, (b + 1) * vertices_per_block)};
+    };
+    detail::thread_team team(num_threads);
+    std::vector<std::size_t> offsets(num_blocks + 1, 0);
+    detail::for_each_generator_block(
+        team, num_blocks, [&](const std::size_t b) {
+            const auto [first, last] = block_vertices(b);
+            std::size_t count = 0;
+            for(std::size_t u = first; u < last; ++u)
+                for_each_neighbor(u, [&](std::size_t) { ++count; });
+            offsets[b + 1] = count;
+        });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    assert(offsets[num_blocks] <=
+           std::numeric_limits<arc_t<static_digraph>>::max());
+
+    std::vector<vertex> sources(offsets[num_blocks]);
+    std::vector<vertex> targets(offsets[num_blocks]);
+    detail::for_each_generator_block(
+        team, num_blocks, [&](const std::size_t b) {
+            const auto [first, last] = block_vertices(b);
+            std::size_t a = offsets[b];
+            for(std::size_t u = first; u < last; ++u) {
+                for_each_neighbor(u, [&](const std::size_t v) {
+                    sources[a] = static_cast<vertex>(u);
+                    targets[a] = static_cast<vertex>(v);
+                    ++a;
+                });
+            }
+        });
+    static_digraph graph(num_vertices, std::move(sources), std::move(targets));
+    auto weights =
+        detail::random_arc_map(team, graph, weight_distribution, gen);
+    return std::make_tuple(std::move(graph), std::move(weights));
+}
+
+// The points are std::pairs, so cartesian_points of geometry.hpp.
+using random_geometric_point = std::pair<double, double>;
+
+// num_vertices points drawn uniformly in the unit square, and an arc each way
+// between any two at Euclidean distance at most radius. The points are
+// bucketed into a grid of cells at least radius wide, so each point is only
+// compared with those of the 3 x 3 cells around its own: O(n + m) expected
+// time. The vertices are numbered cell by cell, so that close points have
+// close ids, and the arcs of each vertex come by increasing target.
+//
+// Returns the graph, the points as a vertex map and the arc lengths.
+template <std::uniform_random_bit_generator Generator>
+[[nodiscard]] auto random_geometric_digraph(const std::size_t num_vertices,
+                                            const double radius,
+                                            Generator & gen,
+                                            const std::size_t num_threads = 1) {
+    using vertex = vertex_t<static_digraph>;
+    using arc = arc_t<static_digraph>;
+    using point = random_geometric_point;
+    assert(num_threads > 0);
+    assert(radius > 0.0);
+    assert(num_vertices <= std::numeric_limits<vertex>::max());
+
+    // No more cells than points: past that, they would mostly be empty.
+    const auto cells_per_side = static_cast<std::size_t>(std::clamp(
+        std::floor(1.0 / radius), 1.0,
+        std::max(1.0, std::sqrt(static_cast<double>(num_vertices)))));
+    const auto cell_of = [cells_per_side](const double x) {
+        return std::min(cells_per_side - 1,
+                        static_cast<std::size_t>(
+                            x * static_cast<double>(cells_per_side)));
+    };
+
+    const std::size_t num_blocks =
+        (num_vertices + detail::generator_block_size - 1) /
+        detail::generator_block_size;
+    const auto block_vertices = [&](const std::size_t b) {
+        return std::pair{
+            b * detail::generator_block_size,
+            std::min(num_vertices, (b + 1) * detail::generator_block_size)};
+    };
+    const auto seeds = detail::generator_seeds(gen, num_blocks);
+    detail::thread_team team(num_threads);
+    std::vector<point> drawn_points(num_vertices);
+    std::vector<std::size_t> cells(num_vertices);
+    detail::for_each_generator_block(
+        team, num_blocks, [&](const std::size_t b) {
+            std::mt19937_64 engine(seeds[b]);
+            std::uniform_real_distribution<double> distribution(0.0, 1.0);
+            const auto [first, last] = block_vertices(b);
+            for(std::size_t i = first; i < last; ++i) {
+                const double x = distribution(engine);
+                const double y = distribution(engine);
+                drawn_points[i] = point{x, y};
+                cells[i] = cell_of(y) * cells_per_side + cell_of(x);
+            }
+        });
+
+    const std::size_t num_cells = cells_per_side * cells_per_side;
+    std::vector<std::size_t> cell_begin(num_cells + 1, 0);
+    for(const std::size_t cell : cells) ++cell_begin[cell + 1];
+    std::partial_sum(cell_begin.begin(), cell_begin.end(), cell_begin.begin());
+    static_map<vertex, point> points(num_vertices);
+    {
+        std::vector<std::size_t> next(cell_begin.begin(), cell_begin.end() - 1);
+        for(std::size_t i = 0; i < num_vertices; ++i)
+            points[static_cast<vertex>(next[cells[i]]++)] = drawn_points[i];
+    }
+    std::vector<point>().swap(drawn_points);
+    std::vector<std::size_t>().swap(cells);
+
+    const double squared_radius = radius * radius;
+    const auto for_each_neighbor = [&](const std::size_t u, auto && f) {
+        const auto [x, y] = points[static_cast<vertex>(u)];
+        const std::size_t cx = cell_of(x);
+        const std::size_t cy = cell_of(y);
+        // the cells in increasing order, so the targets too
+        for(std::size_t ny = cy > 0 ? cy - 1 : 0;
+            ny <= std::min(cy + 1, cells_per_side - 1); ++ny) {
+            for(std::size_t nx = cx > 0 ? cx - 1 : 0;
+                nx <= std::min(cx + 1, cells_per_side - 1); ++nx) {
+                const std::size_t cell = ny * cells_per_side + nx;
+                for(std::size_t v = cell_begin[cell]; v < cell_begin[cell + 1];
+                    ++v) {
+                    const auto [vx, vy] = points[static_cast<vertex>(v)];
+                    const double squared_distance =
+                        (vx - x) * (vx - x) + (vy - y) * (vy - y);
+                    if(v != u && squared_distance <= squared_radius)
+                        f(v, squared_distance);
+                }
+            }
+        }
+    };
+
+    std::vector<std::size_t> offsets(num_vertices + 1, 0);
+    detail::for_each_generator_block(
+        team, num_blocks, [&](const std::size_t b) {
+            const auto [first, last] = block_vertices(b);
+            for(std::size_t u = first; u < last; ++u)
+                for_each_neighbor(
+                    u, [&](std::size_t, double) { ++offsets[u + 1]; });
+        });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    const std::size_t num_arcs = offsets[num_vertices];
+    assert(num_arcs <= std::numeric_limits<arc>::max());
+
+    std::vector<vertex> sources(num_arcs);
+    std::vector<vertex> targets(num_arcs);
+    static_map<arc, double> lengths(num_arcs);
+    detail::for_each_generator_block(
+        team, num_blocks, [&](const std::size_t b) {
+            const auto [first, last] = block_vertices(b);
+            for(std::size_t u = first; u < last; ++u) {
+                std::size_t a = offsets[u];
+                for_each_neighbor(u, [&](const std::size_t v,
+                                         const double squared_distance) {
+                    sources[a] = static_cast<vertex>(u);
+                    targets[a] = static_cast<vertex>(v);
+                    lengths[static_cast<arc>(a)] = std::sqrt(squared_distance);
+                    ++a;
+                });
+            }
+        });
+    static_digraph graph(num_vertices, std::move(sources), std::move(targets));
+    return std::make_tuple(std::move(graph), std::move(points),
+                           std::move(lengths));
+}
+
+// Preferential attachment, the Barabási-Albert power law, in the linearized
+// chord diagram form of Bollobás and Riordan: vertex u brings
+// edges_per_vertex edges, each to a vertex chosen with probability
+// proportional to its degree so far, the new edge's own end included. Each
+// edge becomes an arc each way, so the digraph is symmetric; self-loops and
+// parallel edges may occur, as in the model.
+//
+// The edges are drawn in parallel as Sanders and Schulz do: the endpoints of
+// the edges form one sequence, the first end of edge i being at 2i and its
+// other end copying the endpoint at a uniform position before 2i + 1, which
+// draws the degree-proportional choice. That position is a hash of the seed
+// and of 2i + 1, not the next number of a stream, so any edge can be resolved
+// on its own by following the copies back to an even position: O(1) expected
+// steps. The arcs are then sorted by source in one serial counting pass.
+template <std::uniform_random_bit_generator Generator,
+          typename WeightDistribution>
+    requires std::invocable<WeightDistribution &, std::mt19937_64 &>
+[[nodiscard]] auto preferential_attachment_digraph(
+    const std::size_t num_vertices, const std::size_t edges_per_vertex,
+    Generator & gen, const WeightDistribution & weight_distribution,
+    const std::size_t num_threads = 1) {
+    using vertex = vertex_t<static_digraph>;
+    assert(num_threads > 0);
+    assert(num_vertices <= std::numeric_limits<vertex>::max());
+    const std::size_t num_edges = num_vertices * edges_per_vertex;
+    assert(2 * num_edges <= std::numeric_limits<arc_t<static_digraph>>::max());
+
+    const std::uint64_t seed = detail::generator_seeds(gen, 1)[0];
+    const auto endpoint = [&](std::uint64_t position) {
+        while(position % 2 == 1)
+            position = detail::mix_bits(seed ^ detail::mix_bits(position)) %
+                       position;
+        return static_cast<vertex>(position / 2 / edges_per_vertex);
+    };
+
+    std::vector<vertex> sources(2 * num_edges);
+    std::vector<vertex> targets(2 * num_edges);
+    const std::size_t num_blocks =
+        (num_edges + detail::generator_block_size - 1) /
+        detail::generator_block_size;
+    detail::thread_team team(num_threads);
+    detail::for_each_generator_block(
+        team, num_blocks, [&](const std::size_t b) {
+            const std::size_t last =
+                std::min(num_edges, (b + 1) * detail::generator_block_size);
+            for(std::size_t i = b * detail::generator_block_size; i < last;
+                ++i) {
+                const auto u = static_cast<vertex>(i / edges_per_vertex);
+                const vertex v = endpoint(2 * i + 1);
+                sources[2 * i] = u;
+                targets[2 * i] = v;
+                sources[2 * i + 1] = v;
+                targets[2 * i + 1] = u;
+            }
+        });
+    auto graph = detail::digraph_by_source(num_vertices, sources, targets);
+    auto weights =
+        detail::random_arc_map(team, graph, weight_distribution, gen);
+    return std::make_tuple(std::move(graph), std::move(weights));
+}
+
+}  // namespace melon
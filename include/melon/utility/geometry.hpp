@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cmath>
+#include <compare>
 #include <concepts>
+#include <limits>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -104,6 +107,41 @@ struct cartesian {
             return std::get<0>(l) / -std::get<1>(l);
         }
     }
+    // The sign of the cross product (q - p) x (r - p): greater when r lies to
+    // the left of the line from p through q, less to its right, equivalent
+    // on it.
+    [[nodiscard]] static constexpr std::weak_ordering orientation(
+        const cartesian_point auto & p, const cartesian_point auto & q,
+        const cartesian_point auto & r) {
+        const auto det =
+            (std::get<0>(q) - std::get<0>(p)) *
+                (std::get<1>(r) - std::get<1>(p)) -
+            (std::get<0>(r) - std::get<0>(p)) *
+                (std::get<1>(q) - std::get<1>(p));
+        if(det < 0) return std::weak_ordering::less;
+        if(det > 0) return std::weak_ordering::greater;
+        return std::weak_ordering::equivalent;
+    }
+    // How two non-vertical lines compare at abscissa x: the order of the
+    // ordinates at which they cross the vertical line through it. Both sides
+    // are multiplied by the two y coefficients rather than divided, so an
+    // integral coordinate type stays exact.
+    [[nodiscard]] static constexpr std::weak_ordering compare_y_at(
+        const cartesian_line auto & l1, const cartesian_line auto & l2,
+        const auto & x) {
+        const auto lhs =
+            (std::get<2>(l1) - std::get<0>(l1) * x) * std::get<1>(l2);
+        const auto rhs =
+            (std::get<2>(l2) - std::get<0>(l2) * x) * std::get<1>(l1);
+        const bool flipped = (std::get<1>(l1) < 0) != (std::get<1>(l2) < 0);
+        if(lhs < rhs)
+            return flipped ? std::weak_ordering::greater
+                           : std::weak_ordering::less;
+        if(rhs < lhs)
+            return flipped ? std::weak_ordering::less
+                           : std::weak_ordering::greater;
+        return std::weak_ordering::equivalent;
+    }
     [[nodiscard]] static constexpr bool point_on_line(
         const cartesian_point auto & p, const cartesian_line auto & l) {
         return std::get<0>(l) * std::get<0>(p) +
@@ -179,4 +217,106 @@ struct cartesian {
                    : aligned_segments_overlap(A, B);
     }
 };
+
+// cartesian with its two sign predicates filtered: orientation and
+// compare_y_at are first evaluated in double under an error bound, and only
+// a sign within the bound is recomputed with cartesian's exact arithmetic.
+// Every answer is the exact one; the filter only skips work, which on inputs
+// that are not near-degenerate is nearly all of it.
+// The bounds allow three roundings per input value -- numerator, denominator
+// and their quotient -- and hold while the doubles stay normal, as they do
+// for rationals of built-in integers and bounded_values. A value overflowing
+// double comes out non-finite, which the filters never decide.
+struct filtered_cartesian : cartesian {
+    // 16 units in the last place: the analyses below need 13.
+    static constexpr double error_bound =
+        8 * std::numeric_limits<double>::epsilon();
+
+    [[nodiscard]] static constexpr double approximate(const auto & v) {
+        if constexpr(requires {
+                         v.num();
+                         v.den();
+                     }) {
+            return approximate(v.num()) / approximate(v.den());
+        } else {
+            return static_cast<double>(v);
+        }
+    }
+
+    // A non-vertical line as y = intercept + slope * x. A vertical one comes
+    // out non-finite, so approximate_compare_y_at leaves it to the exact
+    // arithmetic.
+    struct approximate_line {
+        double slope;
+        double intercept;
+    };
+    [[nodiscard]] static constexpr approximate_line to_approximate_line(
+        const cartesian_line auto & l) {
+        const double b = approximate(std::get<1>(l));
+        return {-approximate(std::get<0>(l)) / b,
+                approximate(std::get<2>(l)) / b};
+    }
+
+    // compare_y_at on approximations, or unordered when the error bound
+    // cannot tell the sign -- which includes every tie.
+    [[nodiscard]] static constexpr std::partial_ordering
+    approximate_compare_y_at(const approximate_line & l1,
+                             const approximate_line & l2, const double x) {
+        const double m1x = l1.slope * x;
+        const double m2x = l2.slope * x;
+        const double d = (l1.intercept + m1x) - (l2.intercept + m2x);
+        const double bound =
+            error_bound * (std::abs(l1.intercept) + std::abs(m1x) +
+                           std::abs(l2.intercept) + std::abs(m2x));
+        // NaN fails both tests, and so does an infinite bound
+        if(d > bound) return std::partial_ordering::greater;
+        if(d < -bound) return std::partial_ordering::less;
+        return std::partial_ordering::unordered;
+    }
+    [[nodiscard]] static constexpr std::weak_ordering compare_y_at(
+        const cartesian_line auto & l1, const cartesian_line auto & l2,
+        const auto & x) {
+        const std::partial_ordering order = approximate_compare_y_at(
+            to_approximate_line(l1), to_approximate_line(l2), approximate(x));
+        if(order == std::partial_ordering::less)
+            return std::weak_ordering::less;
+        if(order == std::partial_ordering::greater)
+            return std::weak_ordering::greater;
+        return cartesian::compare_y_at(l1, l2, x);
+    }
+
+    // orientation on approximations, or unordered when the error bound cannot
+    // tell the sign. The bound scales with the coordinates' magnitudes, not
+    // their differences: a difference of rounded coordinates inherits the
+    // rounding of both.
+    [[nodiscard]] static constexpr std::partial_ordering
+    approximate_orientation(const cartesian_point auto & p,
+                            const cartesian_point auto & q,
+                            const cartesian_point auto & r) {
+        const double px = approximate(std::get<0>(p));
+        const double py = approximate(std::get<1>(p));
+        const double qx = approximate(std::get<0>(q));
+        const double qy = approximate(std::get<1>(q));
+        const double rx = approximate(std::get<0>(r));
+        const double ry = approximate(std::get<1>(r));
+        const double det = (qx - px) * (ry - py) - (rx - px) * (qy - py);
+        const double bound =
+            error_bound *
+            ((std::abs(qx) + std::abs(px)) * (std::abs(ry) + std::abs(py)) +
+             (std::abs(rx) + std::abs(px)) * (std::abs(qy) + std::abs(py)));
+        if(det > bound) return std::partial_ordering::greater;
+        if(det < -bound) return std::partial_ordering::less;
+        return std::partial_ordering::unordered;
+    }
+    [[nodiscard]] static constexpr std::weak_ordering orientation(
+        const cartesian_point auto & p, const cartesian_point auto & q,
+        const cartesian_point auto & r) {
+        const std::partial_ordering order = approximate_orientation(p, q, r);
+        if(order == std::partial_ordering::less)
+            return std::weak_ordering::less;
+        if(order == std::partial_ordering::greater)
+            return std::weak_ordering::greater;
+        return cartesian::orientation(p, q, r);
+    }
+};
 }  // namespace melon
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <random>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "melon/detail/stdlib_check.hpp"
+
+namespace melon {
+
+// Samples from a discrete distribution whose weights change. The items are
+// the leaves of a complete binary tree, each node holding the sum of the
+// weights below it, laid out as a binary heap. A draw descends from the root
+// to the leaf of a uniform point of [0, total weight), and set_weight()
+// rewrites a leaf and the sums on its path: both are O(log n), where
+// alias_method_sampler draws in O(1) but is rebuilt in O(n) on any change.
+// Each sum is recomputed from its two children rather than shifted by the
+// difference, so rounding errors do not build up over the updates.
+//
+// Same requirements on the items and the weights as alias_method_sampler:
+// the weights are non-negative and need not sum to one, and at each draw they
+// must not all be zero.
+template <std::ranges::random_access_range ItemRange, std::floating_point Prob>
+class sum_tree_sampler {
+public:
+    using result_type = std::ranges::range_reference_t<ItemRange>;
+
+private:
+    ItemRange _items;
+    std::size_t _num_leaves;
+    // node 1 is the root, 2k and 2k + 1 the children of node k, and
+    // _num_leaves + i the leaf of item i
+    std::vector<Prob> _sums;
+
+public:
+    template <std::ranges::random_access_range R,
+              std::invocable<std::ranges::range_value_t<R>> P>
+    sum_tree_sampler(R && items, P && prob_map)
+        : _items(std::views::all(std::forward<R>(items)))
+        , _num_leaves(std::bit_ceil(
+              std::max(std::size_t{1}, std::ranges::size(_items))))
+        , _sums(2 * _num_leaves, Prob{0}) {
+        assert(!std::ranges::empty(_items));
+        for(auto && [i, item] : std::views::enumerate(_items)) {
+            const Prob w = prob_map(item);
+            assert(w >= Prob{0});
+            _sums[_num_leaves + static_cast<std::size_t>(i)] = w;
+        }
+        for(std::size_t k = _num_leaves; --k > 0;)
+            _sums[k] = _sums[2 * k] + _sums[2 * k + 1];
+    }
+
+    sum_tree_sampler(const sum_tree_sampler &) = default;
+    sum_tree_sampler(sum_tree_sampler &&) = default;
+
+    sum_tree_sampler & operator=(const sum_tree_sampler &) = default;
+    sum_tree_sampler & operator=(sum_tree_sampler &&) = default;
+
+    // i is the position of the item in the range
+    [[nodiscard]] Prob weight(const std::size_t i) const {
+        assert(i < std::ranges::size(_items));
+        return _sums[_num_leaves + i];
+    }
+    [[nodiscard]] Prob total_weight() const noexcept { return _sums[1]; }
+
+    sum_tree_sampler & set_weight(const std::size_t i, const Prob w) {
+        assert(i < std::ranges::size(_items));
+        assert(w >= Prob{0});
+        std::size_t k = _num_leaves + i;
+        _sums[k] = w;
+        for(k /= 2; k > 0; k /= 2) _sums[k] = _sums[2 * k] + _sums[2 * k + 1];
+        return *this;
+    }
+
+    template <std::uniform_random_bit_generator Generator>
+    [[nodiscard]] decltype(auto) operator()(Generator & gen) const {
+        assert(_sums[1] > Prob{0});
+        std::uniform_real_distribution<Prob> distribution(Prob{0}, _sums[1]);
+        Prob x = distribution(gen);
+        std::size_t k = 1;
+        while(k < _num_leaves) {
+            k *= 2;
+            // Never into a subtree of zero weight, which a point rounded up
+            // to the end of its node would otherwise reach; so every node
+            // descended into has a positive sum.
+            if(!(x < _sums[k]) && _sums[k + 1] > Prob{0}) {
+                x -= _sums[k];
+                ++k;
+            }
+        }
+        return _items[static_cast<std::ranges::range_difference_t<ItemRange>>(
+            k - _num_leaves)];
+    }
+};
+
+template <typename Range, typename ProbMap>
+sum_tree_sampler(Range &&, ProbMap &&)
+    -> sum_tree_sampler<
+        std::views::all_t<Range>,
+        std::invoke_result_t<ProbMap, std::ranges::range_value_t<Range>>>;
+
+}  // namespace melon
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+
+#include "melon/container/static_map.hpp"
+#include "melon/detail/borrowed_graph.hpp"
+#include "melon/mapping.hpp"
+#include "melon/views/graph_view.hpp"
+
+namespace melon {
+namespace views {
+
+// The 4- or 8-connected grid of width x height pixels, with an arc each way
+// between neighbours, generated on demand: nothing is stored but the two
+// dimensions, so a 4K image costs no graph memory at all.
+//
+// Vertex `y * width + x` is the pixel (x, y). Arc `v * Connectivity + d`
+// leaves v in direction d, and the arc back is `w * Connectivity + (d ^ 1)`:
+// directions come in opposite pairs. Ids of arcs that would leave the grid are
+// skipped, not renumbered, so arc maps have num_vertices() * Connectivity
+// entries while num_arcs() counts the arcs that exist.
+template <std::size_t Connectivity = 4, std::integral V = unsigned int,
+          std::integral A = unsigned int>
+    requires(Connectivity == 4 || Connectivity == 8)
+class grid_digraph : public graph_view_base {
+private:
+    using vertex = V;
+    using arc = A;
+    using direction_mask = unsigned int;
+
+    // Right, left, down, up, then the diagonals, each next to its opposite.
+    static constexpr std::array<int, 8> _dx = {1, -1, 0, 0, 1, -1, 1, -1};
+    static constexpr std::array<int, 8> _dy = {0, 0, 1, -1, 1, -1, -1, 1};
+
+    std::size_t _width;
+    std::size_t _height;
+
+public:
+    constexpr grid_digraph() : grid_digraph(0, 0) {}
+    constexpr grid_digraph(const std::size_t width, const std::size_t height)
+        : _width(width), _height(height) {
+        assert(width * height * Connectivity <=
+               static_cast<std::size_t>(std::numeric_limits<arc>::max()));
+    }
+
+    constexpr grid_digraph(const grid_digraph &) = default;
+    constexpr grid_digraph(grid_digraph &&) = default;
+
+    constexpr grid_digraph & operator=(const grid_digraph &) = default;
+    constexpr grid_digraph & operator=(grid_digraph &&) = default;
+
+    [[nodiscard]] constexpr std::size_t width() const noexcept {
+        return _width;
+    }
+    [[nodiscard]] constexpr std::size_t height() const noexcept {
+        return _height;
+    }
+
+    [[nodiscard]] constexpr vertex vertex_at(
+        const std::size_t x, const std::size_t y) const noexcept {
+        assert(x < _width && y < _height);
+        return static_cast<vertex>(y * _width + x);
+    }
+    [[nodiscard]] constexpr std::size_t column(const vertex v) const noexcept {
+        assert(is_valid_vertex(v));
+        return static_cast<std::size_t>(v) % _width;
+    }
+    [[nodiscard]] constexpr std::size_t row(const vertex v) const noexcept {
+        assert(is_valid_vertex(v));
+        return static_cast<std::size_t>(v) / _width;
+    }
+
+    [[nodiscard]] constexpr std::size_t num_vertices() const noexcept {
+        return _width * _height;
+    }
+    [[nodiscard]] constexpr std::size_t num_arcs() const noexcept {
+        if(_width == 0 || _height == 0) return 0;
+        const std::size_t straight =
+            2 * ((_width - 1) * _height + _width * (_height - 1));
+        if constexpr(Connectivity == 4) return straight;
+        return straight + 4 * (_width - 1) * (_height - 1);
+    }
+
+    [[nodiscard]] constexpr bool is_valid_vertex(
+        const vertex u) const noexcept {
+        return static_cast<std::size_t>(u) < num_vertices();
+    }
+    [[nodiscard]] constexpr bool is_valid_arc(const arc a) const noexcept {
+        const std::size_t i = static_cast<std::size_t>(a);
+        if(i >= num_vertices() * Connectivity) return false;
+        return (directions_from(static_cast<vertex>(i / Connectivity)) >>
+                (i % Connectivity)) &
+               1u;
+    }
+
+private:
+    // Bit d is set when direction d stays on the grid. Computed once per
+    // incidence range, so iterating one costs a shift per arc, not a
+    // division.
+    [[nodiscard]] constexpr direction_mask directions_from(
+        const vertex u) const noexcept {
+        const std::size_t x = static_cast<std::size_t>(u) % _width;
+        const std::size_t y = static_cast<std::size_t>(u) / _width;
+        direction_mask mask = 0;
+        for(std::size_t d = 0; d < Connectivity; ++d) {
+            const bool x_ok = _dx[d] == 0 || (_dx[d] > 0 ? x + 1 < _width : x > 0);
+            const bool y_ok =
+                _dy[d] == 0 || (_dy[d] > 0 ? y + 1 < _height : y > 0);
+            if(x_ok && y_ok) mask |= direction_mask{1} << d;
+        }
+        return mask;
+    }
+
+    [[nodiscard]] constexpr std::ptrdiff_t offset(
+        const std::size_t d) const noexcept {
+        return _dx[d] + _dy[d] * static_cast<std::ptrdiff_t>(_width);
+    }
+
+public:
+    [[nodiscard]] constexpr auto vertices() const noexcept {
+        return std::views::iota(vertex(0), static_cast<vertex>(num_vertices()));
+    }
+    // Filtered, so not a sized_range: num_arcs() above is the O(1) count.
+    [[nodiscard]] constexpr auto arcs() const noexcept {
+        return std::views::join(std::views::transform(
+            vertices(), [g = *this](const vertex u) { return g.out_arcs(u); }));
+    }
+
+    [[nodiscard]] constexpr vertex arc_source(const arc a) const noexcept {
+        assert(is_valid_arc(a));
+        return static_cast<vertex>(a / Connectivity);
+    }
+    [[nodiscard]] constexpr vertex arc_target(const arc a) const noexcept {
+        assert(is_valid_arc(a));
+        return static_cast<vertex>(
+            static_cast<std::ptrdiff_t>(a / Connectivity) +
+            offset(static_cast<std::size_t>(a % Connectivity)));
+    }
+
+    [[nodiscard]] constexpr auto out_arcs(const vertex u) const noexcept {
+        assert(is_valid_vertex(u));
+        const arc first = static_cast<arc>(u * Connectivity);
+        return std::views::filter(
+            std::views::iota(first, static_cast<arc>(first + Connectivity)),
+            [first, mask = directions_from(u)](const arc a) {
+                return (mask >> (a - first)) & 1u;
+            });
+    }
+    // The arc into u from direction d is the one its neighbour sends back,
+    // in direction d ^ 1.
+    [[nodiscard]] constexpr auto in_arcs(const vertex u) const noexcept {
+        assert(is_valid_vertex(u));
+        const direction_mask mask = directions_from(u);
+        const std::ptrdiff_t width = static_cast<std::ptrdiff_t>(_width);
+        return std::views::transform(
+            std::views::filter(std::views::iota(std::size_t{0}, Connectivity),
+                               [mask](const std::size_t d) {
+                                   return (mask >> d) & 1u;
+                               }),
+            [u, width](const std::size_t d) {
+                const auto w = static_cast<std::ptrdiff_t>(u) + _dx[d] +
+                               _dy[d] * width;
+                return static_cast<arc>(
+                    static_cast<std::size_t>(w) * Connectivity + (d ^ 1));
+            });
+    }
+
+    // None of the four below are noexcept: they allocate.
+    template <typename T>
+    [[nodiscard]] constexpr auto create_vertex_map() const {
+        return static_map<vertex, T>(num_vertices());
+    }
+    template <typename T>
+    [[nodiscard]] constexpr auto create_vertex_map(
+        const T & default_value) const {
+        return static_map<vertex, T>(num_vertices(), default_value);
+    }
+
+    template <typename T>
+    [[nodiscard]] constexpr auto create_arc_map() const {
+        return static_map<arc, T>(num_vertices() * Connectivity);
+    }
+    template <typename T>
+    [[nodiscard]] constexpr auto create_arc_map(const T & default_value) const {
+        return static_map<arc, T>(num_vertices() * Connectivity, default_value);
+    }
+};
+
+}  // namespace views
+
+// Purely generated: every range above captures the two dimensions by value,
+// never the view object.
+template <std::size_t C, std::integral V, std::integral A>
+inline constexpr bool enable_borrowed_graph<views::grid_digraph<C, V, A>> =
+    true;
+
+}  // namespace melon
@@ -0,0 +1,136 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "melon/numeric/adaptive_integer.hpp"
+#include "melon/numeric/bounded_value.hpp"
+#include "melon/numeric/rational.hpp"
+
+#include "random_ranges_helper.hpp"
+
+using namespace melon;
+using namespace melon::numeric;
+
+static constexpr std::int64_t int64_max =
+    std::numeric_limits<std::int64_t>::max();
+static constexpr std::int64_t int64_min =
+    std::numeric_limits<std::int64_t>::min();
+
+////////////////////////////////////////////////////////////////////////////////
+// values stay inline while they fit, and are exact past it
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(adaptive_integer, small_values_behave_as_built_in_integers) {
+    adaptive_integer a = 7;
+    adaptive_integer b = -3;
+    ASSERT_EQ(a + b, 4);
+    ASSERT_EQ(a - b, 10);
+    ASSERT_EQ(a * b, -21);
+    ASSERT_EQ(-a, -7);
+    ASSERT_LT(b, a);
+    ASSERT_GT(a, 0);
+    ASSERT_EQ(adaptive_integer(), 0);
+    ASSERT_FALSE((a * b).is_big());
+    ASSERT_EQ((a * b).to_string(), "-21");
+    ASSERT_EQ(static_cast<double>(a * b), -21.0);
+}
+
+GTEST_TEST(adaptive_integer, exact_past_the_inline_range) {
+    const adaptive_integer max = int64_max;
+    const adaptive_integer min = int64_min;
+    ASSERT_EQ((max * max * max).to_string(),
+              "784637716923335095224261902710254454442933591094742482943");
+    ASSERT_EQ((min * min * min).to_string(),
+              "-784637716923335095479473677900958302012794430558004314112");
+    ASSERT_EQ((min * max + 1).to_string(),
+              "-85070591730234615856620279821087277055");
+    ASSERT_EQ((max * max * max * max - min * min).to_string(),
+              "7237005577332262210834635695349653859336832288649875123707246049"
+              "404844507137");
+    ASSERT_TRUE((max * max * max).is_big());
+    ASSERT_LT(min * min * min, max * max * max);
+    ASSERT_LT(min * min * min, 0);
+    ASSERT_GT(max * max * max, max * max);
+    ASSERT_EQ(static_cast<double>(max * max * max),
+              static_cast<double>(int64_max) * static_cast<double>(int64_max) *
+                  static_cast<double>(int64_max));
+    ASSERT_EQ(adaptive_integer(std::numeric_limits<std::uint64_t>::max())
+                  .to_string(),
+              "18446744073709551615");
+}
+
+GTEST_TEST(adaptive_integer, results_that_fit_come_back_inline) {
+    const adaptive_integer max = int64_max;
+    const adaptive_integer cube = max * max * max;
+    const adaptive_integer difference = cube - (cube - 5);
+    ASSERT_EQ(difference, 5);
+    ASSERT_FALSE(difference.is_big());
+    ASSERT_FALSE((cube - cube).is_big());
+    ASSERT_EQ(cube - cube, 0);
+}
+
+GTEST_TEST(adaptive_integer, bounded_value_operands) {
+    adaptive_integer a = 6;
+    ASSERT_EQ((a * const_value<int, 1>{}), 6);
+    ASSERT_EQ((a + bounded_value<int8_t>(-7)), -1);
+    ASSERT_EQ(a * 2, 12);
+    a *= 3;
+    a += 1;
+    a -= 4;
+    ASSERT_EQ(a, 15);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// random values built past 128 bits obey the ring identities and the order
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(adaptive_integer, random_identities) {
+    std::uniform_int_distribution<std::int64_t> dist(int64_min, int64_max);
+    auto random_value = [&](int factors) {
+        adaptive_integer v = dist(test_rng());
+        while(--factors > 0) v *= dist(test_rng());
+        return v;
+    };
+    for(int i = 0; i < 1000; ++i) {
+        const adaptive_integer a = random_value(1 + i % 4);
+        const adaptive_integer b = random_value(1 + (i / 4) % 4);
+        const adaptive_integer c = random_value(1 + (i / 16) % 4);
+        ASSERT_EQ(a * b, b * a);
+        ASSERT_EQ((a * b) * c, a * (b * c));
+        ASSERT_EQ(a * (b + c), a * b + a * c);
+        ASSERT_EQ((a + b) * (a - b), a * a - b * b);
+        ASSERT_EQ(a - b + b, a);
+        ASSERT_EQ(-(-a), a);
+        ASSERT_EQ(a <=> b, (a - b) <=> 0);
+        ASSERT_EQ(a <=> b, 0 <=> (b - a));
+        ASSERT_EQ(a == b, (a - b) == 0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// adaptive_rational compares exactly where 64-bit cross-multiplication wraps
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(adaptive_integer, adaptive_rational_comparisons) {
+    const std::int64_t p = std::int64_t{1} << 62;
+    const adaptive_rational r1(p + 1, p);
+    const adaptive_rational r2(p + 2, p + 1);
+    ASSERT_GT(r1, r2);
+    ASSERT_LT(r2, r1);
+    ASSERT_NE(r1, r2);
+    ASSERT_EQ(r1, adaptive_rational(adaptive_integer(p + 1) * 3,
+                                    adaptive_integer(p) * 3));
+    // past 128 bits in the cross products
+    const adaptive_rational r3 = r1 * r1 * r1;
+    const adaptive_rational r4 = r2 * r2 * r2;
+    ASSERT_GT(r3, r4);
+    ASSERT_GT(r3 - r4, 0);
+    ASSERT_EQ(r3 / r1, r1 * r1);
+    ASSERT_GT(r1, 1);
+    ASSERT_LT(-r1, 0);
+}
@@ -1,8 +1,13 @@
 #undef NDEBUG
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
 #include <random>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "melon/utility/alias_method_sampler.hpp"
@@ -135,3 +140,112 @@ GTEST_TEST(alias_method_sampler, default_traits_spelling_runs) {
     for(int i = 0; i < 100; ++i)
         ASSERT_NE(std::ranges::find(vec, sampler(rng)), vec.end());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// sample_n draws each item with its probability. A generator stepping
+// through [0, 2^64) on a regular grid makes the draws a deterministic
+// quadrature: every bucket is drawn as many times, up to one, and its coin
+// runs over a regular grid of [0, 1).
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+struct grid_generator {
+    using result_type = std::uint64_t;
+    std::uint64_t step;
+    std::uint64_t next = 0;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type{0}; }
+    result_type operator()() { return std::exchange(next, next + step); }
+};
+
+// The total variation distance between the frequencies of the items in
+// `draws` and the weights.
+double total_variation(const std::vector<std::size_t> & draws,
+                       const std::vector<double> & weights) {
+    std::vector<double> frequencies(weights.size(), 0.0);
+    for(const std::size_t i : draws)
+        frequencies[i] += 1.0 / static_cast<double>(draws.size());
+    const double weights_sum = std::reduce(weights.begin(), weights.end());
+    double distance = 0.0;
+    for(std::size_t i = 0; i < weights.size(); ++i)
+        distance += std::abs(frequencies[i] - weights[i] / weights_sum);
+    return distance / 2;
+}
+}  // namespace
+
+GTEST_TEST(alias_method_sampler, sample_n_follows_the_distribution) {
+    std::vector<double> weights = {4.0, 2.0, 0.0, 1.0, 0.5, 0.5, 0.0};
+    auto ids = std::views::iota(0ul, weights.size());
+    auto prob_map = [&](std::size_t i) { return weights[i]; };
+    const std::size_t num_draws = std::size_t{1} << 20;
+
+    alias_method_sampler serial(ids, prob_map);
+    alias_method_sampler swept(ids, prob_map, 3);
+    for(const auto * sampler : {&serial, &swept}) {
+        grid_generator gen{std::uint64_t{1} << 44};
+        std::vector<std::size_t> draws(num_draws);
+        sampler->sample_n(gen, draws);
+        ASSERT_LT(total_variation(draws, weights), 1e-4);
+        // zero weights are never drawn, though the grid holds coins of 0
+        ASSERT_EQ(std::ranges::count(draws, 2ul), 0);
+        ASSERT_EQ(std::ranges::count(draws, 6ul), 0);
+    }
+
+    // and from a 32-bit generator, two outputs a word
+    std::mt19937 rng(180);
+    std::vector<std::size_t> draws(100000);
+    serial.sample_n(rng, draws);
+    ASSERT_LT(total_variation(draws, weights), 0.01);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// the parallel construction builds a table that does not depend on the
+// number of threads, over many chunks of items and of merge steps
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(alias_method_sampler, parallel_construction) {
+    const std::size_t n = 100000;
+    std::vector<double> weights(n);
+    std::exponential_distribution<double> dist(1.0);
+    for(auto & w : weights) w = test_rng()() % 8 == 0 ? 0.0 : dist(test_rng());
+    auto ids = std::views::iota(0ul, n);
+    auto prob_map = [&](std::size_t i) { return weights[i]; };
+
+    std::vector<std::vector<std::size_t>> draws;
+    for(const std::size_t num_threads : {1u, 2u, 5u}) {
+        alias_method_sampler sampler(ids, prob_map, num_threads);
+        grid_generator gen{std::uint64_t{1} << 40};
+        draws.emplace_back(std::size_t{1} << 24);
+        sampler.sample_n(gen, draws.back());
+        for(const std::size_t i : draws.back()) ASSERT_GT(weights[i], 0.0);
+    }
+    ASSERT_EQ(draws[1], draws[0]);
+    ASSERT_EQ(draws[2], draws[0]);
+    // Each bucket is drawn as many times up to one, and its coin splits its
+    // draws between its item and its alias up to one. An item is the alias of
+    // about its scaled weight buckets, so its count is off by a few draws
+    // per unit of scaled weight, where a bucket of the wrong alias or
+    // probability would move tens of draws.
+    std::vector<double> counts(n, 0.0);
+    for(const std::size_t i : draws[0]) counts[i] += 1.0;
+    const double weights_sum = std::reduce(weights.begin(), weights.end());
+    const double draws_per_bucket = static_cast<double>(1 << 24) / n;
+    for(std::size_t i = 0; i < n; ++i) {
+        const double scaled_weight = weights[i] / weights_sum * n;
+        ASSERT_NEAR(counts[i], scaled_weight * draws_per_bucket,
+                    3.0 + 2.0 * scaled_weight);
+    }
+}
+
+// The thread count takes the CTAD guide of the items, not of the traits.
+static_assert(
+    std::same_as<decltype(alias_method_sampler(
+                     std::declval<std::vector<int> &>(),
+                     std::declval<double (&)(const int &)>(), std::size_t{2})),
+                 traits_default::written_out>);
+static_assert(std::same_as<decltype(alias_method_sampler(
+                               alias_method_sampler_default_traits{},
+                               std::declval<std::vector<int> &>(),
+                               std::declval<double (&)(const int &)>(),
+                               std::size_t{2})),
+                           traits_default::written_out>);
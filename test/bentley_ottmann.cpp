@@ -9,6 +9,7 @@
 #include "type_name.hpp"
 
 #include "melon/algorithm/bentley_ottmann.hpp"
+#include "melon/numeric/adaptive_integer.hpp"
 #include "melon/numeric/bounded_value.hpp"
 
 using namespace melon;
@@ -525,6 +526,147 @@ GTEST_TEST(bentley_ottmann, fuzzy_sparse_bounded_value_test) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// pooled trees: the same points and segments as the oracle, across reset()
+// and a move assignment over a sweep holding pools of its own
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(bentley_ottmann, pooled_traits) {
+    using coord = integer<int64_t>;
+    using point = std::tuple<coord, coord>;
+    using segment = std::tuple<point, point>;
+    using intersection = decltype(cartesian::segments_intersection(
+        std::declval<segment>(), std::declval<segment>()))::value_type;
+    using traits = bentley_ottmann_pooled_traits<segment>;
+
+    const auto sweep = [](auto & alg) {
+        std::vector<std::pair<intersection, std::vector<std::size_t>>> found;
+        for(; !alg.finished(); alg.advance()) {
+            const auto & [i, intersecting_segments] = alg.current();
+            found.emplace_back(
+                i, std::vector<std::size_t>(intersecting_segments.begin(),
+                                            intersecting_segments.end()));
+        }
+        return found;
+    };
+
+    for(std::size_t test_i = 0; test_i < 50; ++test_i) {
+        const std::size_t num_segments = 100;
+        auto segments =
+            generate_random_vector_segments<coord, -96, 95, 32>(num_segments);
+        auto naive_intersections_vec = naive_intersections(segments);
+
+        bentley_ottmann alg(traits{}, std::views::iota(0uz, num_segments),
+                            segments);
+        static_assert(std::is_same_v<
+                      decltype(alg),
+                      bentley_ottmann<traits, std::ranges::iota_view<
+                                                  std::size_t, std::size_t>,
+                                      mapping_ref_view<std::vector<segment>>>>);
+        auto intersections_vec = sweep(alg);
+        ASSERT_TRUE(EQ_MULTISETS(std::views::keys(intersections_vec),
+                                 std::views::keys(naive_intersections_vec)));
+        for(std::size_t i = 0; i < intersections_vec.size(); ++i) {
+            ASSERT_TRUE(EQ_MULTISETS(intersections_vec[i].second,
+                                     naive_intersections_vec[i].second));
+        }
+
+        ASSERT_EQ(sweep(alg.reset()), intersections_vec);
+
+        bentley_ottmann other(traits{}, std::views::iota(0uz, num_segments / 2),
+                              segments);
+        other.advance();
+        alg.reset().advance();
+        other = std::move(alg);
+        intersections_vec.erase(intersections_vec.begin());
+        ASSERT_EQ(sweep(other), intersections_vec);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// filtered coordinates: the same points and segments as the oracle, on dense
+// boxes full of degeneracies and on sparse short segments
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename Segment>
+struct filtered_traits : bentley_ottmann_default_traits<Segment> {
+    using coordinate_system = filtered_cartesian;
+};
+
+template <typename Segment>
+void expect_filtered_sweep_matches_oracle(
+    const std::vector<Segment> & segments) {
+    using intersection = decltype(cartesian::segments_intersection(
+        std::declval<Segment>(), std::declval<Segment>()))::value_type;
+    std::vector<std::pair<intersection, std::vector<std::size_t>>>
+        intersections_vec;
+    for(const auto & [i, intersecting_segments] :
+        bentley_ottmann(filtered_traits<Segment>{},
+                        std::views::iota(0uz, segments.size()), segments)) {
+        intersections_vec.emplace_back(
+            i, std::vector<std::size_t>(intersecting_segments.begin(),
+                                        intersecting_segments.end()));
+    }
+    auto naive_intersections_vec = naive_intersections(segments);
+    ASSERT_TRUE(EQ_MULTISETS(std::views::keys(intersections_vec),
+                             std::views::keys(naive_intersections_vec)));
+    for(std::size_t i = 0; i < intersections_vec.size(); ++i) {
+        ASSERT_TRUE(EQ_MULTISETS(intersections_vec[i].second,
+                                 naive_intersections_vec[i].second));
+    }
+}
+
+GTEST_TEST(bentley_ottmann, filtered_coordinate_system) {
+    for(std::size_t test_i = 0; test_i < 50; ++test_i) {
+        expect_filtered_sweep_matches_oracle(
+            generate_random_box_segments<integer<int64_t>, -128, 127>(100));
+        expect_filtered_sweep_matches_oracle(
+            generate_random_vector_segments<integer<int64_t>, -96, 95, 32>(
+                100));
+        expect_filtered_sweep_matches_oracle(
+            generate_random_box_segments<integer<bounded_value<int8_t>>, -128,
+                                         127>(100));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// wide coordinates: with 30-bit coordinates the comparisons of intersection
+// points need some 190 bits, past what integer<int64_t> components hold
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(bentley_ottmann, fuzzy_wide_adaptive_integer_test) {
+    using coord = integer<adaptive_integer>;
+    using point = std::tuple<coord, coord>;
+    using segment = std::tuple<point, point>;
+    using intersection = decltype(cartesian::segments_intersection(
+        std::declval<segment>(), std::declval<segment>()))::value_type;
+
+    for(std::size_t test_i = 0; test_i < 10; ++test_i) {
+        const std::size_t num_segments = 50;
+        auto segments =
+            generate_random_box_segments<coord, -(1 << 30), (1 << 30) - 1>(
+                num_segments);
+
+        std::vector<std::pair<intersection, std::vector<std::size_t>>>
+            intersections_vec;
+        for(const auto & [i, intersecting_segments] :
+            bentley_ottmann(std::views::iota(0uz, num_segments), segments)) {
+            intersections_vec.emplace_back(std::make_pair(
+                i, std::vector<std::size_t>(intersecting_segments.begin(),
+                                            intersecting_segments.end())));
+        }
+        auto naive_intersections_vec = naive_intersections(segments);
+        ASSERT_TRUE(EQ_MULTISETS(std::views::keys(intersections_vec),
+                                 std::views::keys(naive_intersections_vec)));
+        for(std::size_t i = 0; i < intersections_vec.size(); ++i) {
+            ASSERT_TRUE(EQ_MULTISETS(intersections_vec[i].second,
+                                     naive_intersections_vec[i].second));
+        }
+
+        expect_filtered_sweep_matches_oracle(segments);
+    }
+}
+
 // GTEST_TEST(bentley_ottmann, fuzzy_test_mppp) {
 //     using coord = rational<mppp::integer<1>>;
 //     using point = std::tuple<coord, coord>;
@@ -0,0 +1,94 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "melon/algorithm/biobjective_dijkstra.hpp"
+#include "melon/algorithm/bidirectional_biobjective_dijkstra.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+////////////////////////////////////////////////////////////////////////////////
+// the s-t front of the one-to-all search's literature instance
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(bidirectional_biobjective_dijkstra, test) {
+    static_digraph_builder<static_digraph, int, int> builder(10);
+
+    // https://hal.science/hal-03162962/document
+    builder.add_arc(0u, 2u, 1, 4);
+    builder.add_arc(0u, 4u, 2, 2);
+    builder.add_arc(0u, 5u, 4, 1);
+    builder.add_arc(0u, 7u, 1, 11);
+    builder.add_arc(1u, 9u, 1, 0);
+    builder.add_arc(2u, 3u, 5, 0);
+    builder.add_arc(2u, 6u, 3, 0);
+    builder.add_arc(2u, 9u, 1, 4);
+    builder.add_arc(3u, 9u, 1, 2);
+    builder.add_arc(4u, 9u, 2, 3);
+    builder.add_arc(5u, 7u, 5, 9);
+    builder.add_arc(5u, 9u, 4, 1);
+    builder.add_arc(6u, 1u, 2, 0);
+    builder.add_arc(7u, 8u, 1, 1);
+    builder.add_arc(8u, 9u, 0, 0);
+
+    auto [graph, blue_length_map, red_length_map] = builder.build();
+
+    bidirectional_biobjective_dijkstra alg(graph, blue_length_map,
+                                           red_length_map, 0u, 9u);
+    static_assert(std::movable<decltype(alg)> && !std::copyable<decltype(alg)>);
+    alg.run();
+    ASSERT_TRUE(EQ_RANGES(alg.pareto_front(),
+                          {std::make_pair(2, 8), std::make_pair(4, 5),
+                           std::make_pair(7, 4), std::make_pair(8, 2)}));
+
+    alg.reset(0u, 8u).run();
+    ASSERT_TRUE(EQ_RANGES(alg.pareto_front(),
+                          {std::make_pair(2, 12), std::make_pair(10, 11)}));
+    alg.reset(9u, 0u).run();
+    ASSERT_TRUE(alg.pareto_front().empty());
+    alg.reset(3u, 3u).run();
+    ASSERT_TRUE(EQ_RANGES(alg.pareto_front(), {std::make_pair(0, 0)}));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random digraphs, the front biobjective_dijkstra leaves at the target
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(bidirectional_biobjective_dijkstra, matches_biobjective_dijkstra) {
+    for(std::size_t it = 0; it < 40; ++it) {
+        const std::size_t n = 2 + test_rng()() % (it < 20 ? 10 : 300);
+        const int max_length = it % 4 == 0 ? 3 : 100;
+        static_digraph_builder<static_digraph, int, int> builder(n);
+        for(std::size_t k = 0; k < 3 * n; ++k)
+            builder.add_arc(
+                static_cast<unsigned>(test_rng()() % n),
+                static_cast<unsigned>(test_rng()() % n),
+                static_cast<int>(test_rng()() % static_cast<unsigned>(max_length)),
+                static_cast<int>(test_rng()() % static_cast<unsigned>(max_length)));
+        auto [graph, blue_length_map, red_length_map] = builder.build();
+
+        const auto s = static_cast<unsigned>(test_rng()() % n);
+        biobjective_dijkstra one_to_all(graph, blue_length_map, red_length_map);
+        one_to_all.add_source(s).run();
+
+        bidirectional_biobjective_dijkstra alg(graph, blue_length_map,
+                                               red_length_map, s, s);
+        for(std::size_t k = 0; k < 5; ++k) {
+            const auto t = static_cast<unsigned>(test_rng()() % n);
+            alg.reset(s, t).run();
+            std::vector<std::pair<int, int>> expected(
+                one_to_all.pareto_front(t).begin(),
+                one_to_all.pareto_front(t).end());
+            ASSERT_TRUE(EQ_RANGES(alg.pareto_front(), expected))
+                << s << " -> " << t;
+        }
+    }
+}
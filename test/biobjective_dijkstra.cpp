@@ -8,6 +8,7 @@
 #include "melon/container/static_digraph.hpp"
 #include "melon/utility/static_digraph_builder.hpp"
 
+#include "random_ranges_helper.hpp"
 #include "ranges_test_helper.hpp"
 
 using namespace melon;
@@ -122,3 +123,64 @@ GTEST_TEST(biobjective_dijkstra, test) {
                               std::make_pair(7, 4), std::make_pair(8, 2)}));
     alg.reset();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// flat_pareto_fronts: the same fronts, held in sorted vectors
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+template <typename Graph>
+struct flat_fronts_traits
+    : biobjective_dijkstra_default_traits<Graph, int, int> {
+    static constexpr bool flat_pareto_fronts = true;
+};
+}  // namespace
+
+GTEST_TEST(biobjective_dijkstra, flat_pareto_fronts) {
+    static_digraph_builder<static_digraph, int, int> builder(9);
+    auto [graph, blue_length_map, red_length_map] = builder.build();
+    using traits = flat_fronts_traits<graph_ref_view<static_digraph>>;
+
+    biobjective_dijkstra alg(traits{}, graph, blue_length_map, red_length_map);
+    alg.add_source(0u, 1, 1);
+    ASSERT_TRUE(alg.is_dominated(0u, std::make_pair(2, 1)));
+    ASSERT_FALSE(alg.is_dominated(0u, std::make_pair(0, 2)));
+
+    alg.add_source(1u, 5, 0).add_source(1u, 1, 6).add_source(1u, 3, 3);
+    ASSERT_TRUE(EQ_RANGES(alg.pareto_front(1u),
+                          {std::make_pair(1, 6), std::make_pair(3, 3),
+                           std::make_pair(5, 0)}));
+    // dominates the two last, and leaves the first
+    alg.add_source(1u, 2, 0);
+    ASSERT_TRUE(EQ_RANGES(alg.pareto_front(1u),
+                          {std::make_pair(1, 6), std::make_pair(2, 0)}));
+    // same blue cost, better red
+    alg.add_source(1u, 1, 4);
+    ASSERT_TRUE(EQ_RANGES(alg.pareto_front(1u),
+                          {std::make_pair(1, 4), std::make_pair(2, 0)}));
+}
+
+GTEST_TEST(biobjective_dijkstra, flat_pareto_fronts_match_sets) {
+    for(std::size_t it = 0; it < 20; ++it) {
+        const std::size_t n = 2 + test_rng()() % 200;
+        static_digraph_builder<static_digraph, int, int> builder(n);
+        for(std::size_t k = 0; k < 4 * n; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % 100),
+                            static_cast<int>(test_rng()() % 100));
+        auto [graph, blue_length_map, red_length_map] = builder.build();
+        using traits = flat_fronts_traits<graph_ref_view<static_digraph>>;
+
+        biobjective_dijkstra sets(graph, blue_length_map, red_length_map);
+        biobjective_dijkstra flat(traits{}, graph, blue_length_map,
+                                  red_length_map);
+        sets.add_source(0u).run();
+        for(std::size_t run = 0; run < 2; ++run) {
+            flat.reset().add_source(0u).run();
+            for(auto && v : vertices(graph))
+                ASSERT_TRUE(EQ_RANGES(flat.pareto_front(v), sets.pareto_front(v)))
+                    << "vertex " << v;
+        }
+    }
+}
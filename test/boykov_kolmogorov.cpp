@@ -0,0 +1,260 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "melon/algorithm/boykov_kolmogorov.hpp"
+#include "melon/algorithm/dinitz.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+#include "melon/views/grid_digraph.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+
+constexpr int INF = 1 << 20;
+
+// The maximum flow of the same network with explicit terminals, by dinitz:
+// vertex n is the source, n + 1 the sink.
+template <typename Graph, typename Capacities>
+int reference_flow_value(const Graph & graph, const Capacities & capacity,
+                         const std::vector<int> & source_capacity,
+                         const std::vector<int> & sink_capacity) {
+    const std::size_t n = source_capacity.size();
+    static_digraph_builder<static_digraph, int> builder(n + 2);
+    for(auto && [a, endpoints] : arcs_entries(graph))
+        builder.add_arc(static_cast<unsigned>(endpoints.first),
+                        static_cast<unsigned>(endpoints.second), capacity[a]);
+    for(std::size_t v = 0; v < n; ++v) {
+        builder.add_arc(static_cast<unsigned>(n), static_cast<unsigned>(v),
+                        source_capacity[v]);
+        builder.add_arc(static_cast<unsigned>(v), static_cast<unsigned>(n + 1),
+                        sink_capacity[v]);
+    }
+    auto [reference_graph, reference_capacity] = builder.build();
+    dinitz alg(reference_graph, reference_capacity,
+               static_cast<unsigned>(n), static_cast<unsigned>(n + 1));
+    return alg.run().flow_value();
+}
+
+// What the reported cut costs: its arcs, plus the terminal arcs it severs.
+template <typename Alg, typename Graph, typename Capacities>
+int cut_capacity(const Alg & alg, const Graph & graph,
+                 const Capacities & capacity,
+                 const std::vector<int> & source_capacity,
+                 const std::vector<int> & sink_capacity) {
+    int sum = 0;
+    for(auto && a : alg.minimum_cut()) sum += capacity[a];
+    for(auto && v : vertices(graph))
+        sum += alg.on_source_side(v) ? sink_capacity[v] : source_capacity[v];
+    return sum;
+}
+
+template <typename Alg, typename Graph, typename Capacities>
+void assert_is_flow(const Alg & alg, const Graph & graph,
+                    const Capacities & capacity) {
+    for(auto && a : arcs(graph)) {
+        ASSERT_GE(alg.flow(a), 0) << "arc " << a;
+        ASSERT_LE(alg.flow(a), capacity[a]) << "arc " << a;
+        ASSERT_EQ(alg.flows_map()[a], alg.flow(a));
+    }
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// with an unbounded terminal capacity on two vertices, it is an s-t maximum
+// flow
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(boykov_kolmogorov, test) {
+    static_digraph_builder<static_digraph, int, char> builder(6);
+
+    // example from https://www.geeksforgeeks.org/max-flow-problem-introduction/
+    builder.add_arc(0, 1, 16, false);
+    builder.add_arc(0, 2, 13, false);
+    builder.add_arc(1, 2, 10, false);
+    builder.add_arc(1, 3, 12, true);  //
+    builder.add_arc(2, 1, 4, false);
+    builder.add_arc(2, 4, 14, false);
+    builder.add_arc(3, 2, 9, false);
+    builder.add_arc(3, 5, 20, false);
+    builder.add_arc(4, 3, 7, true);  //
+    builder.add_arc(4, 5, 4, true);  //
+
+    auto [graph, capacity, part_of_minimum_cut] = builder.build();
+
+    boykov_kolmogorov alg(graph, capacity);
+    alg.set_source_capacity(0u, INF).set_sink_capacity(5u, INF);
+    ASSERT_EQ(alg.run().flow_value(), 23);
+    ASSERT_TRUE(EQ_MULTISETS(
+        alg.minimum_cut(), std::views::filter(arcs(graph), [&](const auto & a) {
+            return part_of_minimum_cut[a];
+        })));
+    assert_is_flow(alg, graph, capacity);
+    for(auto && u : vertices(graph)) {
+        if(u == 0u || u == 5u) continue;
+        int in_flow = 0, out_flow = 0;
+        for(auto && a : in_arcs(graph, u)) in_flow += alg.flow(a);
+        for(auto && a : out_arcs(graph, u)) out_flow += alg.flow(a);
+        ASSERT_EQ(in_flow, out_flow);
+    }
+    ASSERT_TRUE(alg.on_source_side(0u));
+    ASSERT_FALSE(alg.on_source_side(5u));
+
+    // run() is idempotent, and reset() keeps the terminal capacities
+    ASSERT_EQ(alg.run().flow_value(), 23);
+    alg.reset();
+    ASSERT_EQ(alg.flow_value(), 0);
+    for(auto && a : arcs(graph)) ASSERT_EQ(alg.flow(a), 0);
+    ASSERT_EQ(alg.source_capacity(0u), INF);
+    ASSERT_EQ(alg.run().flow_value(), 23);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// terminal capacities on one vertex are pushed straight through it
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(boykov_kolmogorov, no_arcs) {
+    static_digraph_builder<static_digraph, int> builder(3);
+    auto [graph, capacity] = builder.build();
+
+    const std::vector<int> source_capacity = {5, 0, 4};
+    const std::vector<int> sink_capacity = {3, 7, 9};
+    boykov_kolmogorov alg(graph, capacity, source_capacity, sink_capacity);
+    ASSERT_EQ(alg.run().flow_value(), 7);
+    ASSERT_TRUE(EMPTY(alg.minimum_cut()));
+    ASSERT_TRUE(alg.on_source_side(0u));
+    ASSERT_FALSE(alg.on_source_side(1u));
+    ASSERT_FALSE(alg.on_source_side(2u));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random networks, the flow value is dinitz's and the cut matches it
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(boykov_kolmogorov, matches_dinitz_on_random_instances) {
+    for(std::size_t it = 0; it < 200; ++it) {
+        const std::size_t n = 1 + test_rng()() % 12;
+        const std::size_t m = test_rng()() % (3 * n + 1);
+        static_digraph_builder<static_digraph, int> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % 20));
+        auto [graph, capacity] = builder.build();
+        const auto source_capacity = random_vector<int>(n, 0, 15);
+        const auto sink_capacity = random_vector<int>(n, 0, 15);
+
+        boykov_kolmogorov alg(graph, capacity, source_capacity, sink_capacity);
+        const int expected = reference_flow_value(graph, capacity,
+                                                  source_capacity, sink_capacity);
+        ASSERT_EQ(alg.run().flow_value(), expected);
+        assert_is_flow(alg, graph, capacity);
+        ASSERT_EQ(cut_capacity(alg, graph, capacity, source_capacity,
+                               sink_capacity),
+                  expected);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// changing terminal capacities and running again, with the flow and trees of
+// the previous run reused, gives the maximum flow of the changed network
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(boykov_kolmogorov, resolves_after_terminal_capacity_changes) {
+    for(std::size_t it = 0; it < 100; ++it) {
+        const std::size_t n = 2 + test_rng()() % 14;
+        const std::size_t m = test_rng()() % (3 * n + 1);
+        static_digraph_builder<static_digraph, int> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % 20));
+        auto [graph, capacity] = builder.build();
+        auto source_capacity = random_vector<int>(n, 0, 15);
+        auto sink_capacity = random_vector<int>(n, 0, 15);
+
+        boykov_kolmogorov alg(graph, capacity, source_capacity, sink_capacity);
+        alg.run();
+        for(std::size_t round = 0; round < 5; ++round) {
+            // raise and lower a few, including below the flow already sent
+            for(std::size_t k = 0; k < 1 + n / 3; ++k) {
+                const auto v = static_cast<unsigned>(test_rng()() % n);
+                if(test_rng()() % 2) {
+                    source_capacity[v] = static_cast<int>(test_rng()() % 16);
+                    alg.set_source_capacity(v, source_capacity[v]);
+                } else {
+                    sink_capacity[v] = static_cast<int>(test_rng()() % 16);
+                    alg.set_sink_capacity(v, sink_capacity[v]);
+                }
+            }
+            const int expected = reference_flow_value(
+                graph, capacity, source_capacity, sink_capacity);
+            ASSERT_EQ(alg.run().flow_value(), expected) << "round " << round;
+            assert_is_flow(alg, graph, capacity);
+            ASSERT_EQ(cut_capacity(alg, graph, capacity, source_capacity,
+                                   sink_capacity),
+                      expected);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on an implicit grid, 4- or 8-connected, without a static_digraph
+////////////////////////////////////////////////////////////////////////////////
+
+template <std::size_t Connectivity>
+void check_grid_segmentation() {
+    for(std::size_t it = 0; it < 10; ++it) {
+        const views::grid_digraph<Connectivity> grid(2 + test_rng()() % 30,
+                                                     2 + test_rng()() % 20);
+        auto capacity = grid.template create_arc_map<int>(0);
+        for(auto && a : arcs(grid))
+            capacity[a] = static_cast<int>(test_rng()() % 10);
+        const std::size_t n = num_vertices(grid);
+        // a bright left half and a dark right half, with noise
+        std::vector<int> source_capacity(n), sink_capacity(n);
+        for(auto && v : vertices(grid)) {
+            const bool left = grid.column(v) < grid.width() / 2;
+            source_capacity[v] =
+                static_cast<int>(test_rng()() % 10) + (left ? 10 : 0);
+            sink_capacity[v] =
+                static_cast<int>(test_rng()() % 10) + (left ? 0 : 10);
+        }
+
+        boykov_kolmogorov alg(grid, capacity, source_capacity, sink_capacity);
+        const int expected = reference_flow_value(grid, capacity,
+                                                  source_capacity, sink_capacity);
+        ASSERT_EQ(alg.run().flow_value(), expected);
+        assert_is_flow(alg, grid, capacity);
+        ASSERT_EQ(cut_capacity(alg, grid, capacity, source_capacity,
+                               sink_capacity),
+                  expected);
+
+        // brush a few pixels toward the other label, as interactive
+        // segmentation does between two solves
+        for(std::size_t k = 0; k < 10; ++k) {
+            const auto v = static_cast<unsigned>(test_rng()() % n);
+            std::swap(source_capacity[v], sink_capacity[v]);
+            alg.set_source_capacity(v, source_capacity[v])
+                .set_sink_capacity(v, sink_capacity[v]);
+        }
+        ASSERT_EQ(alg.run().flow_value(),
+                  reference_flow_value(grid, capacity, source_capacity,
+                                       sink_capacity));
+    }
+}
+
+GTEST_TEST(boykov_kolmogorov, grid_4_connected) {
+    check_grid_segmentation<4>();
+}
+
+GTEST_TEST(boykov_kolmogorov, grid_8_connected) {
+    check_grid_segmentation<8>();
+}
@@ -0,0 +1,102 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "melon/container/concurrent_disjoint_sets.hpp"
+#include "melon/container/disjoint_sets.hpp"
+#include "melon/container/static_map.hpp"
+
+#include "random_ranges_helper.hpp"
+
+using namespace melon;
+
+////////////////////////////////////////////////////////////////////////////////
+// singletons until united; roots are the smallest elements
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(concurrent_disjoint_sets, test) {
+    concurrent_disjoint_sets<> sets(5);
+    ASSERT_EQ(sets.size(), 5u);
+    ASSERT_FALSE(sets.empty());
+    for(unsigned i = 0; i < 5; ++i) ASSERT_EQ(sets.find(i), i);
+
+    ASSERT_TRUE(sets.unite(3, 1));
+    ASSERT_TRUE(sets.unite(4, 3));
+    ASSERT_FALSE(sets.unite(1, 4));
+    ASSERT_TRUE(sets.same_set(4, 1));
+    ASSERT_FALSE(sets.same_set(4, 2));
+    ASSERT_EQ(sets.find(4), 1u);
+    ASSERT_EQ(sets.find(0), 0u);
+
+    auto moved = std::move(sets);
+    ASSERT_EQ(moved.find(3), 1u);
+    moved.reset();
+    ASSERT_FALSE(moved.same_set(3, 1));
+
+    moved.resize(2);
+    ASSERT_EQ(moved.size(), 2u);
+    ASSERT_TRUE(moved.unite(0, 1));
+    ASSERT_TRUE(concurrent_disjoint_sets<std::size_t>().empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// many threads uniting random pairs at once: the partition of a serial
+// disjoint_sets, and exactly one successful unite per merge
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(concurrent_disjoint_sets, matches_disjoint_sets_under_contention) {
+    for(std::size_t it = 0; it < 20; ++it) {
+        const unsigned n = 1 + static_cast<unsigned>(test_rng()() % 5000);
+        const std::size_t m = test_rng()() % (2 * n);
+        std::vector<std::pair<unsigned, unsigned>> pairs(m);
+        for(auto && [x, y] : pairs) {
+            x = static_cast<unsigned>(test_rng()() % n);
+            y = static_cast<unsigned>(test_rng()() % n);
+        }
+
+        disjoint_sets<unsigned, static_map<unsigned, unsigned>> reference{
+            static_map<unsigned, unsigned>(n)};
+        for(unsigned i = 0; i < n; ++i) reference.push(i);
+        std::size_t merges = 0;
+        for(auto && [x, y] : pairs) {
+            const unsigned cx = reference.find(x);
+            const unsigned cy = reference.find(y);
+            if(cx == cy) continue;
+            reference.merge(cx, cy);
+            ++merges;
+        }
+
+        for(std::size_t num_threads : {1u, 4u, 8u}) {
+            concurrent_disjoint_sets<> sets(n);
+            std::atomic<std::size_t> successes = 0;
+            {
+                std::vector<std::jthread> threads;
+                for(std::size_t t = 0; t < num_threads; ++t) {
+                    threads.emplace_back([&, t] {
+                        // every thread unites every pair, in its own order
+                        for(std::size_t k = 0; k < m; ++k) {
+                            auto && [x, y] =
+                                pairs[(k + t * m / num_threads) % m];
+                            if(sets.unite(x, y)) ++successes;
+                            (void)sets.same_set(y, x);
+                        }
+                    });
+                }
+            }
+            ASSERT_EQ(successes, merges);
+            // each set rooted at its smallest element
+            std::vector<unsigned> smallest(n, n);
+            for(unsigned i = 0; i < n; ++i) {
+                auto & s = smallest[reference.find(i)];
+                if(s == n) s = i;
+                ASSERT_EQ(sets.find(i), s) << "element " << i;
+            }
+            for(auto && [x, y] : pairs) ASSERT_TRUE(sets.same_set(x, y));
+        }
+    }
+}
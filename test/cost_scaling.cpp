@@ -0,0 +1,126 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include "melon/algorithm/cost_scaling.hpp"
+#include "melon/algorithm/network_simplex.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+
+// Checks that the flow is feasible and that the potentials certify it
+// optimal by complementary slackness; returns its cost.
+template <typename Alg, typename Capacities, typename Costs>
+long long assert_is_optimal(const Alg & alg, const static_digraph & graph,
+                            const Capacities & capacity, const Costs & cost,
+                            const std::vector<int> & supply) {
+    std::vector<long> balance(num_vertices(graph), 0);
+    long long total = 0;
+    for(auto && [a, endpoints] : arcs_entries(graph)) {
+        EXPECT_GE(alg.flow(a), 0) << "arc " << a;
+        EXPECT_LE(alg.flow(a), capacity[a]) << "arc " << a;
+        EXPECT_EQ(alg.flows_map()[a], alg.flow(a));
+        balance[endpoints.first] += alg.flow(a);
+        balance[endpoints.second] -= alg.flow(a);
+        total += static_cast<long long>(alg.flow(a)) * cost[a];
+
+        const long reduced_cost = cost[a] + alg.potential(endpoints.first) -
+                                  alg.potential(endpoints.second);
+        if(alg.flow(a) < capacity[a]) {
+            EXPECT_GE(reduced_cost, 0) << "arc " << a;
+        }
+        if(alg.flow(a) > 0) {
+            EXPECT_LE(reduced_cost, 0) << "arc " << a;
+        }
+    }
+    for(auto && v : vertices(graph)) {
+        EXPECT_EQ(balance[v], supply[v]) << "conservation at " << v;
+        EXPECT_EQ(alg.potentials_map()[v], alg.potential(v));
+    }
+    EXPECT_EQ(alg.total_cost(), total);
+    return total;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// a transportation problem: two plants supplying two shops
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(cost_scaling, transportation) {
+    static_digraph_builder<static_digraph, int, int> builder(4);
+    builder.add_arc(0, 2, 10, 1)
+        .add_arc(0, 3, 10, 3)
+        .add_arc(1, 2, 10, 2)
+        .add_arc(1, 3, 10, 1);
+    auto [graph, capacity, cost] = builder.build();
+    const std::vector<int> supply = {5, 5, -4, -6};
+
+    cost_scaling alg(graph, capacity, cost, supply);
+    ASSERT_TRUE(alg.run().feasible());
+    ASSERT_EQ(assert_is_optimal(alg, graph, capacity, cost, supply), 12);
+
+    ASSERT_EQ(alg.run().total_cost(), 12);
+    alg.reset();
+    for(auto && a : arcs(graph)) ASSERT_EQ(alg.flow(a), 0);
+    EXPECT_DEATH((void)alg.feasible(), "");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// too little capacity, or supplies that do not balance
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(cost_scaling, infeasible) {
+    static_digraph_builder<static_digraph, int, int> builder(3);
+    builder.add_arc(0, 1, 3, 1).add_arc(1, 2, 3, -1);
+    auto [graph, capacity, cost] = builder.build();
+
+    ASSERT_FALSE(
+        cost_scaling(graph, capacity, cost, std::vector<int>{4, 0, -4})
+            .run()
+            .feasible());
+    ASSERT_FALSE(
+        cost_scaling(graph, capacity, cost, std::vector<int>{2, 0, -1})
+            .run()
+            .feasible());
+    ASSERT_TRUE(cost_scaling(graph, capacity, cost, std::vector<int>{3, 0, -3})
+                    .run()
+                    .feasible());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random networks with negative costs, the same optimum as the network
+// simplex, with potentials certifying it
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(cost_scaling, matches_network_simplex_on_random_instances) {
+    for(std::size_t it = 0; it < 300; ++it) {
+        const std::size_t n = 1 + test_rng()() % (it < 250 ? 15 : 200);
+        const std::size_t m = test_rng()() % (4 * n + 1);
+        static_digraph_builder<static_digraph, int, int> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % 10),
+                            static_cast<int>(test_rng()() % 1001) - 100);
+        auto [graph, capacity, cost] = builder.build();
+        auto supply = random_vector<int>(n, -8, 8);
+        supply[0] -= std::accumulate(supply.begin(), supply.end(), 0);
+
+        network_simplex reference(graph, capacity, cost, supply);
+        cost_scaling alg(graph, capacity, cost, supply);
+        ASSERT_EQ(alg.run().feasible(), reference.run().feasible());
+        if(!alg.feasible()) continue;
+        ASSERT_EQ(assert_is_optimal(alg, graph, capacity, cost, supply),
+                  reference.total_cost());
+    }
+}
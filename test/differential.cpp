@@ -10,6 +10,7 @@
 #include "melon/algorithm/dinitz.hpp"
 #include "melon/algorithm/edmonds_karp.hpp"
 #include "melon/algorithm/network_voronoi.hpp"
+#include "melon/algorithm/parallel_push_relabel.hpp"
 #include "melon/algorithm/strongly_connected_components.hpp"
 #include "melon/algorithm/topological_sort.hpp"
 #include "melon/container/static_digraph.hpp"
@@ -204,6 +205,39 @@ GTEST_TEST(differential, dinitz_and_edmonds_karp_agree_on_a_valid_flow) {
     }
 }
 
+GTEST_TEST(differential, parallel_push_relabel_matches_dinitz) {
+    for(std::size_t it = 0; it < NUM_INSTANCES; ++it) {
+        auto in = random_instance();
+        const auto s = static_cast<vertex>(test_rng()() % in.n);
+        const auto t = static_cast<vertex>(test_rng()() % in.n);
+        if(s == t) continue;
+
+        auto dz = dinitz(in.graph, in.length_map, s, t);
+        auto pr = parallel_push_relabel(in.graph, in.length_map, s, t);
+        dz.run();
+        pr.set_num_threads(1 + it % 4).run();
+
+        ASSERT_EQ(pr.flow_value(), dz.flow_value()) << s << " -> " << t;
+
+        std::vector<long> balance(in.n, 0);
+        for(auto && [a, endpoints] : arcs_entries(in.graph)) {
+            const int f = pr.flow(a);
+            ASSERT_GE(f, 0) << "arc " << a;
+            ASSERT_LE(f, in.length_map[a]) << "arc " << a;
+            balance[endpoints.first] -= f;
+            balance[endpoints.second] += f;
+        }
+        for(std::size_t v = 0; v < in.n; ++v) {
+            if(v == s || v == t) continue;
+            ASSERT_EQ(balance[v], 0) << "conservation at " << v;
+        }
+
+        int cut_capacity = 0;
+        for(auto && a : pr.minimum_cut()) cut_capacity += in.length_map[a];
+        ASSERT_EQ(cut_capacity, dz.flow_value()) << s << " -> " << t;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // traversals
 ////////////////////////////////////////////////////////////////////////////////
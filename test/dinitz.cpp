@@ -6,6 +6,7 @@
 #include "melon/utility/static_digraph_builder.hpp"
 #include "melon/views/subgraph.hpp"
 
+#include "random_ranges_helper.hpp"
 #include "ranges_test_helper.hpp"
 #include "unsized_digraph.hpp"
 
@@ -262,3 +263,119 @@ GTEST_TEST(dinitz, minimum_cut_requires_a_converged_run) {
     alg.set_target(1u);
     EXPECT_DEATH((void)alg.minimum_cut(), "");
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// the blocking flow is iterative: a path far longer than any call stack could
+// hold in frames is one augmentation, not a stack overflow
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(dinitz, long_path) {
+    constexpr unsigned n = 1'000'000;
+    static_digraph_builder<static_digraph, int> builder(n);
+    for(unsigned i = 0; i + 1 < n; ++i) builder.add_arc(i, i + 1, 5);
+    builder.add_arc(0, n - 1, 2);
+    auto [graph, capacity] = builder.build();
+
+    dinitz alg(graph, capacity, 0u, n - 1);
+    ASSERT_EQ(alg.run().flow_value(), 7);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// capacity scaling and the parallel BFS change how the flow is found, not its
+// value or the cut
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(dinitz, scaling_and_parallel_ranking_agree) {
+    for(std::size_t it = 0; it < 100; ++it) {
+        const std::size_t n = 2 + test_rng()() % 60;
+        const std::size_t m = test_rng()() % (4 * n);
+        static_digraph_builder<static_digraph, long> builder(n);
+        for(std::size_t k = 0; k < m; ++k) {
+            // capacities over several orders of magnitude, where scaling pays
+            const long capacity = static_cast<long>(test_rng()() % 1000) *
+                                  (1l << (test_rng()() % 20));
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n), capacity);
+        }
+        auto [graph, capacity] = builder.build();
+        const auto t = static_cast<unsigned>(n - 1);
+
+        dinitz plain(graph, capacity, 0u, t);
+        plain.run();
+        dinitz scaled(graph, capacity, 0u, t);
+        scaled.set_capacity_scaling(true).run();
+        dinitz parallel(graph, capacity, 0u, t);
+        parallel.set_num_threads(4).set_capacity_scaling(it % 2 == 0).run();
+
+        ASSERT_EQ(scaled.flow_value(), plain.flow_value());
+        ASSERT_EQ(parallel.flow_value(), plain.flow_value());
+        ASSERT_TRUE(EQ_MULTISETS(scaled.minimum_cut(), plain.minimum_cut()));
+        ASSERT_TRUE(EQ_MULTISETS(parallel.minimum_cut(), plain.minimum_cut()));
+        for(auto && a : arcs(graph)) {
+            ASSERT_GE(scaled.flow(a), 0);
+            ASSERT_LE(scaled.flow(a), capacity[a]);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// after capacity changes, update_capacity() keeps the flow valid and run()
+// resumes from it to the maximum a fresh run finds
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(dinitz, warm_start_after_capacity_changes) {
+    for(std::size_t it = 0; it < 200; ++it) {
+        const std::size_t n = 2 + test_rng()() % 30;
+        const std::size_t m = test_rng()() % (4 * n);
+        static_digraph_builder<static_digraph, int> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % 20));
+        auto [graph, capacity] = builder.build();
+        const auto t = static_cast<unsigned>(n - 1);
+
+        dinitz alg(graph, capacity, 0u, t);
+        alg.set_capacity_scaling(it % 2 == 0).run();
+        for(std::size_t round = 0; round < 5 && m > 0; ++round) {
+            // mostly cuts, several of them below the flow
+            for(std::size_t k = 0; k < 1 + m / 5; ++k) {
+                const auto a = static_cast<unsigned>(test_rng()() % m);
+                const int raise = static_cast<int>(test_rng()() % 10);
+                const int cut = static_cast<int>(
+                    test_rng()() % static_cast<unsigned>(capacity[a] + 1));
+                capacity[a] =
+                    test_rng()() % 4 == 0 ? capacity[a] + raise : cut;
+                alg.update_capacity(a);
+
+                std::vector<int> balance(n, 0);
+                for(auto && [b, endpoints] : arcs_entries(graph)) {
+                    ASSERT_GE(alg.flow(b), 0);
+                    ASSERT_LE(alg.flow(b), capacity[b]);
+                    balance[endpoints.first] -= alg.flow(b);
+                    balance[endpoints.second] += alg.flow(b);
+                }
+                for(auto && v : vertices(graph)) {
+                    if(v == 0u || v == t) continue;
+                    ASSERT_EQ(balance[v], 0) << "conservation at " << v;
+                }
+                ASSERT_EQ(balance[t], alg.flow_value());
+            }
+            dinitz reference(graph, capacity, 0u, t);
+            ASSERT_EQ(alg.run().flow_value(), reference.run().flow_value());
+            int cut_capacity = 0;
+            for(auto && a : alg.minimum_cut()) cut_capacity += capacity[a];
+            ASSERT_EQ(cut_capacity, reference.flow_value());
+        }
+    }
+}
+
+// scaling halves delta down to 1, which only means something for integers
+template <typename V>
+concept can_scale_capacities =
+    requires(dinitz<views::graph_all_t<static_digraph &>,
+                    maps::mapping_all_t<std::vector<V> &>> & alg) {
+        alg.set_capacity_scaling(true);
+    };
+static_assert(can_scale_capacities<int>);
+static_assert(!can_scale_capacities<double>);
@@ -1,6 +1,12 @@
 #undef NDEBUG
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
 #include "melon/utility/erdos_renyi.hpp"
 
 #include "ranges_test_helper.hpp"
@@ -74,3 +80,65 @@ concept erdos_renyi_accepts = requires(Gen & gen) {
 };
 static_assert(erdos_renyi_accepts<std::mt19937>);
 static_assert(!erdos_renyi_accepts<int>);
+
+////////////////////////////////////////////////////////////////////////////////
+// the graph does not depend on the number of threads, and its arcs come
+// sorted, without loops or repeats
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(erdos_renyi, parallel_generation_gives_the_same_graph) {
+    for(const double density : {1e-4, 0.01, 0.3}) {
+        std::mt19937 gen1(20260730);
+        auto a = erdos_renyi<static_digraph>(2000, density, gen1);
+        for(const std::size_t num_threads : {2u, 3u}) {
+            std::mt19937 gen2(20260730);
+            auto b = erdos_renyi<static_digraph>(2000, density, gen2,
+                                                 num_threads);
+            ASSERT_EQ(num_arcs(a), num_arcs(b));
+            ASSERT_TRUE(EQ_RANGES(arcs_entries(a), arcs_entries(b)));
+        }
+        std::vector<std::pair<unsigned, unsigned>> entries;
+        for(auto && [arc, st] : arcs_entries(a)) {
+            entries.emplace_back(st.first, st.second);
+            ASSERT_NE(st.first, st.second);
+        }
+        ASSERT_TRUE(std::ranges::is_sorted(entries));
+        ASSERT_EQ(std::ranges::adjacent_find(entries), entries.end());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// every ordered pair of distinct vertices is an arc with probability p: each
+// pair's frequency over many small graphs, and the arc count of a large
+// sparse one, stay within a few standard deviations
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(erdos_renyi, pairs_are_drawn_with_the_density) {
+    const std::size_t n = 12;
+    const double density = 0.3;
+    const int num_graphs = 4000;
+    std::vector<int> counts(n * n, 0);
+    std::mt19937 gen(180);
+    for(int k = 0; k < num_graphs; ++k) {
+        auto g = erdos_renyi<static_digraph>(n, density, gen);
+        for(auto && [arc, st] : arcs_entries(g))
+            ++counts[st.first * n + st.second];
+    }
+    const double sd = std::sqrt(num_graphs * density * (1 - density));
+    for(std::size_t u = 0; u < n; ++u) {
+        for(std::size_t v = 0; v < n; ++v) {
+            if(u == v) {
+                ASSERT_EQ(counts[u * n + v], 0);
+                continue;
+            }
+            ASSERT_NEAR(counts[u * n + v], num_graphs * density, 5 * sd);
+        }
+    }
+
+    const std::size_t big_n = 200000;
+    const double sparse_density = 5e-5;
+    auto g = erdos_renyi<static_digraph>(big_n, sparse_density, gen, 2);
+    const double pairs = static_cast<double>(big_n) * (big_n - 1);
+    ASSERT_NEAR(static_cast<double>(num_arcs(g)), pairs * sparse_density,
+                5 * std::sqrt(pairs * sparse_density));
+}
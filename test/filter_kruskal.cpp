@@ -0,0 +1,119 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "melon/algorithm/filter_kruskal.hpp"
+#include "melon/algorithm/kruskal.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+#include "melon/views/undirect.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+// Drains the generator into the list of edges it selects.
+auto mst_edges(auto & alg) {
+    std::vector<decltype(alg.current())> edges;
+    for(; !alg.finished(); alg.advance()) edges.push_back(alg.current());
+    return edges;
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// the edges of kruskal, in the same order, and reset() replays the run
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(filter_kruskal, test) {
+    static_digraph_builder<static_digraph, int> builder(6);
+    builder.add_arc(0, 1, 7)
+        .add_arc(0, 2, 9)
+        .add_arc(0, 5, 14)
+        .add_arc(1, 2, 10)
+        .add_arc(1, 3, 15)
+        .add_arc(2, 3, 12)
+        .add_arc(2, 5, 2)
+        .add_arc(3, 4, 6)
+        .add_arc(4, 5, 11);
+    auto [graph, cost_map] = builder.build();
+    auto ugraph = views::undirect(graph);
+
+    filter_kruskal alg(ugraph, cost_map);
+    ASSERT_TRUE(EQ_RANGES(mst_edges(alg), {6, 7, 0, 1, 8}));
+    ASSERT_EQ(std::addressof(alg.reset()), std::addressof(alg));
+    ASSERT_TRUE(EQ_RANGES(mst_edges(alg), {6, 7, 0, 1, 8}));
+    ASSERT_TRUE(EQ_RANGES(filter_kruskal(ugraph, cost_map), {6, 7, 0, 1, 8}));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// no edges, and a cheapest self-loop
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(filter_kruskal, degenerate_graphs) {
+    {
+        static_digraph_builder<static_digraph, int> builder(3);
+        auto [graph, cost_map] = builder.build();
+        filter_kruskal alg(views::undirect(graph), cost_map);
+        ASSERT_TRUE(alg.finished());
+        ASSERT_TRUE(alg.reset().finished());
+    }
+    {
+        static_digraph_builder<static_digraph, int> builder(3);
+        builder.add_arc(0, 0, 1).add_arc(0, 1, 2).add_arc(1, 2, 3);
+        auto [graph, cost_map] = builder.build();
+        filter_kruskal alg(views::undirect(graph), cost_map);
+        ASSERT_TRUE(EQ_RANGES(mst_edges(alg), {1, 2}));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random graphs, from sparse forests to dense graphs with many equal costs,
+// a spanning forest as light as kruskal's, in nondecreasing cost order and the
+// same for every thread count
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(filter_kruskal, matches_kruskal) {
+    for(std::size_t it = 0; it < 30; ++it) {
+        const std::size_t n = 1 + test_rng()() % (it < 20 ? 100 : 3000);
+        const std::size_t m = test_rng()() % (it < 25 ? 4 * n : 40 * n);
+        const unsigned max_cost = it % 3 == 0 ? 4 : 100000;
+        static_digraph_builder<static_digraph, int> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % max_cost));
+        auto [graph, cost_map] = builder.build();
+        auto ugraph = views::undirect(graph);
+
+        kruskal reference(ugraph, cost_map);
+        const auto reference_edges = mst_edges(reference);
+        long reference_cost = 0;
+        for(auto && e : reference_edges) reference_cost += cost_map[e];
+
+        std::vector<vertex_t<static_digraph>> first_run;
+        for(std::size_t num_threads : {1u, 4u}) {
+            filter_kruskal alg(ugraph, cost_map);
+            alg.set_num_threads(num_threads);
+            ASSERT_EQ(alg.num_threads(), num_threads);
+            const auto edges = mst_edges(alg);
+            ASSERT_EQ(edges.size(), reference_edges.size());
+            long cost = 0;
+            for(std::size_t i = 0; i < edges.size(); ++i) {
+                cost += cost_map[edges[i]];
+                if(i > 0) {
+                    ASSERT_LE(cost_map[edges[i - 1]], cost_map[edges[i]]);
+                }
+            }
+            ASSERT_EQ(cost, reference_cost);
+            if(num_threads == 1)
+                first_run = edges;
+            else
+                ASSERT_EQ(edges, first_run);
+        }
+    }
+}
@@ -0,0 +1,241 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "melon/utility/generators.hpp"
+#include "melon/utility/geometry.hpp"
+
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+// the arcs and their weights, in arc order
+template <typename Map>
+auto weighted_arcs(const static_digraph & graph, const Map & weights) {
+    std::vector<std::tuple<unsigned, unsigned, double>> result;
+    for(auto && a : graph.arcs())
+        result.emplace_back(graph.arc_source(a), graph.arc_target(a),
+                            static_cast<double>(weights[a]));
+    return result;
+}
+
+std::size_t max_out_degree(const static_digraph & graph) {
+    std::size_t max_degree = 0;
+    for(auto && u : graph.vertices())
+        max_degree = std::max(
+            max_degree, static_cast<std::size_t>(graph.out_arcs(u).size()));
+    return max_degree;
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// R-MAT: the sizes of Graph500, a skewed degree distribution, and the same
+// instance for a given seed whatever the thread count
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(generators, rmat_sizes_and_skew) {
+    std::mt19937 gen(20261019);
+    auto [graph, weights] =
+        rmat_digraph({.scale = 12, .edge_factor = 8}, gen,
+                     std::uniform_real_distribution<double>{0.0, 1.0});
+    ASSERT_EQ(graph.num_vertices(), 4096);
+    ASSERT_EQ(graph.num_arcs(), 8 * 4096);
+    for(auto && a : graph.arcs()) {
+        ASSERT_GE(weights[a], 0.0);
+        ASSERT_LT(weights[a], 1.0);
+    }
+    // the hubs of a power law, where G(n, p) of the same density would have
+    // a maximum out-degree of about 20
+    ASSERT_GT(max_out_degree(graph), 200);
+
+    // a = 1 puts every arc in the top-left quadrant at every level
+    auto [loops, loop_weights] = rmat_digraph(
+        {.scale = 5, .edge_factor = 2, .a = 1.0, .b = 0.0, .c = 0.0,
+         .scramble_ids = false},
+        gen, std::uniform_int_distribution<int>{1, 1});
+    ASSERT_EQ(loops.num_arcs(), 64);
+    for(auto && a : loops.arcs()) {
+        ASSERT_EQ(loops.arc_source(a), 0);
+        ASSERT_EQ(loops.arc_target(a), 0);
+        ASSERT_EQ(loop_weights[a], 1);
+    }
+}
+
+GTEST_TEST(generators, rmat_does_not_depend_on_the_thread_count) {
+    const auto draw = [](const std::size_t num_threads) {
+        std::mt19937 gen(7);
+        auto [graph, weights] = rmat_digraph(
+            {.scale = 14, .edge_factor = 16}, gen,
+            std::uniform_int_distribution<int>{1, 1000}, num_threads);
+        return weighted_arcs(graph, weights);
+    };
+    const auto serial = draw(1);
+    ASSERT_EQ(draw(2), serial);
+    ASSERT_EQ(draw(3), serial);
+
+    std::mt19937 other_gen(8);
+    auto [other, other_weights] =
+        rmat_digraph({.scale = 14, .edge_factor = 16}, other_gen,
+                     std::uniform_int_distribution<int>{1, 1000});
+    ASSERT_NE(weighted_arcs(other, other_weights), serial);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// grids: exactly the axis neighbors, in any dimension
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(generators, grid_arcs_are_the_axis_neighbors) {
+    std::mt19937 gen(1);
+    auto [grid, weights] = random_grid_digraph(
+        {3, 4}, gen, std::uniform_int_distribution<int>{5, 9});
+    ASSERT_EQ(grid.num_vertices(), 12);
+    // 2 * (rows * (columns - 1) + (rows - 1) * columns)
+    ASSERT_EQ(grid.num_arcs(), 2 * (3 * 3 + 2 * 4));
+    for(auto && a : grid.arcs()) {
+        const auto u = grid.arc_source(a);
+        const auto v = grid.arc_target(a);
+        const int du = static_cast<int>(u / 4) - static_cast<int>(v / 4);
+        const int dv = static_cast<int>(u % 4) - static_cast<int>(v % 4);
+        ASSERT_EQ(std::abs(du) + std::abs(dv), 1);
+        ASSERT_GE(weights[a], 5);
+        ASSERT_LE(weights[a], 9);
+    }
+    for(auto && u : grid.vertices())
+        ASSERT_TRUE(std::ranges::is_sorted(grid.out_neighbors(u)));
+
+    auto [cube, cube_weights] = random_grid_digraph(
+        {5, 6, 7}, gen, std::uniform_real_distribution<double>{0.0, 1.0});
+    ASSERT_EQ(cube.num_vertices(), 5 * 6 * 7);
+    ASSERT_EQ(cube.num_arcs(), 2 * (4 * 6 * 7 + 5 * 5 * 7 + 5 * 6 * 6));
+    // the center of the cube has its 6 neighbors, a corner 3
+    ASSERT_EQ(std::ranges::size(cube.out_arcs((2 * 6 + 3) * 7 + 3)), 6);
+    ASSERT_EQ(std::ranges::size(cube.out_arcs(0)), 3);
+}
+
+GTEST_TEST(generators, grid_does_not_depend_on_the_thread_count) {
+    const auto draw = [](const std::size_t num_threads) {
+        std::mt19937 gen(11);
+        auto [grid, weights] = random_grid_digraph(
+            {300, 400}, gen, std::uniform_int_distribution<int>{1, 100},
+            num_threads);
+        return weighted_arcs(grid, weights);
+    };
+    const auto serial = draw(1);
+    ASSERT_EQ(draw(2), serial);
+    ASSERT_EQ(draw(3), serial);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// random geometric graphs: the cell grid finds exactly the pairs within the
+// radius, which a quadratic scan of the points checks
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(generators, geometric_arcs_are_the_close_pairs) {
+    static_assert(cartesian_point<random_geometric_point>);
+    for(const double radius : {0.01, 0.07, 0.3, 2.0}) {
+        std::mt19937 gen(3);
+        auto [graph, points, lengths] =
+            random_geometric_digraph(600, radius, gen);
+        ASSERT_EQ(graph.num_vertices(), 600);
+
+        std::set<std::pair<unsigned, unsigned>> expected;
+        for(auto && u : graph.vertices()) {
+            const auto [x, y] = points[u];
+            ASSERT_GE(x, 0.0);
+            ASSERT_LT(x, 1.0);
+            ASSERT_GE(y, 0.0);
+            ASSERT_LT(y, 1.0);
+            for(auto && v : graph.vertices()) {
+                const double dx = points[v].first - x;
+                const double dy = points[v].second - y;
+                if(u != v && dx * dx + dy * dy <= radius * radius)
+                    expected.emplace(u, v);
+            }
+        }
+        std::set<std::pair<unsigned, unsigned>> arcs;
+        for(auto && a : graph.arcs()) {
+            const auto u = graph.arc_source(a);
+            const auto v = graph.arc_target(a);
+            arcs.emplace(u, v);
+            ASSERT_NEAR(lengths[a],
+                        std::hypot(points[v].first - points[u].first,
+                                   points[v].second - points[u].second),
+                        1e-12);
+        }
+        ASSERT_EQ(arcs.size(), graph.num_arcs());  // no parallel arcs
+        ASSERT_EQ(arcs, expected);
+        for(auto && u : graph.vertices())
+            ASSERT_TRUE(std::ranges::is_sorted(graph.out_neighbors(u)));
+    }
+}
+
+GTEST_TEST(generators, geometric_does_not_depend_on_the_thread_count) {
+    const auto draw = [](const std::size_t num_threads) {
+        std::mt19937 gen(5);
+        auto [graph, points, lengths] =
+            random_geometric_digraph(150000, 0.005, gen, num_threads);
+        std::vector<std::pair<double, double>> positions;
+        for(auto && u : graph.vertices()) positions.push_back(points[u]);
+        return std::pair{weighted_arcs(graph, lengths), positions};
+    };
+    const auto serial = draw(1);
+    ASSERT_GT(serial.first.size(), 0);
+    ASSERT_EQ(draw(2), serial);
+    ASSERT_EQ(draw(3), serial);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// preferential attachment: symmetric, edges_per_vertex edges brought by each
+// vertex, the early vertices turned into hubs
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(generators, preferential_attachment_shape) {
+    std::mt19937 gen(13);
+    auto [graph, weights] = preferential_attachment_digraph(
+        20000, 4, gen, std::uniform_int_distribution<int>{1, 10});
+    ASSERT_EQ(graph.num_vertices(), 20000);
+    ASSERT_EQ(graph.num_arcs(), 2 * 4 * 20000);
+
+    std::multiset<std::pair<unsigned, unsigned>> forward;
+    std::multiset<std::pair<unsigned, unsigned>> backward;
+    std::vector<std::size_t> edges_brought(graph.num_vertices(), 0);
+    for(auto && a : graph.arcs()) {
+        const auto u = graph.arc_source(a);
+        const auto v = graph.arc_target(a);
+        forward.emplace(u, v);
+        backward.emplace(v, u);
+        // each edge goes to a vertex no later than the one bringing it
+        if(u >= v) ++edges_brought[u];
+        ASSERT_GE(weights[a], 1);
+        ASSERT_LE(weights[a], 10);
+    }
+    ASSERT_EQ(forward, backward);
+    // a self-loop is two arcs u -> u, so counted twice above
+    for(auto && u : graph.vertices()) ASSERT_GE(edges_brought[u], 4);
+
+    // the degrees follow a power law of exponent 3: a maximum degree in the
+    // hundreds, where a uniform choice of the ends would give about 30
+    ASSERT_GT(max_out_degree(graph), 150);
+}
+
+GTEST_TEST(generators, preferential_attachment_ignores_the_thread_count) {
+    const auto draw = [](const std::size_t num_threads) {
+        std::mt19937 gen(17);
+        auto [graph, weights] = preferential_attachment_digraph(
+            50000, 3, gen, std::uniform_real_distribution<double>{0.0, 1.0},
+            num_threads);
+        return weighted_arcs(graph, weights);
+    };
+    const auto serial = draw(1);
+    ASSERT_EQ(draw(2), serial);
+    ASSERT_EQ(draw(3), serial);
+}
@@ -7,6 +7,8 @@
 
 #include "melon/utility/geometry.hpp"
 
+#include "random_ranges_helper.hpp"
+
 using namespace melon;
 using namespace melon::numeric;
 
@@ -128,6 +130,42 @@ GTEST_TEST(cartesian, line_slope) {
     ASSERT_EQ(infinite.den(), 0);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// orientation is the sign of a cross product; compare_y_at orders lines on a
+// vertical line, whatever the signs of their y coefficients
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(cartesian, orientation) {
+    ASSERT_EQ(cartesian::orientation(P(0, 0), P(4, 0), P(1, 1)),
+              std::weak_ordering::greater);
+    ASSERT_EQ(cartesian::orientation(P(0, 0), P(4, 0), P(1, -1)),
+              std::weak_ordering::less);
+    ASSERT_EQ(cartesian::orientation(P(0, 0), P(4, 2), P(-2, -1)),
+              std::weak_ordering::equivalent);
+    ASSERT_EQ(cartesian::orientation(
+                  P(0, 0), P(3, 1), std::make_tuple(1, R(1, 3) + R(1, 1000))),
+              std::weak_ordering::greater);
+}
+
+GTEST_TEST(cartesian, compare_y_at) {
+    const auto rising = cartesian::segment_to_line(S(0, 0, 2, 2));
+    // the same line from its other end: both y coefficients negate
+    const auto rising_reversed = cartesian::segment_to_line(S(2, 2, 0, 0));
+    const auto flat = cartesian::segment_to_line(S(0, 1, 2, 1));
+    ASSERT_EQ(cartesian::compare_y_at(rising, flat, coord(0)),
+              std::weak_ordering::less);
+    ASSERT_EQ(cartesian::compare_y_at(rising, flat, coord(1)),
+              std::weak_ordering::equivalent);
+    ASSERT_EQ(cartesian::compare_y_at(rising, flat, R(3, 2)),
+              std::weak_ordering::greater);
+    ASSERT_EQ(cartesian::compare_y_at(rising_reversed, flat, R(3, 2)),
+              std::weak_ordering::greater);
+    ASSERT_EQ(cartesian::compare_y_at(flat, rising_reversed, R(3, 2)),
+              std::weak_ordering::less);
+    ASSERT_EQ(cartesian::compare_y_at(rising, rising_reversed, R(7, 3)),
+              std::weak_ordering::equivalent);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // lines_intersection returns the exact crossing point, or nothing for
 // parallel lines
@@ -314,3 +352,130 @@ GTEST_TEST(cartesian, aligned_segments_overlap) {
         cartesian::aligned_segments_overlap(S(0, 0, 1, 1), S(2, 2, 3, 3))
             .has_value());
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// filtered_cartesian answers exactly as cartesian does: the double filter
+// decides the clear cases and leaves ties and near-ties to the exact path
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(filtered_cartesian, orientation_agrees_with_cartesian) {
+    // products up to 2^60: past what double holds exactly, short of int64
+    using ipoint = std::tuple<std::int64_t, std::int64_t>;
+    std::uniform_int_distribution<std::int64_t> c(-(1 << 29), 1 << 29),
+        v(-(1 << 28), 1 << 28), k(-1, 1);
+    // (x, y) with a * y - b * x = +-gcd(a, b), by the extended Euclid
+    // algorithm
+    const auto bezout = [](std::int64_t a, std::int64_t b) {
+        std::int64_t s0 = 1, s1 = 0, t0 = 0, t1 = 1;
+        while(b != 0) {
+            const std::int64_t quotient = a / b;
+            std::tie(a, b) = std::make_pair(b, a - quotient * b);
+            std::tie(s0, s1) = std::make_pair(s1, s0 - quotient * s1);
+            std::tie(t0, t1) = std::make_pair(t1, t0 - quotient * t1);
+        }
+        return std::make_pair(-t0, s0);
+    };
+    std::size_t decided = 0;
+    for(std::size_t i = 0; i < 10000; ++i) {
+        const ipoint p(c(test_rng()), c(test_rng()));
+        ipoint q(c(test_rng()), c(test_rng()));
+        ipoint r(c(test_rng()), c(test_rng()));
+        if(i % 2 == 0) {
+            // long and nearly collinear: a determinant of 0 or +-gcd(a, b)
+            // against products of up to 2^56
+            const std::int64_t a = v(test_rng()), b = v(test_rng());
+            q = ipoint(std::get<0>(p) + a, std::get<1>(p) + b);
+            const auto [x, y] = bezout(a, b);
+            const std::int64_t t = k(test_rng());
+            const std::int64_t s = (i % 6 == 0) ? 0 : (i % 4 == 0) ? 1 : -1;
+            r = ipoint(std::get<0>(p) + t * a + s * x,
+                       std::get<1>(p) + t * b + s * y);
+        }
+        const std::partial_ordering approximate =
+            filtered_cartesian::approximate_orientation(p, q, r);
+        const std::weak_ordering exact = cartesian::orientation(p, q, r);
+        if(approximate != std::partial_ordering::unordered) {
+            ++decided;
+            ASSERT_EQ(approximate, exact);
+        }
+        ASSERT_EQ(filtered_cartesian::orientation(p, q, r), exact);
+    }
+    ASSERT_GE(decided, 4000u);
+
+    // rationals, whose doubles are rounded however small they are
+    using qcoord = rational<std::int64_t, std::int64_t>;
+    using qpoint = std::tuple<qcoord, qcoord>;
+    std::uniform_int_distribution<std::int64_t> num(-63, 63), den(1, 7);
+    const auto random_point = [&] {
+        return qpoint(qcoord(num(test_rng()), den(test_rng())),
+                      qcoord(num(test_rng()), den(test_rng())));
+    };
+    std::uniform_int_distribution<std::int64_t> t(-2, 2);
+    for(std::size_t i = 0; i < 10000; ++i) {
+        const qpoint p = random_point(), q = random_point();
+        qpoint r = random_point();
+        if(i % 2 == 0) {
+            // collinear, though not in double
+            const qcoord factor(t(test_rng()), 1);
+            r = qpoint(
+                std::get<0>(p) + factor * (std::get<0>(q) - std::get<0>(p)),
+                std::get<1>(p) + factor * (std::get<1>(q) - std::get<1>(p)));
+        }
+        const std::partial_ordering approximate =
+            filtered_cartesian::approximate_orientation(p, q, r);
+        const std::weak_ordering exact = cartesian::orientation(p, q, r);
+        if(approximate != std::partial_ordering::unordered) {
+            ASSERT_EQ(approximate, exact);
+        }
+        ASSERT_EQ(filtered_cartesian::orientation(p, q, r), exact);
+    }
+}
+
+GTEST_TEST(filtered_cartesian, compare_y_at_agrees_with_cartesian) {
+    using icoord = std::int64_t;
+    using ipoint = std::tuple<icoord, icoord>;
+    using isegment = std::tuple<ipoint, ipoint>;
+    std::uniform_int_distribution<icoord> c(-4096, 4096), v(-64, 64);
+    std::size_t decided = 0;
+    for(std::size_t i = 0; i < 10000; ++i) {
+        // two segments through a common point, crossing at x0
+        const icoord x0 = c(test_rng()), y0 = c(test_rng());
+        const auto through = [&](const icoord dx, const icoord dy) {
+            return isegment(ipoint(x0 - dx, y0 - dy), ipoint(x0 + dx, y0 + dy));
+        };
+        icoord dx1 = v(test_rng()), dx2 = v(test_rng());
+        if(dx1 == 0) dx1 = 1;
+        if(dx2 == 0) dx2 = -1;
+        const auto l1 = cartesian::segment_to_line(through(dx1, v(test_rng())));
+        const auto l2 = cartesian::segment_to_line(through(dx2, v(test_rng())));
+        // at x0, a few 1024ths away from it, or anywhere
+        const icoord offset = (i % 3 == 0)   ? 0
+                              : (i % 3 == 1) ? c(test_rng()) % 8
+                                             : c(test_rng()) * 16;
+        const auto x = numeric::make_rational(x0 * 1024 + offset, icoord{1024});
+        const std::partial_ordering approximate =
+            filtered_cartesian::approximate_compare_y_at(
+                filtered_cartesian::to_approximate_line(l1),
+                filtered_cartesian::to_approximate_line(l2),
+                filtered_cartesian::approximate(x));
+        const std::weak_ordering exact = cartesian::compare_y_at(l1, l2, x);
+        if(approximate != std::partial_ordering::unordered) {
+            ++decided;
+            ASSERT_EQ(approximate, exact);
+        }
+        ASSERT_EQ(filtered_cartesian::compare_y_at(l1, l2, x), exact);
+    }
+    ASSERT_GE(decided, 3000u);
+}
+
+// A vertical line approximates to non-finite values, which are never decided.
+GTEST_TEST(filtered_cartesian, leaves_vertical_lines_to_the_exact_path) {
+    const auto vertical = filtered_cartesian::to_approximate_line(
+        cartesian::segment_to_line(S(3, 0, 3, 9)));
+    const auto flat = filtered_cartesian::to_approximate_line(
+        cartesian::segment_to_line(S(0, 1, 2, 1)));
+    for(const double x : {0.0, 3.0, -5.5})
+        ASSERT_EQ(
+            filtered_cartesian::approximate_compare_y_at(vertical, flat, x),
+            std::partial_ordering::unordered);
+}
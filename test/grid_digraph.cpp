@@ -0,0 +1,102 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+
+#include "melon/graph.hpp"
+#include "melon/views/grid_digraph.hpp"
+
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+using G4 = views::grid_digraph<4>;
+using G8 = views::grid_digraph<8>;
+
+////////////////////////////////////////////////////////////////////////////////
+// grid_digraph is a graph_view modelling every directed-graph concept
+////////////////////////////////////////////////////////////////////////////////
+
+static_assert(melon::graph<G4>);
+static_assert(melon::outward_incidence_graph<G4>);
+static_assert(melon::outward_adjacency_graph<G4>);
+static_assert(melon::inward_incidence_graph<G4>);
+static_assert(melon::inward_adjacency_graph<G4>);
+static_assert(melon::has_vertex_map<G4>);
+static_assert(melon::has_arc_map<G4>);
+static_assert(melon::graph_view<G4>);
+static_assert(melon::graph_view<G8>);
+static_assert(melon::borrowed_graph<G8>);
+
+////////////////////////////////////////////////////////////////////////////////
+// an empty grid has no vertices or arcs
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(grid_digraph, empty_constructor) {
+    G4 graph;
+    ASSERT_EQ(num_vertices(graph), 0);
+    ASSERT_EQ(num_arcs(graph), 0);
+    ASSERT_TRUE(EMPTY(vertices(graph)));
+    ASSERT_TRUE(EMPTY(arcs(graph)));
+    EXPECT_DEATH((void)out_arcs(graph, 0), "");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 3 x 2, 4-connected:   0 - 1 - 2
+//                       |   |   |
+//                       3 - 4 - 5
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(grid_digraph, grid_3x2_4_connected) {
+    G4 graph(3, 2);
+
+    ASSERT_EQ(num_vertices(graph), 6);
+    ASSERT_EQ(num_arcs(graph), 14);
+    ASSERT_EQ(std::ranges::distance(arcs(graph)), 14);
+    ASSERT_EQ(graph.vertex_at(1, 1), 4u);
+    ASSERT_EQ(graph.column(5u), 2u);
+    ASSERT_EQ(graph.row(5u), 1u);
+
+    ASSERT_TRUE(EQ_MULTISETS(out_neighbors(graph, 0), {1, 3}));
+    ASSERT_TRUE(EQ_MULTISETS(out_neighbors(graph, 1), {0, 2, 4}));
+    ASSERT_TRUE(EQ_MULTISETS(out_neighbors(graph, 4), {3, 5, 1}));
+    ASSERT_TRUE(EQ_MULTISETS(in_neighbors(graph, 1), {0, 2, 4}));
+    ASSERT_TRUE(EQ_MULTISETS(in_neighbors(graph, 5), {4, 2}));
+
+    for(auto && v : vertices(graph)) {
+        for(auto && a : out_arcs(graph, v)) {
+            ASSERT_TRUE(graph.is_valid_arc(a));
+            ASSERT_EQ(arc_source(graph, a), v);
+        }
+        for(auto && a : in_arcs(graph, v)) {
+            ASSERT_TRUE(graph.is_valid_arc(a));
+            ASSERT_EQ(arc_target(graph, a), v);
+        }
+    }
+    // a corner skips the ids of the arcs that would leave the grid
+    ASSERT_FALSE(graph.is_valid_arc(1u));
+    ASSERT_FALSE(graph.is_valid_arc(3u));
+    ASSERT_EQ(graph.create_arc_map<int>().size(), 24);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 8-connected, an interior pixel has 8 neighbours and a corner 3; the arc in
+// the opposite direction is the one back
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(grid_digraph, grid_3x3_8_connected) {
+    G8 graph(3, 3);
+
+    ASSERT_EQ(num_arcs(graph), 40);
+    ASSERT_EQ(std::ranges::distance(arcs(graph)), 40);
+    ASSERT_TRUE(EQ_MULTISETS(out_neighbors(graph, 4),
+                             {0, 1, 2, 3, 5, 6, 7, 8}));
+    ASSERT_TRUE(EQ_MULTISETS(out_neighbors(graph, 0), {1, 3, 4}));
+    ASSERT_TRUE(EQ_MULTISETS(in_neighbors(graph, 8), {5, 7, 4}));
+
+    for(auto && a : arcs(graph)) {
+        const auto back = arc_target(graph, a) * 8 + ((a % 8) ^ 1);
+        ASSERT_EQ(arc_source(graph, back), arc_target(graph, a));
+        ASSERT_EQ(arc_target(graph, back), arc_source(graph, a));
+    }
+}
@@ -1,8 +1,13 @@
 #undef NDEBUG
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 #include "melon/algorithm/knapsack_bnb.hpp"
 
+#include "random_ranges_helper.hpp"
 #include "ranges_test_helper.hpp"
 
 using namespace melon;
@@ -65,3 +70,43 @@ GTEST_TEST(knapsack_bnb, set_budget_rederives_the_item_filter) {
     ASSERT_EQ(alg.run().solution_value(), 18);
     ASSERT_TRUE(EQ_MULTISETS(alg.solution_items(), {0u, 1u, 2u}));
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// the parallel search answers the serial solution, items included: with few
+// distinct values and costs, many optimal solutions tie, and the threads must
+// still agree on the one the serial search finds first
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(knapsack_bnb, parallel_matches_serial) {
+    for(int it = 0; it < 200; ++it) {
+        const std::size_t n = test_rng()() % 40;
+        const unsigned max_value = it % 2 == 0 ? 8u : 1000u;
+        std::vector<std::size_t> items(n);
+        std::vector<int> values(n);
+        std::vector<int> costs(n);
+        int total_cost = 0;
+        for(std::size_t i = 0; i < n; ++i) {
+            items[i] = i;
+            values[i] = 1 + static_cast<int>(test_rng()() % max_value);
+            costs[i] = 1 + static_cast<int>(test_rng()() % max_value);
+            total_cost += costs[i];
+        }
+        const int budget = total_cost / 2;
+
+        auto serial = knapsack_bnb(items, values, costs, budget);
+        serial.run();
+        const std::vector<std::size_t> serial_items(
+            serial.solution_items().begin(), serial.solution_items().end());
+        for(const std::size_t num_threads : {2u, 3u, 4u}) {
+            auto parallel = knapsack_bnb(items, values, costs, budget);
+            parallel.set_num_threads(num_threads).run();
+            ASSERT_EQ(parallel.num_threads(), num_threads);
+            ASSERT_EQ(parallel.solution_value(), serial.solution_value());
+            ASSERT_EQ(parallel.solution_cost(), serial.solution_cost());
+            const std::vector<std::size_t> parallel_items(
+                parallel.solution_items().begin(),
+                parallel.solution_items().end());
+            ASSERT_EQ(parallel_items, serial_items);
+        }
+    }
+}
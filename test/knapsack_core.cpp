@@ -0,0 +1,122 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "melon/algorithm/knapsack_core.hpp"
+#include "melon/algorithm/knapsack_dp.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+////////////////////////////////////////////////////////////////////////////////
+// knapsack_core selects the value-maximal subset of items within the budget
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(knapsack_core, test) {
+    std::vector<std::size_t> items = {0u, 1u, 2u, 3u, 4u};
+    std::vector<int> values = {10, 7, 1, 3, 2};
+    std::vector<int> costs = {9, 12, 2, 7, 5};
+    int budget = 15;
+
+    auto alg = knapsack_core(items, values, costs, budget);
+    alg.run();
+
+    ASSERT_TRUE(EQ_MULTISETS(alg.solution_items(), {0u, 4u}));
+    ASSERT_EQ(alg.solution_value(), 12);
+    ASSERT_EQ(alg.solution_cost(), 14);
+}
+
+GTEST_TEST(knapsack_core, set_budget_rederives_the_item_filter) {
+    std::vector<std::size_t> items = {0u, 1u, 2u};
+    std::vector<int> values = {10, 7, 1};
+    std::vector<int> costs = {9, 12, 2};
+
+    auto alg =
+        knapsack_core(items, values, [&](auto i) { return costs[i]; }, 3);
+    ASSERT_EQ(alg.run().solution_value(), 1);
+
+    alg.set_budget(23);
+    ASSERT_EQ(alg.run().solution_value(), 18);
+    ASSERT_TRUE(EQ_MULTISETS(alg.solution_items(), {0u, 1u, 2u}));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// random instances agree with knapsack_dp, which is checked against
+// exhaustive enumeration: uncorrelated, strongly correlated (value = cost +
+// a constant) and subset-sum (value = cost) ones, and unsigned types, for
+// which the item removals wrap around
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename V, typename C>
+void expect_core_matches_dp(const std::vector<V> & values,
+                            const std::vector<C> & costs, const C budget) {
+    auto core = knapsack_core(std::views::iota(0uz, values.size()), values,
+                              costs, budget);
+    auto dp = knapsack_dp(std::views::iota(0uz, values.size()), values, costs,
+                          budget);
+    core.run();
+    dp.run();
+    ASSERT_EQ(core.solution_value(), dp.solution_value());
+    ASSERT_LE(core.solution_cost(), budget);
+    V value = 0;
+    C cost = 0;
+    for(auto && i : core.solution_items()) {
+        value += values[i];
+        cost += costs[i];
+    }
+    ASSERT_EQ(value, core.solution_value());
+    ASSERT_EQ(cost, core.solution_cost());
+}
+
+GTEST_TEST(knapsack_core, matches_knapsack_dp) {
+    std::uniform_int_distribution<int> dist(0, 100);
+    for(int test_i = 0; test_i < 300; ++test_i) {
+        const std::size_t n = 1 + static_cast<std::size_t>(test_i % 60);
+        std::vector<int> values(n), costs(n);
+        for(std::size_t i = 0; i < n; ++i) {
+            costs[i] = dist(test_rng());
+            switch(test_i % 3) {
+                case 0: values[i] = dist(test_rng()); break;
+                case 1: values[i] = costs[i] + 10; break;
+                default: values[i] = costs[i]; break;
+            }
+        }
+        const int total = std::accumulate(costs.begin(), costs.end(), 0);
+        expect_core_matches_dp(values, costs, total * (1 + test_i % 4) / 5);
+    }
+}
+
+GTEST_TEST(knapsack_core, unsigned_types) {
+    std::uniform_int_distribution<unsigned> dist(1, 50);
+    for(int test_i = 0; test_i < 100; ++test_i) {
+        const std::size_t n = 1 + static_cast<std::size_t>(test_i % 40);
+        std::vector<std::uint16_t> values(n);
+        std::vector<std::uint32_t> costs(n);
+        for(std::size_t i = 0; i < n; ++i) {
+            costs[i] = dist(test_rng());
+            values[i] = static_cast<std::uint16_t>(costs[i] + 5);
+        }
+        const std::uint32_t total =
+            std::accumulate(costs.begin(), costs.end(), 0u);
+        expect_core_matches_dp(values, costs, total / 2);
+    }
+}
+
+GTEST_TEST(knapsack_core, large_strongly_correlated_instance) {
+    std::uniform_int_distribution<std::int64_t> dist(1, 500);
+    const std::size_t n = 1000;
+    std::vector<std::int64_t> values(n), costs(n);
+    for(std::size_t i = 0; i < n; ++i) {
+        costs[i] = dist(test_rng());
+        values[i] = costs[i] + 50;
+    }
+    const std::int64_t total =
+        std::accumulate(costs.begin(), costs.end(), std::int64_t{0});
+    expect_core_matches_dp(values, costs, total / 2);
+}
@@ -0,0 +1,86 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "melon/algorithm/knapsack_dp.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+////////////////////////////////////////////////////////////////////////////////
+// knapsack_dp selects the value-maximal subset of items within the budget
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(knapsack_dp, test) {
+    std::vector<std::size_t> items = {0u, 1u, 2u, 3u, 4u};
+    std::vector<int> values = {10, 7, 1, 3, 2};
+    std::vector<int> costs = {9, 12, 2, 7, 5};
+    int budget = 15;
+
+    auto alg = knapsack_dp(items, values, costs, budget);
+    alg.run();
+
+    ASSERT_TRUE(EQ_MULTISETS(alg.solution_items(), {0u, 4u}));
+    ASSERT_EQ(alg.solution_value(), 12);
+    ASSERT_EQ(alg.solution_cost(), 14);
+}
+
+GTEST_TEST(knapsack_dp, set_budget_rederives_the_item_filter) {
+    std::vector<std::size_t> items = {0u, 1u, 2u};
+    std::vector<int> values = {10, 7, 1};
+    std::vector<int> costs = {9, 12, 2};
+
+    auto alg = knapsack_dp(items, values, [&](auto i) { return costs[i]; }, 3);
+    ASSERT_EQ(alg.run().solution_value(), 1);
+
+    alg.set_budget(23);
+    ASSERT_EQ(alg.run().solution_value(), 18);
+    ASSERT_TRUE(EQ_MULTISETS(alg.solution_items(), {0u, 1u, 2u}));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// random instances agree with exhaustive enumeration, zero costs and budgets
+// at word boundaries included
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(knapsack_dp, matches_exhaustive_enumeration) {
+    std::uniform_int_distribution<int> value_dist(0, 30);
+    std::uniform_int_distribution<int> cost_dist(0, 40);
+    for(int test_i = 0; test_i < 200; ++test_i) {
+        const std::size_t n = 1 + static_cast<std::size_t>(test_i % 12);
+        std::vector<int> values(n), costs(n);
+        for(std::size_t i = 0; i < n; ++i) {
+            values[i] = value_dist(test_rng());
+            costs[i] = cost_dist(test_rng());
+        }
+        const int budget = test_i % 3 == 0 ? 64 : cost_dist(test_rng()) * 3;
+
+        int best = 0;
+        for(std::size_t subset = 0; subset < (std::size_t{1} << n); ++subset) {
+            int value = 0, cost = 0;
+            for(std::size_t i = 0; i < n; ++i)
+                if((subset >> i) & 1u) {
+                    value += values[i];
+                    cost += costs[i];
+                }
+            if(cost <= budget) best = std::max(best, value);
+        }
+
+        auto alg = knapsack_dp(std::views::iota(0uz, n), values, costs, budget);
+        alg.run();
+        ASSERT_EQ(alg.solution_value(), best);
+        ASSERT_LE(alg.solution_cost(), budget);
+        int value = 0, cost = 0;
+        for(auto && i : alg.solution_items()) {
+            value += values[i];
+            cost += costs[i];
+        }
+        ASSERT_EQ(value, alg.solution_value());
+        ASSERT_EQ(cost, alg.solution_cost());
+    }
+}
@@ -0,0 +1,178 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "melon/algorithm/competing_dijkstras.hpp"
+#include "melon/algorithm/multi_competing_dijkstras.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+struct storing_traits
+    : multi_competing_dijkstras_default_traits<static_digraph, int> {
+    static constexpr bool store_distances = true;
+    static constexpr bool store_colors = true;
+};
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// three colors on a path, each with its own lengths: a claimed vertex blocks
+// the others, and the smaller color wins a tie
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(multi_competing_dijkstras, test) {
+    // 0 - 1 - 2 - 3 - 4 - 5 - 6, both ways
+    static_digraph_builder<static_digraph, int, int, int> builder(7);
+    for(unsigned v = 0; v < 6; ++v) {
+        builder.add_arc(v, v + 1, 1, 2, 3);
+        builder.add_arc(v + 1, v, 1, 2, 3);
+    }
+    auto [graph, slow, medium, fast] = builder.build();
+    // an rvalue range: the algorithm owns the maps
+    std::vector<std::vector<int>> length_maps;
+    length_maps.push_back(std::move(slow));
+    length_maps.push_back(std::move(medium));
+    length_maps.push_back(std::move(fast));
+
+    multi_competing_dijkstras alg(storing_traits{}, graph,
+                                  std::move(length_maps));
+    static_assert(std::movable<decltype(alg)> && !std::copyable<decltype(alg)>);
+    ASSERT_EQ(alg.num_colors(), 3u);
+    alg.add_source(0u, 0).add_source(3u, 1).add_source(6u, 2);
+
+    std::vector<std::pair<unsigned, std::pair<int, std::size_t>>> yielded;
+    for(auto && [v, entry] : alg) yielded.emplace_back(v, entry);
+    // 2 is at 2 from both 0 (color 0) and 3 (color 1): color 0 wins it; 5 is
+    // at 3 from 6 (color 2), and at 4 from 3
+    ASSERT_TRUE(EQ_MULTISETS(
+        yielded,
+        std::vector<std::pair<unsigned, std::pair<int, std::size_t>>>{
+            {0u, {0, 0}},
+            {3u, {0, 1}},
+            {6u, {0, 2}},
+            {1u, {1, 0}},
+            {2u, {2, 0}},
+            {4u, {2, 1}},
+            {5u, {3, 2}}}));
+    for(std::size_t i = 1; i < yielded.size(); ++i)
+        ASSERT_LE(yielded[i - 1].second.first, yielded[i].second.first);
+    ASSERT_EQ(alg.color(5u), 2u);
+    ASSERT_EQ(alg.dist(5u), 3);
+
+    // a source seeded at 5 is taken by color 0, which reaches it at 4
+    alg.reset().add_source(0u, 0).add_source(4u, 1, 5).add_source(6u, 2).run();
+    ASSERT_EQ(alg.color(4u), 0u);
+    ASSERT_EQ(alg.dist(4u), 4);
+    ASSERT_EQ(alg.color(5u), 2u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// with two colors, color 0 claims exactly what competing_dijkstras' blue does
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(multi_competing_dijkstras, matches_competing_dijkstras) {
+    for(std::size_t it = 0; it < 50; ++it) {
+        const std::size_t n = 2 + test_rng()() % 300;
+        static_digraph_builder<static_digraph, int, int> builder(n);
+        for(std::size_t k = 0; k < 4 * n; ++k) {
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % 10),
+                            static_cast<int>(test_rng()() % 10));
+        }
+        auto [graph, blue_length_map, red_length_map] = builder.build();
+        std::vector<std::vector<int>> length_maps;
+        length_maps.push_back(std::move(blue_length_map));
+        length_maps.push_back(std::move(red_length_map));
+
+        competing_dijkstras race(graph, length_maps[0], length_maps[1]);
+        multi_competing_dijkstras alg(graph, length_maps);
+        // the blue sources first: competing_dijkstras settles what red wins
+        // as soon as it is sure to, so a later source may no longer be fresh
+        std::vector<unsigned> blue_sources, red_sources;
+        for(std::size_t k = 0; k < 4; ++k) {
+            const auto s = static_cast<unsigned>(test_rng()() % n);
+            if(alg.reached(s)) continue;
+            (k % 2 == 0 ? blue_sources : red_sources).push_back(s);
+            alg.add_source(s, k % 2);
+        }
+        for(auto && s : blue_sources) race.add_blue_source(s);
+        for(auto && s : red_sources) race.add_red_source(s);
+
+        std::vector<unsigned> expected, claimed;
+        for(auto && [v, entry] : race) expected.push_back(v);
+        for(auto && [v, entry] : alg)
+            if(entry.second == 0) claimed.push_back(v);
+        ASSERT_TRUE(EQ_MULTISETS(claimed, expected));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random graphs with k colors, the claims are the race's fixed point: every
+// vertex is reached by its own color through a vertex it claims, and no arc
+// from a claimed vertex offers a better (distance, color)
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(multi_competing_dijkstras, claims_are_a_fixed_point) {
+    for(std::size_t it = 0; it < 50; ++it) {
+        const std::size_t n = 2 + test_rng()() % 500;
+        const std::size_t num_colors = 1 + test_rng()() % 12;
+        static_digraph_builder<static_digraph, int> builder(n);
+        for(std::size_t k = 0; k < 3 * n; ++k) {
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            1 + static_cast<int>(test_rng()() % 20));
+        }
+        auto [graph, length_map] = builder.build();
+        // one map per color: the same lengths, scaled by the color's speed
+        std::vector<int> slowness(num_colors);
+        for(auto && s : slowness) s = 1 + static_cast<int>(test_rng()() % 5);
+        const auto scaled = [&](const std::size_t c) {
+            return maps::map([&, c](const arc_t<static_digraph> & a) {
+                return slowness[c] * length_map[a];
+            });
+        };
+        std::vector<decltype(scaled(0))> length_maps;
+        for(std::size_t c = 0; c < num_colors; ++c)
+            length_maps.push_back(scaled(c));
+
+        multi_competing_dijkstras alg(storing_traits{}, graph, length_maps);
+        auto source_color = create_vertex_map<std::size_t>(graph, num_colors);
+        for(std::size_t c = 0; c < num_colors; ++c) {
+            const auto s = static_cast<unsigned>(test_rng()() % n);
+            if(alg.reached(s)) continue;
+            alg.add_source(s, c);
+            source_color[s] = c;
+        }
+        alg.run();
+
+        auto supported = create_vertex_map<bool>(graph, false);
+        for(auto && a : arcs(graph)) {
+            const auto u = arc_source(graph, a), v = arc_target(graph, a);
+            if(!alg.visited(u)) continue;
+            ASSERT_TRUE(alg.visited(v));
+            const std::pair<int, std::size_t> offer = {
+                alg.dist(u) + length_maps[alg.color(u)][a], alg.color(u)};
+            ASSERT_GE(offer, std::make_pair(alg.dist(v), alg.color(v)));
+            if(offer == std::make_pair(alg.dist(v), alg.color(v)))
+                supported[v] = true;
+        }
+        for(auto && v : vertices(graph)) {
+            if(!alg.visited(v)) continue;
+            if(source_color[v] != num_colors) {
+                ASSERT_EQ(alg.color(v), source_color[v]);
+                ASSERT_EQ(alg.dist(v), 0);
+            } else {
+                ASSERT_TRUE(supported[v]) << v;
+            }
+        }
+    }
+}
@@ -0,0 +1,210 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include "melon/algorithm/dinitz.hpp"
+#include "melon/algorithm/network_simplex.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+
+// Checks that the flow is feasible and that the potentials certify it
+// optimal by complementary slackness; returns its cost.
+template <typename Alg, typename Capacities, typename Costs>
+long assert_is_optimal(const Alg & alg, const static_digraph & graph,
+                       const Capacities & capacity, const Costs & cost,
+                       const std::vector<int> & supply) {
+    std::vector<long> balance(num_vertices(graph), 0);
+    long total = 0;
+    for(auto && [a, endpoints] : arcs_entries(graph)) {
+        EXPECT_GE(alg.flow(a), 0) << "arc " << a;
+        EXPECT_LE(alg.flow(a), capacity[a]) << "arc " << a;
+        EXPECT_EQ(alg.flows_map()[a], alg.flow(a));
+        balance[endpoints.first] += alg.flow(a);
+        balance[endpoints.second] -= alg.flow(a);
+        total += static_cast<long>(alg.flow(a)) * cost[a];
+
+        const long reduced_cost = cost[a] + alg.potential(endpoints.first) -
+                                  alg.potential(endpoints.second);
+        if(alg.flow(a) < capacity[a]) {
+            EXPECT_GE(reduced_cost, 0) << "arc " << a;
+        }
+        if(alg.flow(a) > 0) {
+            EXPECT_LE(reduced_cost, 0) << "arc " << a;
+        }
+    }
+    for(auto && v : vertices(graph)) {
+        EXPECT_EQ(balance[v], supply[v]) << "conservation at " << v;
+        EXPECT_EQ(alg.potentials_map()[v], alg.potential(v));
+    }
+    EXPECT_EQ(alg.total_cost(), total);
+    return total;
+}
+
+// Whether the supplies can be met at all, as a maximum flow from a super
+// source to a super sink.
+template <typename Capacities>
+bool is_feasible(const static_digraph & graph, const Capacities & capacity,
+                 const std::vector<int> & supply) {
+    const std::size_t n = supply.size();
+    if(std::accumulate(supply.begin(), supply.end(), 0) != 0) return false;
+    static_digraph_builder<static_digraph, int> builder(n + 2);
+    for(auto && [a, endpoints] : arcs_entries(graph))
+        builder.add_arc(endpoints.first, endpoints.second, capacity[a]);
+    int total_supply = 0;
+    for(std::size_t v = 0; v < n; ++v) {
+        if(supply[v] > 0) {
+            builder.add_arc(static_cast<unsigned>(n), static_cast<unsigned>(v),
+                            supply[v]);
+            total_supply += supply[v];
+        } else if(supply[v] < 0) {
+            builder.add_arc(static_cast<unsigned>(v),
+                            static_cast<unsigned>(n + 1), -supply[v]);
+        }
+    }
+    auto [reference_graph, reference_capacity] = builder.build();
+    dinitz alg(reference_graph, reference_capacity, static_cast<unsigned>(n),
+               static_cast<unsigned>(n + 1));
+    return alg.run().flow_value() == total_supply;
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// a transportation problem: two plants supplying two shops
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(network_simplex, transportation) {
+    static_digraph_builder<static_digraph, int, int> builder(4);
+    builder.add_arc(0, 2, 10, 1)
+        .add_arc(0, 3, 10, 3)
+        .add_arc(1, 2, 10, 2)
+        .add_arc(1, 3, 10, 1);
+    auto [graph, capacity, cost] = builder.build();
+    const std::vector<int> supply = {5, 5, -4, -6};
+
+    network_simplex alg(graph, capacity, cost, supply);
+    ASSERT_TRUE(alg.run().feasible());
+    ASSERT_EQ(assert_is_optimal(alg, graph, capacity, cost, supply), 12);
+    ASSERT_EQ(alg.flow(0u), 4);
+    ASSERT_EQ(alg.flow(1u), 1);
+    ASSERT_EQ(alg.flow(2u), 0);
+    ASSERT_EQ(alg.flow(3u), 5);
+
+    // run() is idempotent, and reset() clears the solution
+    ASSERT_EQ(alg.run().total_cost(), 12);
+    alg.reset();
+    for(auto && a : arcs(graph)) ASSERT_EQ(alg.flow(a), 0);
+    EXPECT_DEATH((void)alg.feasible(), "");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// a negative cycle is saturated even with every supply zero
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(network_simplex, negative_cycle) {
+    static_digraph_builder<static_digraph, int, int> builder(3);
+    builder.add_arc(0, 1, 4, -3).add_arc(1, 2, 2, 1).add_arc(2, 0, 7, 1);
+    auto [graph, capacity, cost] = builder.build();
+    const std::vector<int> supply = {0, 0, 0};
+
+    network_simplex alg(graph, capacity, cost, supply);
+    ASSERT_TRUE(alg.run().feasible());
+    ASSERT_EQ(assert_is_optimal(alg, graph, capacity, cost, supply), -2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// too little capacity, or supplies that do not balance
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(network_simplex, infeasible) {
+    static_digraph_builder<static_digraph, int, int> builder(3);
+    builder.add_arc(0, 1, 3, 1).add_arc(1, 2, 3, 1);
+    auto [graph, capacity, cost] = builder.build();
+
+    ASSERT_FALSE(network_simplex(graph, capacity, cost,
+                                 std::vector<int>{4, 0, -4})
+                     .run()
+                     .feasible());
+    ASSERT_FALSE(network_simplex(graph, capacity, cost,
+                                 std::vector<int>{2, 0, -1})
+                     .run()
+                     .feasible());
+    ASSERT_TRUE(network_simplex(graph, capacity, cost,
+                                std::vector<int>{3, 0, -3})
+                    .run()
+                    .feasible());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// the assignment problem, against every permutation
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(network_simplex, assignment) {
+    for(std::size_t it = 0; it < 30; ++it) {
+        const unsigned k = 1 + static_cast<unsigned>(test_rng()() % 6);
+        static_digraph_builder<static_digraph, int, int> builder(2 * k);
+        std::vector<std::vector<int>> weight(k, std::vector<int>(k));
+        for(unsigned i = 0; i < k; ++i) {
+            for(unsigned j = 0; j < k; ++j) {
+                weight[i][j] = static_cast<int>(test_rng()() % 50);
+                builder.add_arc(i, k + j, 1, weight[i][j]);
+            }
+        }
+        auto [graph, capacity, cost] = builder.build();
+        std::vector<int> supply(2 * k, 1);
+        std::fill(supply.begin() + k, supply.end(), -1);
+
+        std::vector<unsigned> permutation(k);
+        std::iota(permutation.begin(), permutation.end(), 0u);
+        int best = std::numeric_limits<int>::max();
+        do {
+            int sum = 0;
+            for(unsigned i = 0; i < k; ++i) sum += weight[i][permutation[i]];
+            best = std::min(best, sum);
+        } while(std::ranges::next_permutation(permutation).found);
+
+        network_simplex alg(graph, capacity, cost, supply);
+        ASSERT_TRUE(alg.run().feasible());
+        ASSERT_EQ(assert_is_optimal(alg, graph, capacity, cost, supply), best);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random networks with negative costs, the flow found is optimal exactly
+// when one exists
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(network_simplex, random_instances) {
+    for(std::size_t it = 0; it < 300; ++it) {
+        const std::size_t n = 1 + test_rng()() % 15;
+        const std::size_t m = test_rng()() % (4 * n + 1);
+        static_digraph_builder<static_digraph, int, int> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % 10),
+                            static_cast<int>(test_rng()() % 21) - 5);
+        auto [graph, capacity, cost] = builder.build();
+        auto supply = random_vector<int>(n, -8, 8);
+        // balance the supplies most of the time
+        if(test_rng()() % 4 != 0) {
+            supply[0] -= std::accumulate(supply.begin(), supply.end(), 0);
+        }
+
+        network_simplex alg(graph, capacity, cost, supply);
+        ASSERT_EQ(alg.run().feasible(), is_feasible(graph, capacity, supply));
+        if(alg.feasible())
+            assert_is_optimal(alg, graph, capacity, cost, supply);
+    }
+}
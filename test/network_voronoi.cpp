@@ -1,10 +1,15 @@
 #undef NDEBUG
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 #include "melon/algorithm/network_voronoi.hpp"
 #include "melon/container/static_digraph.hpp"
 #include "melon/utility/static_digraph_builder.hpp"
 
+#include "random_ranges_helper.hpp"
 #include "ranges_test_helper.hpp"
 
 using namespace melon;
@@ -300,3 +305,86 @@ GTEST_TEST(network_voronoi, stored_distances_and_clusters) {
     ASSERT_EQ(alg.cluster(4u), 3u);
     ASSERT_EQ(alg.cluster(5u), 5u);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// add_kernel / remove_kernel keep the stored partition equal to the one
+// computed from scratch for the current kernels
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(network_voronoi, incremental_kernels) {
+    static_digraph_builder<static_digraph, int> builder(6);
+    builder.add_arc(0, 1, 7)
+        .add_arc(1, 0, 7)
+        .add_arc(1, 2, 10)
+        .add_arc(2, 1, 10)
+        .add_arc(2, 3, 1)
+        .add_arc(3, 2, 1)
+        .add_arc(3, 4, 6)
+        .add_arc(4, 3, 6);
+    auto [graph, length_map] = builder.build();
+
+    std::vector<vertex_t<static_digraph>> kernels = {0u};
+    network_voronoi alg(network_voronoi_storing_traits{}, graph, length_map,
+                        kernels);
+    alg.run();
+    ASSERT_EQ(alg.cluster(4u), 0u);
+    ASSERT_EQ(alg.dist(4u), 24);
+    ASSERT_FALSE(alg.reached(5u));
+
+    alg.add_kernel(4u);
+    ASSERT_TRUE(alg.finished());
+    ASSERT_EQ(alg.cluster(1u), 0u);
+    for(auto && v : {2u, 3u, 4u}) ASSERT_EQ(alg.cluster(v), 4u);
+    ASSERT_EQ(alg.dist(2u), 7);
+
+    alg.remove_kernel(0u);
+    for(auto && v : {0u, 1u, 2u, 3u, 4u}) ASSERT_EQ(alg.cluster(v), 4u);
+    ASSERT_EQ(alg.dist(0u), 24);
+
+    alg.remove_kernel(4u);
+    for(auto && v : vertices(graph)) ASSERT_FALSE(alg.reached(v));
+    alg.add_kernel(5u);
+    ASSERT_TRUE(alg.visited(5u));
+    ASSERT_FALSE(alg.reached(4u));
+}
+
+GTEST_TEST(network_voronoi, incremental_kernels_match_recomputation) {
+    for(std::size_t it = 0; it < 20; ++it) {
+        const std::size_t n = 2 + test_rng()() % 500;
+        static_digraph_builder<static_digraph, int> builder(n);
+        for(std::size_t k = 0; k < 3 * n; ++k) {
+            const auto u = static_cast<unsigned>(test_rng()() % n);
+            const auto v = static_cast<unsigned>(test_rng()() % n);
+            const int length = static_cast<int>(test_rng()() % 20);
+            builder.add_arc(u, v, length);
+            if(k % 2 == 0) builder.add_arc(v, u, length);
+        }
+        auto [graph, length_map] = builder.build();
+
+        std::vector<vertex_t<static_digraph>> kernels;
+        network_voronoi alg(network_voronoi_storing_traits{}, graph,
+                            length_map, kernels);
+        alg.run();
+        for(std::size_t step = 0; step < 30; ++step) {
+            if(kernels.empty() || test_rng()() % 3 != 0) {
+                const auto k = static_cast<unsigned>(test_rng()() % n);
+                if(std::ranges::find(kernels, k) != kernels.end()) continue;
+                kernels.push_back(k);
+                alg.add_kernel(k);
+            } else {
+                const std::size_t i = test_rng()() % kernels.size();
+                alg.remove_kernel(kernels[i]);
+                kernels.erase(kernels.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+            network_voronoi expected(network_voronoi_storing_traits{}, graph,
+                                     length_map, kernels);
+            expected.run();
+            for(auto && v : vertices(graph)) {
+                ASSERT_EQ(alg.reached(v), expected.reached(v)) << v;
+                if(!expected.reached(v)) continue;
+                ASSERT_EQ(alg.dist(v), expected.dist(v)) << v;
+                ASSERT_EQ(alg.cluster(v), expected.cluster(v)) << v;
+            }
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ranges>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "melon/algorithm/bentley_ottmann.hpp"
+#include "melon/algorithm/parallel_bentley_ottmann.hpp"
+
+#include "random_ranges_helper.hpp"
+
+using namespace melon;
+using namespace melon::numeric;
+
+namespace {
+using coord = integer<std::int64_t>;
+using point = std::tuple<coord, coord>;
+using segment = std::tuple<point, point>;
+using intersection = decltype(cartesian::segments_intersection(
+    std::declval<segment>(), std::declval<segment>()))::value_type;
+using intersections = std::vector<
+    std::pair<intersection, std::vector<std::size_t>>>;
+
+intersections serial_sweep(const std::vector<segment> & segments) {
+    intersections found;
+    for(auto && [p, intersecting_segments] :
+        bentley_ottmann(std::views::iota(0uz, segments.size()), segments)) {
+        found.emplace_back(
+            p, std::vector<std::size_t>(intersecting_segments.begin(),
+                                        intersecting_segments.end()));
+    }
+    return found;
+}
+
+intersections parallel_sweep(const std::vector<segment> & segments,
+                             const std::size_t num_threads) {
+    parallel_bentley_ottmann alg(std::views::iota(0uz, segments.size()),
+                                 segments);
+    alg.set_num_threads(num_threads).run();
+    return intersections(alg.intersections().begin(),
+                         alg.intersections().end());
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// three segments through one point, whatever the number of threads
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_bentley_ottmann, test) {
+    std::vector<segment> segments = {{{0, 0}, {4, 4}},
+                                     {{0, 4}, {4, 0}},
+                                     {{2, -1}, {2, 5}}};
+    parallel_bentley_ottmann alg(std::views::iota(0uz, segments.size()),
+                                 segments);
+    static_assert(std::movable<decltype(alg)> && !std::copyable<decltype(alg)>);
+    for(std::size_t num_threads : {1uz, 2uz, 5uz}) {
+        alg.set_num_threads(num_threads).reset().run();
+        ASSERT_EQ(alg.num_threads(), num_threads);
+        ASSERT_EQ(alg.intersections().size(), 1u);
+        const auto & [p, intersecting_segments] = alg.intersections()[0];
+        ASSERT_EQ(std::get<0>(p), 2);
+        ASSERT_EQ(std::get<1>(p), 2);
+        ASSERT_EQ(intersecting_segments, (std::vector<std::size_t>{2, 0, 1}));
+    }
+
+    parallel_bentley_ottmann empty(std::views::iota(0uz, 0uz), segments);
+    ASSERT_TRUE(empty.set_num_threads(3).run().intersections().empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// the same points, ids and order as one sweep, on short random segments and on
+// a dense box full of degeneracies
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_bentley_ottmann, matches_bentley_ottmann) {
+    for(std::size_t test_i = 0; test_i < 20; ++test_i) {
+        std::uniform_int_distribution<int> box(-1000, 1000), vec(-40, 40),
+            dense(-20, 20);
+        std::vector<segment> sparse_segments, dense_segments;
+        for(std::size_t i = 0; i < 1000; ++i) {
+            const int x = box(test_rng()), y = box(test_rng());
+            sparse_segments.emplace_back(
+                point(x, y), point(x + vec(test_rng()), y + vec(test_rng())));
+        }
+        for(std::size_t i = 0; i < 100; ++i) {
+            dense_segments.emplace_back(
+                point(dense(test_rng()), dense(test_rng())),
+                point(dense(test_rng()), dense(test_rng())));
+        }
+        for(auto && segments : {sparse_segments, dense_segments}) {
+            const intersections expected = serial_sweep(segments);
+            for(std::size_t num_threads : {1uz, 2uz, 3uz, 8uz})
+                ASSERT_EQ(parallel_sweep(segments, num_threads), expected);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// a grid whose crossings all lie on slab boundaries: each is reported once,
+// by the slab on its right
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_bentley_ottmann, reports_boundary_points_once) {
+    std::vector<segment> segments;
+    for(int k = 0; k < 40; ++k) {
+        segments.emplace_back(point(k, 0), point(k, 39));
+        segments.emplace_back(point(0, k), point(39, k));
+    }
+    const intersections expected = serial_sweep(segments);
+    ASSERT_EQ(expected.size(), 40u * 40u);
+    for(std::size_t num_threads : {2uz, 3uz, 8uz})
+        ASSERT_EQ(parallel_sweep(segments, num_threads), expected);
+}
@@ -0,0 +1,116 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "melon/algorithm/kruskal.hpp"
+#include "melon/algorithm/parallel_boruvka.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+#include "melon/views/undirect.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+////////////////////////////////////////////////////////////////////////////////
+// the minimum spanning tree of kruskal's example, and its cost
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_boruvka, test) {
+    static_digraph_builder<static_digraph, int> builder(6);
+    builder.add_arc(0, 1, 7)
+        .add_arc(0, 2, 9)
+        .add_arc(0, 5, 14)
+        .add_arc(1, 2, 10)
+        .add_arc(1, 3, 15)
+        .add_arc(2, 3, 12)
+        .add_arc(2, 5, 2)
+        .add_arc(3, 4, 6)
+        .add_arc(4, 5, 11);
+    auto [graph, cost_map] = builder.build();
+
+    parallel_boruvka alg(views::undirect(graph), cost_map);
+    alg.run();
+    ASSERT_TRUE(EQ_MULTISETS(alg.tree_edges(), {6u, 7u, 0u, 1u, 8u}));
+    ASSERT_EQ(alg.total_cost(), 35);
+
+    // run() is idempotent, and reset() recomputes the same tree
+    ASSERT_EQ(alg.run().total_cost(), 35);
+    ASSERT_EQ(alg.reset().run().tree_edges().size(), 5u);
+    EXPECT_DEATH((void)alg.reset().total_cost(), "");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// no vertices, no edges, self-loops and parallel edges
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_boruvka, degenerate_graphs) {
+    {
+        static_digraph_builder<static_digraph, int> builder(0);
+        auto [graph, cost_map] = builder.build();
+        parallel_boruvka alg(views::undirect(graph), cost_map);
+        ASSERT_TRUE(alg.run().tree_edges().empty());
+        ASSERT_EQ(alg.total_cost(), 0);
+    }
+    {
+        static_digraph_builder<static_digraph, int> builder(3);
+        builder.add_arc(0, 0, -5)
+            .add_arc(0, 1, 4)
+            .add_arc(1, 0, 3)
+            .add_arc(1, 1, 1);
+        auto [graph, cost_map] = builder.build();
+        parallel_boruvka alg(views::undirect(graph), cost_map);
+        ASSERT_TRUE(EQ_RANGES(alg.run().tree_edges(), {2u}));
+        ASSERT_EQ(alg.total_cost(), 3);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random graphs, from forests to dense graphs with many equal costs: a
+// spanning forest as light as kruskal's, the same for every thread count
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_boruvka, matches_kruskal) {
+    for(std::size_t it = 0; it < 30; ++it) {
+        const std::size_t n = 1 + test_rng()() % (it < 20 ? 100 : 5000);
+        const std::size_t m = test_rng()() % (it < 25 ? 2 * n : 20 * n);
+        const unsigned max_cost = it % 3 == 0 ? 4 : 100000;
+        static_digraph_builder<static_digraph, int> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n),
+                            static_cast<int>(test_rng()() % max_cost));
+        auto [graph, cost_map] = builder.build();
+        auto ugraph = views::undirect(graph);
+
+        std::size_t num_reference_edges = 0;
+        long reference_cost = 0;
+        for(auto && e : kruskal(ugraph, cost_map)) {
+            ++num_reference_edges;
+            reference_cost += cost_map[e];
+        }
+
+        std::vector<vertex_t<static_digraph>> first_run;
+        for(std::size_t num_threads : {1u, 2u, 8u}) {
+            parallel_boruvka alg(ugraph, cost_map);
+            alg.set_num_threads(num_threads).run();
+            ASSERT_EQ(alg.num_threads(), num_threads);
+            ASSERT_EQ(alg.tree_edges().size(), num_reference_edges);
+            long cost = 0;
+            for(auto && e : alg.tree_edges()) cost += cost_map[e];
+            ASSERT_EQ(cost, reference_cost);
+            ASSERT_EQ(alg.total_cost(), reference_cost);
+
+            std::vector<vertex_t<static_digraph>> edges(
+                alg.tree_edges().begin(), alg.tree_edges().end());
+            if(num_threads == 1)
+                first_run = edges;
+            else
+                ASSERT_EQ(edges, first_run);
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "melon/algorithm/connected_components.hpp"
+#include "melon/algorithm/parallel_connected_components.hpp"
+#include "melon/container/mutable_digraph.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+#include "melon/views/undirect.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+
+// the labels and sizes the serial traversal implies: components numbered by
+// their smallest vertex
+std::pair<std::vector<std::size_t>, std::vector<std::size_t>>
+reference_components(const static_digraph & graph) {
+    std::vector<std::size_t> label(num_vertices(graph));
+    std::vector<std::size_t> sizes;
+    for(auto && component : weakly_connected_components(graph)) {
+        for(auto && v : component) label[v] = sizes.size();
+        sizes.push_back(std::ranges::size(component));
+    }
+    return {label, sizes};
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// the components of a small digraph, seen through views::undirect
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_connected_components, test) {
+    static_digraph_builder<static_digraph> builder(8);
+    builder.add_arc(0, 1)
+        .add_arc(1, 2)
+        .add_arc(1, 3)
+        .add_arc(2, 0)
+        .add_arc(4, 3)
+        .add_arc(5, 6)
+        .add_arc(6, 5)
+        .add_arc(5, 6);
+    auto [graph] = builder.build();
+
+    auto alg = parallel_weakly_connected_components(graph);
+    alg.run();
+    ASSERT_EQ(alg.num_components(), 3);
+    ASSERT_TRUE(EQ_RANGES(alg.component_sizes(), {5u, 2u, 1u}));
+    for(auto && v : {0u, 1u, 2u, 3u, 4u}) ASSERT_EQ(alg.component(v), 0);
+    ASSERT_EQ(alg.component(5u), 1);
+    ASSERT_EQ(alg.component(6u), 1);
+    ASSERT_EQ(alg.component(7u), 2);
+    ASSERT_EQ(alg.components_map()[4u], 0);
+
+    // run() is idempotent, reset() recomputes the same labelling
+    ASSERT_EQ(alg.run().num_components(), 3);
+    ASSERT_EQ(alg.reset().run().num_components(), 3);
+    ASSERT_EQ(alg.component(7u), 2);
+
+    auto components = std::move(alg).components_map();
+    ASSERT_EQ(components[6u], 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// no vertices, and no edges
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_connected_components, degenerate_graphs) {
+    {
+        static_digraph_builder<static_digraph> builder(0);
+        auto [graph] = builder.build();
+        auto alg = parallel_weakly_connected_components(graph);
+        ASSERT_EQ(alg.run().num_components(), 0);
+        ASSERT_TRUE(alg.component_sizes().empty());
+    }
+    {
+        static_digraph_builder<static_digraph> builder(5);
+        auto [graph] = builder.build();
+        auto alg = parallel_weakly_connected_components(graph);
+        ASSERT_EQ(alg.run().num_components(), 5);
+        for(auto && v : vertices(graph)) ASSERT_EQ(alg.component(v), v);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random graphs, some with a giant component, most with many small ones,
+// and large enough to be split across the threads: the serial labelling
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_connected_components, matches_connected_components) {
+    for(std::size_t it = 0; it < 40; ++it) {
+        const std::size_t n = 1 + test_rng()() % (it < 20 ? 30 : 20000);
+        const std::size_t m = test_rng()() % (2 * n + 1);
+        static_digraph_builder<static_digraph> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n));
+        auto [graph] = builder.build();
+        const auto [label, sizes] = reference_components(graph);
+
+        for(std::size_t num_threads : {1u, 2u, 4u, 8u}) {
+            auto alg = parallel_weakly_connected_components(graph);
+            alg.set_num_threads(num_threads).run();
+            ASSERT_EQ(alg.num_threads(), num_threads);
+            ASSERT_TRUE(EQ_RANGES(alg.component_sizes(), sizes));
+            for(auto && v : vertices(graph))
+                ASSERT_EQ(alg.component(v), label[v]) << "vertex " << v;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// vertices that are not positions: a mutable_digraph with removed vertices,
+// labelled in the order of its vertices() range
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_connected_components, sparse_vertex_ids) {
+    for(std::size_t it = 0; it < 10; ++it) {
+        mutable_digraph graph;
+        const std::size_t n = 2 + test_rng()() % 3000;
+        std::vector<vertex_t<mutable_digraph>> created;
+        for(std::size_t i = 0; i < n; ++i)
+            created.push_back(graph.create_vertex());
+        for(std::size_t k = 0; k < n; ++k)
+            (void)graph.create_arc(random_element(created),
+                                   random_element(created));
+        for(std::size_t k = 0; k < n / 4; ++k) {
+            const auto v = random_element(created);
+            if(graph.is_valid_vertex(v)) graph.remove_vertex(v);
+        }
+
+        std::vector<vertex_t<mutable_digraph>> vertex_order;
+        for(auto && v : vertices(graph)) vertex_order.push_back(v);
+        std::vector<std::size_t> label(n);
+        std::vector<std::size_t> sizes;
+        for(auto && component : weakly_connected_components(graph)) {
+            for(auto && v : component) label[v] = sizes.size();
+            sizes.push_back(std::ranges::size(component));
+        }
+
+        auto alg = parallel_weakly_connected_components(graph);
+        alg.set_num_threads(4).run();
+        ASSERT_TRUE(EQ_RANGES(alg.component_sizes(), sizes));
+        for(auto && v : vertex_order)
+            ASSERT_EQ(alg.component(v), label[v]) << "vertex " << v;
+    }
+}
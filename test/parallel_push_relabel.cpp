@@ -0,0 +1,186 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <vector>
+
+#include "melon/algorithm/dinitz.hpp"
+#include "melon/algorithm/parallel_push_relabel.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+
+// capacity-feasible, and conserved everywhere but at the terminals, whose
+// imbalance is the flow value
+template <typename Alg, typename Capacities>
+void assert_is_flow(const Alg & alg, const static_digraph & graph,
+                    const Capacities & capacity, const vertex_t<static_digraph> s,
+                    const vertex_t<static_digraph> t) {
+    std::vector<long> balance(num_vertices(graph), 0);
+    for(auto && [a, endpoints] : arcs_entries(graph)) {
+        ASSERT_GE(alg.flow(a), 0) << "arc " << a;
+        ASSERT_LE(alg.flow(a), capacity[a]) << "arc " << a;
+        ASSERT_EQ(alg.flows_map()[a], alg.flow(a));
+        balance[endpoints.first] -= alg.flow(a);
+        balance[endpoints.second] += alg.flow(a);
+    }
+    for(auto && v : vertices(graph)) {
+        if(v == s || v == t) continue;
+        ASSERT_EQ(balance[v], 0) << "conservation at " << v;
+    }
+    ASSERT_EQ(balance[t], alg.flow_value());
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// parallel_push_relabel computes the maximum flow value and a minimum cut
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_push_relabel, test) {
+    static_digraph_builder<static_digraph, int, char> builder(6);
+
+    // example from https://www.geeksforgeeks.org/max-flow-problem-introduction/
+    builder.add_arc(0, 1, 16, false);
+    builder.add_arc(0, 2, 13, false);
+    builder.add_arc(1, 2, 10, false);
+    builder.add_arc(1, 3, 12, true);  //
+    builder.add_arc(2, 1, 4, false);
+    builder.add_arc(2, 4, 14, false);
+    builder.add_arc(3, 2, 9, false);
+    builder.add_arc(3, 5, 20, false);
+    builder.add_arc(4, 3, 7, true);  //
+    builder.add_arc(4, 5, 4, true);  //
+
+    auto [graph, capacity, part_of_minimum_cut] = builder.build();
+
+    for(std::size_t num_threads : {1u, 2u, 4u}) {
+        parallel_push_relabel alg(graph, capacity, 0u, 5u);
+        alg.set_num_threads(num_threads);
+        ASSERT_EQ(alg.run().flow_value(), 23);
+        ASSERT_TRUE(EQ_MULTISETS(
+            alg.minimum_cut(),
+            std::views::filter(arcs(graph), [&](const auto & a) {
+                return part_of_minimum_cut[a];
+            })));
+        assert_is_flow(alg, graph, capacity, 0u, 5u);
+
+        alg.reset();
+        ASSERT_EQ(alg.flow_value(), 0);
+        for(auto && a : arcs(graph)) ASSERT_EQ(alg.flow(a), 0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// degenerate networks: a single arc, a zero capacity, no arcs at all, and
+// excess that has nowhere to go but back to the source
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_push_relabel, arc_with_fixed_capacity) {
+    static_digraph_builder<static_digraph, int> builder(2);
+    builder.add_arc(0, 1, 107);
+    auto [graph, capacity] = builder.build();
+
+    parallel_push_relabel alg(graph, capacity, 0u, 1u);
+    ASSERT_EQ(alg.run().flow_value(), 107);
+    ASSERT_TRUE(EQ_MULTISETS(alg.minimum_cut(), {0u}));
+}
+
+GTEST_TEST(parallel_push_relabel, arc_with_0_capacity) {
+    static_digraph_builder<static_digraph, int> builder(2);
+    builder.add_arc(0, 1, 0);
+    auto [graph, capacity] = builder.build();
+
+    parallel_push_relabel alg(graph, capacity, 0u, 1u);
+    ASSERT_EQ(alg.run().flow_value(), 0);
+    ASSERT_TRUE(EQ_MULTISETS(alg.minimum_cut(), {0u}));
+}
+
+GTEST_TEST(parallel_push_relabel, no_arcs) {
+    static_digraph_builder<static_digraph, int> builder(2);
+    auto [graph, capacity] = builder.build();
+
+    parallel_push_relabel alg(graph, capacity, 0u, 1u);
+    ASSERT_EQ(alg.run().flow_value(), 0);
+    ASSERT_TRUE(EMPTY(alg.minimum_cut()));
+}
+
+// The source floods 10 units into vertex 1, of which only 3 reach the target:
+// the other 7 must be pushed back for the result to be a flow, not a preflow.
+GTEST_TEST(parallel_push_relabel, excess_returns_to_the_source) {
+    static_digraph_builder<static_digraph, int> builder(4);
+    builder.add_arc(0, 1, 10).add_arc(1, 2, 3).add_arc(1, 3, 5).add_arc(2, 3, 9);
+    auto [graph, capacity] = builder.build();
+
+    parallel_push_relabel alg(graph, capacity, 0u, 2u);
+    alg.set_num_threads(2);
+    ASSERT_EQ(alg.run().flow_value(), 3);
+    assert_is_flow(alg, graph, capacity, 0u, 2u);
+    ASSERT_TRUE(EQ_MULTISETS(alg.minimum_cut(), {1u}));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on instances large enough for the rounds to overlap, any number of threads
+// finds dinitz's flow value, and a valid flow carrying it
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_push_relabel, matches_dinitz_on_random_instances) {
+    for(std::size_t it = 0; it < 20; ++it) {
+        const std::size_t n = 50 + test_rng()() % 150;
+        const std::size_t m = n * (2 + test_rng()() % 6);
+        static_digraph_builder<static_digraph, int> builder(n);
+        for(std::size_t k = 0; k < m; ++k) {
+            builder.add_arc(
+                static_cast<vertex_t<static_digraph>>(test_rng()() % n),
+                static_cast<vertex_t<static_digraph>>(test_rng()() % n),
+                static_cast<int>(test_rng()() % 100));
+        }
+        auto [graph, capacity] = builder.build();
+        const vertex_t<static_digraph> s = 0;
+        const auto t = static_cast<vertex_t<static_digraph>>(n - 1);
+
+        dinitz reference(graph, capacity, s, t);
+        reference.run();
+
+        for(std::size_t num_threads : {1u, 3u, 8u}) {
+            parallel_push_relabel alg(graph, capacity, s, t);
+            alg.set_num_threads(num_threads);
+            ASSERT_EQ(alg.run().flow_value(), reference.flow_value())
+                << num_threads << " threads";
+            assert_is_flow(alg, graph, capacity, s, t);
+
+            int cut_capacity = 0;
+            for(auto && a : alg.minimum_cut()) cut_capacity += capacity[a];
+            ASSERT_EQ(cut_capacity, reference.flow_value());
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// run() is idempotent, and a terminal change invalidates the result
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_push_relabel, rerun_and_change_terminals) {
+    static_digraph_builder<static_digraph, int> builder(3);
+    builder.add_arc(0, 1, 5).add_arc(1, 2, 3);
+    auto [graph, capacity] = builder.build();
+
+    parallel_push_relabel alg(graph, capacity);
+    EXPECT_DEATH((void)alg.run(), "");
+
+    alg.set_source(0u).set_target(2u);
+    EXPECT_DEATH((void)alg.minimum_cut(), "");
+    ASSERT_EQ(alg.run().flow_value(), 3);
+    ASSERT_EQ(alg.run().flow_value(), 3);
+
+    alg.set_target(1u);
+    EXPECT_DEATH((void)alg.minimum_cut(), "");
+    ASSERT_EQ(alg.run().flow_value(), 5);
+    ASSERT_TRUE(EQ_MULTISETS(alg.minimum_cut(), {0u}));
+}
@@ -0,0 +1,182 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "melon/algorithm/parallel_strongly_connected_components.hpp"
+#include "melon/algorithm/strongly_connected_components.hpp"
+#include "melon/container/mutable_digraph.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+namespace {
+
+// The labels and sizes Tarjan's components imply once renumbered in the order
+// of their first vertex in `order`.
+template <typename Graph, typename Vertex>
+std::pair<std::vector<std::size_t>, std::vector<std::size_t>>
+reference_components(const Graph & graph, const std::vector<Vertex> & order,
+                     const std::size_t max_vertex) {
+    constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> tarjan_id(max_vertex, none);
+    std::size_t num_components = 0;
+    for(auto && component : strongly_connected_components(graph)) {
+        for(auto && v : component) tarjan_id[v] = num_components;
+        ++num_components;
+    }
+    std::vector<std::size_t> renumbered(num_components, none);
+    std::vector<std::size_t> label(max_vertex, none);
+    std::vector<std::size_t> sizes;
+    for(auto && v : order) {
+        std::size_t & l = renumbered[tarjan_id[v]];
+        if(l == none) {
+            l = sizes.size();
+            sizes.push_back(0);
+        }
+        label[v] = l;
+        ++sizes[l];
+    }
+    return {label, sizes};
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// the components of the serial algorithm's first example
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_strongly_connected_components, test) {
+    static_digraph_builder<static_digraph> builder(8);
+    builder.add_arc(0, 1)
+        .add_arc(0, 2)
+        .add_arc(0, 5)
+        .add_arc(1, 0)
+        .add_arc(1, 2)
+        .add_arc(1, 3)
+        .add_arc(2, 0)
+        .add_arc(2, 1)
+        .add_arc(2, 3)
+        .add_arc(2, 5)
+        .add_arc(3, 1)
+        .add_arc(3, 2)
+        .add_arc(3, 4)
+        .add_arc(4, 3)
+        .add_arc(4, 5)
+        .add_arc(5, 0)
+        .add_arc(5, 2)
+        .add_arc(5, 4)
+        .add_arc(7, 5);
+    auto [graph] = builder.build();
+
+    parallel_strongly_connected_components alg(graph);
+    alg.run();
+    ASSERT_EQ(alg.num_components(), 3u);
+    ASSERT_TRUE(EQ_RANGES(alg.component_sizes(), {6u, 1u, 1u}));
+    for(auto && v : {0u, 1u, 2u, 3u, 4u, 5u}) ASSERT_EQ(alg.component(v), 0u);
+    ASSERT_EQ(alg.component(6u), 1u);
+    ASSERT_EQ(alg.components_map()[7u], 2u);
+
+    // run() is idempotent, reset() recomputes the same labelling
+    ASSERT_EQ(alg.run().num_components(), 3u);
+    ASSERT_EQ(alg.reset().run().component(7u), 2u);
+    auto components = std::move(alg).components_map();
+    ASSERT_EQ(components[6u], 1u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// no vertices, no arcs, and self-loops, which trimming must see through
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_strongly_connected_components, degenerate_graphs) {
+    {
+        static_digraph_builder<static_digraph> builder(0);
+        auto [graph] = builder.build();
+        parallel_strongly_connected_components alg(graph);
+        ASSERT_EQ(alg.run().num_components(), 0u);
+    }
+    {
+        static_digraph_builder<static_digraph> builder(4);
+        builder.add_arc(0, 0).add_arc(1, 1).add_arc(1, 2).add_arc(2, 1);
+        auto [graph] = builder.build();
+        parallel_strongly_connected_components alg(graph);
+        ASSERT_EQ(alg.run().num_components(), 3u);
+        ASSERT_TRUE(EQ_RANGES(alg.component_sizes(), {1u, 2u, 1u}));
+        ASSERT_EQ(alg.component(2u), 1u);
+        ASSERT_EQ(alg.component(3u), 2u);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random digraphs, from DAG-like to a giant component among many small
+// ones, Tarjan's components, renumbered, for every thread count
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_strongly_connected_components, matches_tarjan) {
+    for(std::size_t it = 0; it < 40; ++it) {
+        const std::size_t n = 1 + test_rng()() % (it < 20 ? 40 : 20000);
+        const std::size_t m = test_rng()() % (3 * n);
+        static_digraph_builder<static_digraph> builder(n);
+        for(std::size_t k = 0; k < m; ++k)
+            builder.add_arc(static_cast<unsigned>(test_rng()() % n),
+                            static_cast<unsigned>(test_rng()() % n));
+        // and, often, a long cycle through some of the vertices
+        if(it % 2 == 0) {
+            const auto cycle = random_vector<unsigned>(
+                1 + n / 8, 0, static_cast<unsigned>(n - 1));
+            for(std::size_t k = 0; k < cycle.size(); ++k)
+                builder.add_arc(cycle[k], cycle[(k + 1) % cycle.size()]);
+        }
+        auto [graph] = builder.build();
+        std::vector<vertex_t<static_digraph>> order(vertices(graph).begin(),
+                                                    vertices(graph).end());
+        const auto [label, sizes] = reference_components(graph, order, n);
+
+        for(std::size_t num_threads : {1u, 2u, 8u}) {
+            parallel_strongly_connected_components alg(graph);
+            alg.set_num_threads(num_threads).run();
+            ASSERT_EQ(alg.num_threads(), num_threads);
+            ASSERT_TRUE(EQ_RANGES(alg.component_sizes(), sizes));
+            for(auto && v : vertices(graph))
+                ASSERT_EQ(alg.component(v), label[v]) << "vertex " << v;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// vertices that are not positions: a mutable_digraph with removed vertices,
+// labelled in the order of its vertices() range
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_strongly_connected_components, sparse_vertex_ids) {
+    for(std::size_t it = 0; it < 10; ++it) {
+        mutable_digraph graph;
+        const std::size_t n = 2 + test_rng()() % 2000;
+        std::vector<vertex_t<mutable_digraph>> created;
+        for(std::size_t i = 0; i < n; ++i)
+            created.push_back(graph.create_vertex());
+        for(std::size_t k = 0; k < 2 * n; ++k)
+            (void)graph.create_arc(random_element(created),
+                                   random_element(created));
+        for(std::size_t k = 0; k < n / 4; ++k) {
+            const auto v = random_element(created);
+            if(graph.is_valid_vertex(v)) graph.remove_vertex(v);
+        }
+        std::vector<vertex_t<mutable_digraph>> order;
+        for(auto && v : vertices(graph)) order.push_back(v);
+        const auto [label, sizes] = reference_components(graph, order, n);
+
+        parallel_strongly_connected_components alg(graph);
+        alg.set_num_threads(4).run();
+        ASSERT_TRUE(EQ_RANGES(alg.component_sizes(), sizes));
+        for(auto && v : order)
+            ASSERT_EQ(alg.component(v), label[v]) << "vertex " << v;
+    }
+}
@@ -0,0 +1,186 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+#include "melon/algorithm/parallel_topological_sort.hpp"
+#include "melon/algorithm/topological_sort.hpp"
+#include "melon/container/mutable_digraph.hpp"
+#include "melon/container/static_digraph.hpp"
+#include "melon/utility/static_digraph_builder.hpp"
+
+#include "random_ranges_helper.hpp"
+#include "ranges_test_helper.hpp"
+
+using namespace melon;
+
+////////////////////////////////////////////////////////////////////////////////
+// the levels of the serial sort's example, one span per advance()
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_topological_sort, test) {
+    static_digraph_builder<static_digraph> builder(6);
+    builder.add_arc(5, 2)
+        .add_arc(5, 0)
+        .add_arc(4, 0)
+        .add_arc(4, 1)
+        .add_arc(2, 3)
+        .add_arc(3, 1);
+    auto [graph] = builder.build();
+
+    parallel_topological_sort alg(graph);
+    static_assert(std::movable<decltype(alg)> && !std::copyable<decltype(alg)>);
+    static_assert(std::ranges::input_range<decltype(alg)>);
+
+    ASSERT_FALSE(alg.finished());
+    ASSERT_TRUE(EQ_RANGES(alg.current(), {4u, 5u}));
+    alg.advance();
+    ASSERT_TRUE(EQ_RANGES(alg.current(), {0u, 2u}));
+    alg.advance();
+    ASSERT_TRUE(EQ_RANGES(alg.current(), {3u}));
+    alg.advance();
+    ASSERT_TRUE(EQ_RANGES(alg.current(), {1u}));
+    ASSERT_EQ(alg.num_levels(), 4u);
+    alg.advance();
+    ASSERT_TRUE(alg.finished());
+    ASSERT_TRUE(alg.is_acyclic());
+    ASSERT_EQ(alg.num_levels(), 4u);
+    ASSERT_TRUE(EQ_RANGES(alg.order(), {4u, 5u, 0u, 2u, 3u, 1u}));
+    const auto levels = alg.levels_map();
+    ASSERT_TRUE(EQ_RANGES(
+        std::views::transform(vertices(graph), [&](auto v) { return levels[v]; }),
+        {1u, 3u, 1u, 2u, 0u, 0u}));
+
+    std::size_t num_levels = 0;
+    for(auto && level : alg.reset()) {
+        for(auto && v : level) ASSERT_EQ(alg.level(v), num_levels);
+        ++num_levels;
+    }
+    ASSERT_EQ(num_levels, 4u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// no vertex, and cycles: what is on or behind one is never reached
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_topological_sort, degenerate_graphs) {
+    {
+        static_digraph_builder<static_digraph> builder(0);
+        auto [graph] = builder.build();
+        parallel_topological_sort alg(graph);
+        ASSERT_TRUE(alg.finished());
+        ASSERT_TRUE(alg.is_acyclic());
+        ASSERT_EQ(alg.num_levels(), 0u);
+    }
+    {
+        static_digraph_builder<static_digraph> builder(5);
+        builder.add_arc(0, 1)
+            .add_arc(1, 2)
+            .add_arc(2, 1)
+            .add_arc(2, 3)
+            .add_arc(4, 4);
+        auto [graph] = builder.build();
+        parallel_topological_sort alg(graph);
+        alg.run();
+        ASSERT_FALSE(alg.is_acyclic());
+        ASSERT_TRUE(EQ_RANGES(alg.order(), {0u}));
+        ASSERT_TRUE(alg.reached(0u));
+        for(auto && v : {1u, 2u, 3u, 4u}) ASSERT_FALSE(alg.reached(v));
+        ASSERT_EQ(alg.levels_map()[3u], std::numeric_limits<std::size_t>::max());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// on random DAGs, wide enough for the levels to be shared, the level of every
+// vertex is topological_sort's rank, for every thread count
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+struct rank_traits : topological_sort_default_traits {
+    static constexpr bool store_ranks = true;
+};
+}  // namespace
+
+GTEST_TEST(parallel_topological_sort, matches_ranks) {
+    for(std::size_t it = 0; it < 30; ++it) {
+        const std::size_t n = 1 + test_rng()() % (it < 15 ? 40 : 20000);
+        const std::size_t m = test_rng()() % (4 * n);
+        // arcs go forward in a random order of the vertices
+        std::vector<unsigned> rank_of(n);
+        std::iota(rank_of.begin(), rank_of.end(), 0u);
+        std::ranges::shuffle(rank_of, test_rng());
+        static_digraph_builder<static_digraph> builder(n);
+        for(std::size_t k = 0; k < m; ++k) {
+            auto u = static_cast<unsigned>(test_rng()() % n);
+            auto v = static_cast<unsigned>(test_rng()() % n);
+            if(u == v) continue;
+            if(rank_of[u] > rank_of[v]) std::swap(u, v);
+            builder.add_arc(u, v);
+        }
+        auto [graph] = builder.build();
+        topological_sort<graph_ref_view<static_digraph>, rank_traits> serial(
+            graph);
+        serial.run();
+
+        for(std::size_t num_threads : {1u, 2u, 8u}) {
+            parallel_topological_sort alg(graph);
+            alg.set_num_threads(num_threads);
+            ASSERT_EQ(alg.num_threads(), num_threads);
+            std::vector<unsigned char> seen(n, false);
+            std::size_t level = 0;
+            for(auto && vertices_of_level : alg) {
+                for(auto && v : vertices_of_level) {
+                    ASSERT_FALSE(seen[v]);
+                    seen[v] = true;
+                    ASSERT_EQ(alg.level(v), level);
+                    ASSERT_EQ(alg.level(v),
+                              static_cast<std::size_t>(serial.rank(v)))
+                        << "vertex " << v;
+                }
+                ++level;
+            }
+            ASSERT_TRUE(alg.is_acyclic());
+            ASSERT_EQ(alg.order().size(), n);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// vertices that are not positions: a mutable_digraph with removed vertices
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(parallel_topological_sort, sparse_vertex_ids) {
+    for(std::size_t it = 0; it < 10; ++it) {
+        mutable_digraph graph;
+        const std::size_t n = 2 + test_rng()() % 5000;
+        std::vector<vertex_t<mutable_digraph>> created;
+        for(std::size_t i = 0; i < n; ++i)
+            created.push_back(graph.create_vertex());
+        for(std::size_t k = 0; k < 3 * n; ++k) {
+            auto u = random_element(created), v = random_element(created);
+            if(u == v) continue;
+            (void)graph.create_arc(std::min(u, v), std::max(u, v));
+        }
+        for(std::size_t k = 0; k < n / 4; ++k) {
+            const auto v = random_element(created);
+            if(graph.is_valid_vertex(v)) graph.remove_vertex(v);
+        }
+
+        parallel_topological_sort alg(graph);
+        alg.set_num_threads(4).run();
+        ASSERT_TRUE(alg.is_acyclic());
+        // a level is one more than the deepest in-neighbour's
+        auto expected = create_vertex_map<std::size_t>(graph, 0);
+        for(auto && a : arcs(graph)) {
+            const auto u = arc_source(graph, a), w = arc_target(graph, a);
+            ASSERT_LT(alg.level(u), alg.level(w));
+            expected[w] = std::max(expected[w], alg.level(u) + 1);
+        }
+        for(auto && v : vertices(graph)) ASSERT_EQ(alg.level(v), expected[v]);
+    }
+}
@@ -0,0 +1,80 @@
+#undef NDEBUG
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include "melon/utility/sum_tree_sampler.hpp"
+
+#include "random_ranges_helper.hpp"
+
+using namespace melon;
+
+////////////////////////////////////////////////////////////////////////////////
+// drawn samples follow the weights, normalized by their sum
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(sum_tree_sampler, statistics) {
+    std::vector<int> vec = {2, 4, 8, 16, 16};
+    sum_tree_sampler sampler(vec, [](const int & i) { return 8.0 / i; });
+    ASSERT_DOUBLE_EQ(sampler.total_weight(), 8.0);
+    ASSERT_DOUBLE_EQ(sampler.weight(1), 2.0);
+
+    std::vector<double> frequencies(vec.size(), 0.0);
+    std::mt19937 rng(180);
+    for(int i = 0; i < 10000; ++i) {
+        const int & item = sampler(rng);
+        frequencies[static_cast<std::size_t>(&item - vec.data())] += 1e-4;
+    }
+    ASSERT_NEAR(frequencies[0], 0.5, 0.05);
+    ASSERT_NEAR(frequencies[1], 0.25, 0.05);
+    ASSERT_NEAR(frequencies[2], 0.125, 0.05);
+    ASSERT_NEAR(frequencies[3], 0.0625, 0.05);
+    ASSERT_NEAR(frequencies[4], 0.0625, 0.05);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// set_weight changes the distribution in place: an item set to zero is never
+// drawn again, and one set from zero is
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(sum_tree_sampler, set_weight) {
+    std::vector<double> weights = {1.0, 0.0, 3.0};
+    sum_tree_sampler sampler(std::views::iota(0ul, weights.size()),
+                             [&](std::size_t i) { return weights[i]; });
+    sampler.set_weight(0, 0.0).set_weight(1, 5.0);
+    ASSERT_DOUBLE_EQ(sampler.total_weight(), 8.0);
+    ASSERT_DOUBLE_EQ(sampler.weight(0), 0.0);
+
+    std::vector<double> frequencies(weights.size(), 0.0);
+    std::mt19937 rng(180);
+    for(int i = 0; i < 10000; ++i) frequencies[sampler(rng)] += 1e-4;
+    ASSERT_EQ(frequencies[0], 0.0);
+    ASSERT_NEAR(frequencies[1], 0.625, 0.05);
+    ASSERT_NEAR(frequencies[2], 0.375, 0.05);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// the sums are recomputed, not shifted: after many updates the tree is the one
+// built from the final weights, and weights left at zero are never drawn
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(sum_tree_sampler, updates_do_not_drift) {
+    const std::size_t n = 1000;
+    std::vector<double> weights(n, 1.0);
+    auto ids = std::views::iota(0ul, n);
+    auto prob_map = [&](std::size_t i) { return weights[i]; };
+    sum_tree_sampler sampler(ids, prob_map);
+    std::exponential_distribution<double> dist(1e-3);
+    for(int k = 0; k < 100000; ++k) {
+        const std::size_t i = test_rng()() % n;
+        weights[i] = i % 3 == 0 ? 0.0 : dist(test_rng());
+        sampler.set_weight(i, weights[i]);
+    }
+    ASSERT_EQ(sampler.total_weight(),
+              sum_tree_sampler(ids, prob_map).total_weight());
+    for(int k = 0; k < 10000; ++k)
+        ASSERT_NE(sampler(test_rng()) % 3, 0ul);
+}
@@ -1,8 +1,13 @@
 #undef NDEBUG
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 #include "melon/algorithm/unbounded_knapsack_bnb.hpp"
 
+#include "random_ranges_helper.hpp"
 #include "ranges_test_helper.hpp"
 
 using namespace melon;
@@ -66,3 +71,41 @@ GTEST_TEST(unbounded_knapsack_bnb, set_budget_rederives_the_item_filter) {
     ASSERT_EQ(alg.run().solution_value(), 8);
     ASSERT_TRUE(EQ_MULTISETS(alg.solution_items(), {std::pair{1u, 2}}));
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// the parallel search answers the serial solution, counts included, as for
+// knapsack_bnb
+////////////////////////////////////////////////////////////////////////////////
+
+GTEST_TEST(unbounded_knapsack_bnb, parallel_matches_serial) {
+    for(int it = 0; it < 200; ++it) {
+        const std::size_t n = test_rng()() % 30;
+        const unsigned max_value = it % 2 == 0 ? 8u : 1000u;
+        std::vector<std::size_t> items(n);
+        std::vector<int> values(n);
+        std::vector<int> costs(n);
+        for(std::size_t i = 0; i < n; ++i) {
+            items[i] = i;
+            values[i] = 1 + static_cast<int>(test_rng()() % max_value);
+            costs[i] = 1 + static_cast<int>(test_rng()() % max_value);
+        }
+        const int budget = static_cast<int>(test_rng()() % 4000);
+
+        auto serial = unbounded_knapsack_bnb(items, values, costs, budget);
+        serial.run();
+        const std::vector<std::pair<std::size_t, std::size_t>> serial_items(
+            serial.solution_items().begin(), serial.solution_items().end());
+        for(const std::size_t num_threads : {2u, 3u, 4u}) {
+            auto parallel =
+                unbounded_knapsack_bnb(items, values, costs, budget);
+            parallel.set_num_threads(num_threads).run();
+            ASSERT_EQ(parallel.num_threads(), num_threads);
+            ASSERT_EQ(parallel.solution_value(), serial.solution_value());
+            ASSERT_EQ(parallel.solution_cost(), serial.solution_cost());
+            const std::vector<std::pair<std::size_t, std::size_t>>
+                parallel_items(parallel.solution_items().begin(),
+                               parallel.solution_items().end());
+            ASSERT_EQ(parallel_items, serial_items);
+        }
+    }
+}